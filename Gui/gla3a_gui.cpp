@@ -1,12 +1,15 @@
 #include <lv2/ui/ui.h>
 #include <lv2/atom/atom.h>
 #include <lv2/atom/util.h>
+#include <lv2/atom/forge.h>
+#include <lv2/patch/patch.h>
 #include <lv2/urid/urid.h>
 #include <lv2/core/lv2.h>
 #include <lv2/log/log.h>
 #include <lv2/log/logger.h>
 
 // --- DIPENDENZE IMGUI ---
+#include "../gla3a.h" // Indici delle porte e URI dei parametri
 #include "imgui.h"
 #include "backends/imgui_impl_opengl3.h"
 #include <cmath>     // Per funzioni matematiche
@@ -23,7 +26,7 @@
 #include <GL/gl.h>
 #include <GL/glx.h>
 #include <X11/Xlib.h>
-#include <X11/Xutil.h>   // Per XGetWindowAttributes
+#include <X11/Xutil.h>   // Per XGetWindowAttributes (solo in instantiate)
 #include <X11/keysym.h>  // Per la gestione della tastiera
 
 // --- URID e LOGGING (definizione esterna, come nel tuo codice LV2) ---
@@ -37,12 +40,9 @@ LV2_URID_Unmap urid_unmap;
 // URI per i parametri del tuo compressore Gla3a (modificati per LA-3A)
 static LV2_URID peakReduction_URID; // Gain Reduction (Peak Reduction)
 static LV2_URID gain_URID;          // Gain (Output Gain)
-static LV2_URID hfComp_URID;        // High Frequency Compression (tipico LA-3A)
 static LV2_URID bypass_URID;
 static LV2_URID ratioMode_URID;     // Per 1:1 o Compress/Limit (se applicabile, o rimuovere se fisso)
-static LV2_URID inputPad10dB_URID;  // Per l'Input Pad (se presente)
 static LV2_URID oversamplingOn_URID;
-static LV2_URID sidechainMode_URID; // External Sidechain
 static LV2_URID scLpOn_URID;
 static LV2_URID scLpFq_URID;
 static LV2_URID scLpQ_URID;
@@ -50,13 +50,13 @@ static LV2_URID scHpOn_URID;
 static LV2_URID scHpFq_URID;
 static LV2_URID scHpQ_URID;
 
-// URI per i valori dei meter (che il plugin audio invierà alla GUI)
-static LV2_URID peakGR_URID;       // Gain Reduction Meter
-static LV2_URID peakInL_URID;      // Input Peak Left
-static LV2_URID peakInR_URID;      // Input Peak Right
-static LV2_URID peakOutL_URID;     // Output Peak Left
-static LV2_URID peakOutR_URID;     // Output Peak Right
 
+// --- Ritmo dei Frame ---
+// port_event() e gli eventi X aggiornano lo stato e segnano la UI da ridisegnare; ui_idle() disegna
+// al massimo un frame per chiamata, e non più di UI_MAX_FPS al secondo. Dopo un input ImGui vuole
+// ancora UI_INPUT_FRAMES frame per consumare la coda degli eventi e aggiornare hover e animazioni.
+#define UI_MAX_FPS 60.0
+#define UI_INPUT_FRAMES 2
 
 // =========================================================================
 // Funzioni Helper per ImGui
@@ -177,21 +177,41 @@ typedef struct {
     LV2_URID_Map* map;
     LV2_URID_Unmap* unmap;
 
+    // I parametri vanno al plugin come patch:Set sulla porta GLA3A_CONTROL
+    LV2_Atom_Forge forge;
+    LV2_URID atom_eventTransfer;
+    LV2_URID patch_Set;
+    LV2_URID patch_property;
+    LV2_URID patch_value;
+
+    // I meter arrivano dal plugin come frame sulla porta GLA3A_NOTIFY (GLA3A_METER_FRAME_URI)
+    LV2_URID atom_Object;
+    LV2_URID atom_Vector;
+    LV2_URID atom_Float;
+    LV2_URID meter_frame;
+    LV2_URID meter_values;
+
     Display* display;
     Window window;
     GLXContext glx_context;
 
+    // Geometria della finestra: da instantiate, poi dai ConfigureNotify (niente round trip al server)
+    int window_width;
+    int window_height;
+
+    // Ritmo dei frame (vedi UI_MAX_FPS)
+    bool dirty;              // Stato cambiato dall'ultimo frame disegnato
+    int input_frames;        // Frame ancora da disegnare dopo l'ultimo input
+    double last_frame_time;  // get_time_in_seconds() dell'ultimo frame
+
     bool imgui_initialized;
 
     // --- Valori dei Parametri (sincronizzati con il plugin audio) ---
     float peakReduction_val;
     float gain_val;
-    float hfComp_val; // High Frequency Compression
     bool bypass_val;
     bool ratioMode_val; // false=Comp, true=Limit (se il tuo LA-3A ha questo toggle)
-    bool inputPad10dB_val;
     bool oversamplingOn_val;
-    bool sidechainMode_val; // External Sidechain
     bool scLpOn_val;
     float scLpFq_val;
     float scLpQ_val;
@@ -199,7 +219,7 @@ typedef struct {
     float scHpFq_val;
     float scHpQ_val;
 
-    // --- Valori dei Meter (ricevuti dal plugin, normalizzati 0.0-1.0) ---
+    // --- Valori dei Meter (dai frame del plugin, in dB; GR negativa) ---
     float peakGR_val;
     float peakInL_val;
     float peakInR_val;
@@ -211,7 +231,6 @@ typedef struct {
     // --- Texture IDs per i Knob ---
     GLuint knobTextureID_peakReduction;
     GLuint knobTextureID_gain;
-    GLuint knobTextureID_hfComp; // Knob per HF Comp
     GLuint knobTextureID_scLpFq;
     GLuint knobTextureID_scLpQ;
     GLuint knobTextureID_scHpFq;
@@ -236,6 +255,24 @@ typedef struct {
 // Callbacks LV2 (instantiate, cleanup, port_event, ui_idle)
 // =========================================================================
 
+// Invia un parametro al plugin come patch:Set (valore nelle unità della porta di controllo).
+// L'host lo consegna sulla porta GLA3A_CONTROL con un timestamp: il plugin lo applica a
+// campione preciso, senza aspettare la lettura delle porte al blocco successivo.
+static void send_parameter(Gla3aUI* ui, LV2_URID property, float value) {
+    uint8_t buffer[128];
+    lv2_atom_forge_set_buffer(&ui->forge, buffer, sizeof(buffer));
+
+    LV2_Atom_Forge_Frame frame;
+    LV2_Atom* msg = (LV2_Atom*)lv2_atom_forge_object(&ui->forge, &frame, 0, ui->patch_Set);
+    lv2_atom_forge_key(&ui->forge, ui->patch_property);
+    lv2_atom_forge_urid(&ui->forge, property);
+    lv2_atom_forge_key(&ui->forge, ui->patch_value);
+    lv2_atom_forge_float(&ui->forge, value);
+    lv2_atom_forge_pop(&ui->forge, &frame);
+
+    ui->write_function(ui->controller, GLA3A_CONTROL, lv2_atom_total_size(msg), ui->atom_eventTransfer, msg);
+}
+
 static LV2_UI_Handle instantiate(const LV2_UI_Descriptor* descriptor,
                                  const char* plugin_uri,
                                  const char* bundle_path,
@@ -250,14 +287,11 @@ static LV2_UI_Handle instantiate(const LV2_UI_Descriptor* descriptor,
     ui->showOutputMeter = true;
 
     // Inizializza i valori predefiniti dei parametri (devono corrispondere a quelli del plugin)
-    ui->peakReduction_val = -20.0f;
+    ui->peakReduction_val = GLA3A_PEAK_REDUCTION_MIN_DB; // Porta a 0 (lv2:default)
     ui->gain_val = 0.0f;
-    ui->hfComp_val = 0.0f; // Valore iniziale per HF Comp
     ui->bypass_val = false;
     ui->ratioMode_val = false; // Compressione (se hai questo toggle nel tuo LA-3A)
-    ui->inputPad10dB_val = false;
     ui->oversamplingOn_val = true;
-    ui->sidechainMode_val = false;
     ui->scLpOn_val = false;
     ui->scLpFq_val = 2000.0f;
     ui->scLpQ_val = 0.707f;
@@ -297,33 +331,37 @@ static LV2_UI_Handle instantiate(const LV2_UI_Descriptor* descriptor,
         return NULL;
     }
 
-    // Mappa gli URI dei parametri (DEVONO CORRISPONDERE agli URI nel tuo plugin TTL e codice audio)
-    // Sostituisci "http://your-plugin.com/gla3a#" con l'URI effettivo del tuo plugin
-    peakReduction_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#peakReduction");
-    gain_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#gain");
-    hfComp_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#hfComp"); // Nuovo parametro HF Comp
-    bypass_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#bypass");
-    ratioMode_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#ratioMode");
-    inputPad10dB_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#inputPad10dB");
-    oversamplingOn_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#oversamplingOn");
-    sidechainMode_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#sidechainMode");
-    scLpOn_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#scLpOn");
-    scLpFq_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#scLpFq");
-    scLpQ_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#scLpQ");
-    scHpOn_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#scHpOn");
-    scHpFq_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#scHpFq");
-    scHpQ_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#scHpQ");
-
-    peakGR_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#peakGR");
-    peakInL_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#peakInL");
-    peakInR_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#peakInR");
-    peakOutL_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#peakOutL");
-    peakOutR_URID = ui->map->map(ui->map->handle, "http://your-plugin.com/gla3a#peakOutR");
+    // Mappa gli URI dei parametri: gli stessi di gla3a_parameters[] (gla3a.h) e del TTL.
+    peakReduction_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "peakReduction");
+    gain_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "gain");
+    bypass_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "bypass");
+    ratioMode_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "ratioMode");
+    oversamplingOn_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "oversampling");
+    scLpOn_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "scLpOn");
+    scLpFq_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "scLpFq");
+    scLpQ_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "scLpQ");
+    scHpOn_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "scHpOn");
+    scHpFq_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "scHpFq");
+    scHpQ_URID = ui->map->map(ui->map->handle, GLA3A_PARAM_PREFIX "scHpQ");
+
+    lv2_atom_forge_init(&ui->forge, ui->map);
+    ui->atom_eventTransfer = ui->map->map(ui->map->handle, LV2_ATOM__eventTransfer);
+    ui->patch_Set = ui->map->map(ui->map->handle, LV2_PATCH__Set);
+    ui->patch_property = ui->map->map(ui->map->handle, LV2_PATCH__property);
+    ui->patch_value = ui->map->map(ui->map->handle, LV2_PATCH__value);
+
+    ui->atom_Object = ui->map->map(ui->map->handle, LV2_ATOM__Object);
+    ui->atom_Vector = ui->map->map(ui->map->handle, LV2_ATOM__Vector);
+    ui->atom_Float = ui->map->map(ui->map->handle, LV2_ATOM__Float);
+    ui->meter_frame = ui->map->map(ui->map->handle, GLA3A_METER_FRAME_URI);
+    ui->meter_values = ui->map->map(ui->map->handle, GLA3A_METER_VALUES_URI);
 
 
     // --- Inizializzazione OpenGL ---
     XWindowAttributes wa;
     XGetWindowAttributes(ui->display, ui->window, &wa);
+    ui->window_width = wa.width;
+    ui->window_height = wa.height;
 
     GLint att[] = { GLX_RGBA, GLX_DEPTH_SIZE, 24, GLX_DOUBLEBUFFER, None };
     XVisualInfo* vi = glXChooseVisual(ui->display, 0, att);
@@ -363,7 +401,6 @@ static LV2_UI_Handle instantiate(const LV2_UI_Descriptor* descriptor,
 
     // Carica gli altri knob, usando la stessa dimensione dei frame (assunzione)
     ui->knobTextureID_gain       = LoadTextureFromFile((assets_path + "knob_gain_la3a.png").c_str(), &ui->knobFrameWidth, &ui->knobFrameHeight);
-    ui->knobTextureID_hfComp     = LoadTextureFromFile((assets_path + "knob_hfcomp_la3a.png").c_str(), &ui->knobFrameWidth, &ui->knobFrameHeight);
     ui->knobTextureID_scLpFq     = LoadTextureFromFile((assets_path + "knob_sc_fq_la3a.png").c_str(), &ui->knobFrameWidth, &ui->knobFrameHeight);
     ui->knobTextureID_scLpQ      = LoadTextureFromFile((assets_path + "knob_sc_q_la3a.png").c_str(), &ui->knobFrameWidth, &ui->knobFrameHeight);
     ui->knobTextureID_scHpFq     = LoadTextureFromFile((assets_path + "knob_sc_fq_la3a.png").c_str(), &ui->knobFrameWidth, &ui->knobFrameHeight);
@@ -384,6 +421,7 @@ static LV2_UI_Handle instantiate(const LV2_UI_Descriptor* descriptor,
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO(); (void)io;
+    io.DisplaySize = ImVec2((float)ui->window_width, (float)ui->window_height);
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
     io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
@@ -447,6 +485,8 @@ static LV2_UI_Handle instantiate(const LV2_UI_Descriptor* descriptor,
     ImGui_ImplOpenGL3_Init("#version 130");
 
     ui->imgui_initialized = true;
+    ui->dirty = true; // Il primo frame alla prima ui_idle()
+    ui->last_frame_time = get_time_in_seconds();
 
     *widget = (LV2_UI_Widget_Handle)ui->window;
     return (LV2_UI_Handle)ui;
@@ -463,7 +503,6 @@ static void cleanup(LV2_UI_Handle ui_handle) {
     // Libera le texture OpenGL
     if (ui->knobTextureID_peakReduction) glDeleteTextures(1, &ui->knobTextureID_peakReduction);
     if (ui->knobTextureID_gain) glDeleteTextures(1, &ui->knobTextureID_gain);
-    if (ui->knobTextureID_hfComp) glDeleteTextures(1, &ui->knobTextureID_hfComp);
     if (ui->knobTextureID_scLpFq) glDeleteTextures(1, &ui->knobTextureID_scLpFq);
     if (ui->knobTextureID_scLpQ) glDeleteTextures(1, &ui->knobTextureID_scLpQ);
     if (ui->knobTextureID_scHpFq) glDeleteTextures(1, &ui->knobTextureID_scHpFq);
@@ -532,26 +571,24 @@ static int handle_xevent(Gla3aUI* ui, XEvent* event) {
             break;
         }
         case ConfigureNotify:
-            io.DisplaySize = ImVec2((float)event->xconfigure.width, (float)event->xconfigure.height);
-            break;
+            ui->window_width = event->xconfigure.width;
+            ui->window_height = event->xconfigure.height;
+            io.DisplaySize = ImVec2((float)ui->window_width, (float)ui->window_height);
+            ui->dirty = true;
+            return 1;
+        case Expose:
+            ui->dirty = true;
+            return 1;
         default:
             return 0;
     }
+    ui->input_frames = UI_INPUT_FRAMES;
+    ui->dirty = true;
     return 1;
 }
 
-static void draw_ui(Gla3aUI* ui) {
-    if (!ui->imgui_initialized) return;
-
-    glXMakeCurrent(ui->display, ui->window, ui->glx_context);
-
-    ImGuiIO& io = ImGui::GetIO();
-
-    static double g_Time = 0.0;
-    double current_time = get_time_in_seconds();
-    io.DeltaTime = (float)(current_time - g_Time);
-    g_Time = current_time;
-
+// Svuota la coda degli eventi X della finestra
+static void process_xevents(Gla3aUI* ui) {
     XEvent event;
     while (XPending(ui->display)) {
         XNextEvent(ui->display, &event);
@@ -559,14 +596,25 @@ static void draw_ui(Gla3aUI* ui) {
             handle_xevent(ui, &event);
         }
     }
+}
+
+// Un frame completo all'istante 'now' (get_time_in_seconds()); lo chiama solo ui_idle()
+static void draw_ui(Gla3aUI* ui, double now) {
+    if (!ui->imgui_initialized) return;
+
+    glXMakeCurrent(ui->display, ui->window, ui->glx_context);
+
+    ImGuiIO& io = ImGui::GetIO();
+
+    // Il tempo dall'ultimo frame di questa UI (le animazioni di ImGui seguono il ritmo vero)
+    io.DeltaTime = (float)fmax(now - ui->last_frame_time, 1e-4);
+    ui->last_frame_time = now;
 
     ImGui_ImplOpenGL3_NewFrame();
     ImGui::NewFrame();
 
-    XWindowAttributes wa;
-    XGetWindowAttributes(ui->display, ui->window, &wa);
-    float window_width = (float)wa.width;
-    float window_height = (float)wa.height;
+    float window_width = (float)ui->window_width;
+    float window_height = (float)ui->window_height;
 
     ImGui::SetNextWindowPos(ImVec2(0, 0));
     ImGui::SetNextWindowSize(ImVec2(window_width, window_height));
@@ -590,37 +638,28 @@ static void draw_ui(Gla3aUI* ui) {
 
             // Knob per Peak Reduction
             ImGui::PushID("PeakReduction");
-            if (KnobRotaryImage("Peak Reduction", &ui->peakReduction_val, -60.0f, -10.0f,
+            if (KnobRotaryImage("Peak Reduction", &ui->peakReduction_val, GLA3A_PEAK_REDUCTION_MIN_DB, GLA3A_PEAK_REDUCTION_MAX_DB,
                                 ui->knobTextureID_peakReduction, ui->knobFrameWidth, ui->knobFrameWidth,
                                 ui->knobTotalFrames, knob_img_size, "%.1f dB")) {
-                ui->write_function(ui->controller, peakReduction_URID, sizeof(float), 0, &ui->peakReduction_val);
+                // Knob in dB di soglia, porta 0..1 su GLA3A_PEAK_REDUCTION_MIN_DB..MAX_DB
+                send_parameter(ui, peakReduction_URID, (ui->peakReduction_val - GLA3A_PEAK_REDUCTION_MIN_DB) /
+                                                       (GLA3A_PEAK_REDUCTION_MAX_DB - GLA3A_PEAK_REDUCTION_MIN_DB));
             }
             ImGui::PopID();
             ImGui::SameLine(0, 20);
 
             // Knob per Gain Out
             ImGui::PushID("Gain");
-            if (KnobRotaryImage("Gain Out", &ui->gain_val, 0.0f, 12.0f,
+            if (KnobRotaryImage("Gain Out", &ui->gain_val, 0.0f, GLA3A_GAIN_MAX_DB,
                                 ui->knobTextureID_gain, ui->knobFrameWidth, ui->knobFrameWidth,
                                 ui->knobTotalFrames, knob_img_size, "%.1f dB")) {
-                ui->write_function(ui->controller, gain_URID, sizeof(float), 0, &ui->gain_val);
+                // Knob in dB, porta 0..1 su 0..GLA3A_GAIN_MAX_DB
+                send_parameter(ui, gain_URID, ui->gain_val / GLA3A_GAIN_MAX_DB);
             }
             ImGui::PopID();
 
             ImGui::Dummy(ImVec2(0, 20));
 
-            // Toggle Button (Levette) per Input Pad
-            ImGui::Text("Input Pad -10dB");
-            ImGui::SameLine();
-            ImGui::PushID("InputPad");
-            ImTextureID toggle_tex_id_input_pad = ui->inputPad10dB_val ? (ImTextureID)(intptr_t)ui->toggleSwitchTextureID_on : (ImTextureID)(intptr_t)ui->toggleSwitchTextureID_off;
-            if (ImGui::ImageButton("##InputPadBtn", toggle_tex_id_input_pad, ImVec2((float)ui->toggleSwitchWidth, (float)ui->toggleSwitchHeight))) {
-                ui->inputPad10dB_val = !ui->inputPad10dB_val;
-                float val = ui->inputPad10dB_val ? 1.0f : 0.0f;
-                ui->write_function(ui->controller, inputPad10dB_URID, sizeof(float), 0, &val);
-            }
-            ImGui::PopID();
-
             // Toggle Button per Ratio Mode (Comp/Limit, se presente nell'LA-3A)
             ImGui::Text("Ratio Mode");
             ImGui::SameLine();
@@ -628,25 +667,13 @@ static void draw_ui(Gla3aUI* ui) {
             ImTextureID toggle_tex_id_ratio_mode = ui->ratioMode_val ? (ImTextureID)(intptr_t)ui->toggleSwitchTextureID_on : (ImTextureID)(intptr_t)ui->toggleSwitchTextureID_off;
             if (ImGui::ImageButton("##RatioModeBtn", toggle_tex_id_ratio_mode, ImVec2((float)ui->toggleSwitchWidth, (float)ui->toggleSwitchHeight))) {
                 ui->ratioMode_val = !ui->ratioMode_val;
-                float val = ui->ratioMode_val ? 1.0f : 0.0f;
-                ui->write_function(ui->controller, ratioMode_URID, sizeof(float), 0, &val);
+                send_parameter(ui, ratioMode_URID, ui->ratioMode_val ? (float)GLA3A_RATIO_LIMIT : (float)GLA3A_RATIO_3_TO_1);
             }
             ImGui::SameLine(); ImGui::Text(ui->ratioMode_val ? "(Limit)" : "(Comp)");
             ImGui::PopID();
 
             ImGui::Dummy(ImVec2(0, 20));
 
-            // Knob per High Frequency Compression (LA-3A tipico)
-            ImGui::PushID("HFComp");
-            if (KnobRotaryImage("HF Comp", &ui->hfComp_val, 0.0f, 1.0f, // Range tipico 0.0-1.0 o dB
-                                ui->knobTextureID_hfComp, ui->knobFrameWidth, ui->knobFrameWidth,
-                                ui->knobTotalFrames, knob_img_size, "%.2f")) {
-                ui->write_function(ui->controller, hfComp_URID, sizeof(float), 0, &ui->hfComp_val);
-            }
-            ImGui::PopID();
-
-            ImGui::Dummy(ImVec2(0, 20));
-
             // Pulsante normale per Bypass
             ImGui::PushID("Bypass");
             float bypass_button_width = 100;
@@ -656,7 +683,7 @@ static void draw_ui(Gla3aUI* ui) {
             if (ImGui::Button(ui->bypass_val ? "BYPASS ON" : "BYPASS OFF", ImVec2(bypass_button_width, 30))) {
                 ui->bypass_val = !ui->bypass_val;
                 float val = ui->bypass_val ? 1.0f : 0.0f;
-                ui->write_function(ui->controller, bypass_URID, sizeof(float), 0, &val);
+                send_parameter(ui, bypass_URID, val);
             }
             ImGui::PopID();
 
@@ -714,14 +741,7 @@ static void draw_ui(Gla3aUI* ui) {
 
             // Oversampling
             if (ImGui::Checkbox("Oversampling On", &ui->oversamplingOn_val)) {
-                float val = ui->oversamplingOn_val ? 1.0f : 0.0f;
-                ui->write_function(ui->controller, oversamplingOn_URID, sizeof(float), 0, &val);
-            }
-
-            // Sidechain Mode (External Sidechain)
-            if (ImGui::Checkbox("External Sidechain", &ui->sidechainMode_val)) {
-                float val = ui->sidechainMode_val ? 1.0f : 0.0f;
-                ui->write_function(ui->controller, sidechainMode_URID, sizeof(float), 0, &val);
+                send_parameter(ui, oversamplingOn_URID, ui->oversamplingOn_val ? (float)GLA3A_OS_4X : (float)GLA3A_OS_1X);
             }
 
             ImGui::Dummy(ImVec2(0, 20));
@@ -732,20 +752,20 @@ static void draw_ui(Gla3aUI* ui) {
             ImGui::Text("HP Filter");
             if (ImGui::Checkbox("HP On", &ui->scHpOn_val)) {
                 float val = ui->scHpOn_val ? 1.0f : 0.0f;
-                ui->write_function(ui->controller, scHpOn_URID, sizeof(float), 0, &val);
+                send_parameter(ui, scHpOn_URID, val);
             }
             ImGui::PushID("HpFreq");
             if (KnobRotaryImage("Freq", &ui->scHpFq_val, 20.0f, 20000.0f,
                                 ui->knobTextureID_scHpFq, ui->knobFrameWidth, ui->knobFrameWidth,
                                 ui->knobTotalFrames, knob_img_size_small, "%.0f Hz")) {
-                ui->write_function(ui->controller, scHpFq_URID, sizeof(float), 0, &ui->scHpFq_val);
+                send_parameter(ui, scHpFq_URID, ui->scHpFq_val);
             }
             ImGui::PopID();
             ImGui::PushID("HpQ");
             if (KnobRotaryImage("Q", &ui->scHpQ_val, 0.1f, 10.0f,
                                 ui->knobTextureID_scHpQ, ui->knobFrameWidth, ui->knobFrameWidth,
                                 ui->knobTotalFrames, knob_img_size_small, "%.2f")) {
-                ui->write_function(ui->controller, scHpQ_URID, sizeof(float), 0, &ui->scHpQ_val);
+                send_parameter(ui, scHpQ_URID, ui->scHpQ_val);
             }
             ImGui::PopID();
 
@@ -754,20 +774,20 @@ static void draw_ui(Gla3aUI* ui) {
             ImGui::Text("LP Filter");
             if (ImGui::Checkbox("LP On", &ui->scLpOn_val)) {
                 float val = ui->scLpOn_val ? 1.0f : 0.0f;
-                ui->write_function(ui->controller, scLpOn_URID, sizeof(float), 0, &val);
+                send_parameter(ui, scLpOn_URID, val);
             }
             ImGui::PushID("LpFreq");
             if (KnobRotaryImage("Freq", &ui->scLpFq_val, 20.0f, 20000.0f,
                                 ui->knobTextureID_scLpFq, ui->knobFrameWidth, ui->knobFrameWidth,
                                 ui->knobTotalFrames, knob_img_size_small, "%.0f Hz")) {
-                ui->write_function(ui->controller, scLpFq_URID, sizeof(float), 0, &ui->scLpFq_val);
+                send_parameter(ui, scLpFq_URID, ui->scLpFq_val);
             }
             ImGui::PopID();
             ImGui::PushID("LpQ");
             if (KnobRotaryImage("Q", &ui->scLpQ_val, 0.1f, 10.0f,
                                 ui->knobTextureID_scLpQ, ui->knobFrameWidth, ui->knobFrameWidth,
                                 ui->knobTotalFrames, knob_img_size_small, "%.2f")) {
-                ui->write_function(ui->controller, scLpQ_URID, sizeof(float), 0, &ui->scLpQ_val);
+                send_parameter(ui, scLpQ_URID, ui->scLpQ_val);
             }
             ImGui::PopID();
 
@@ -793,54 +813,65 @@ static void draw_ui(Gla3aUI* ui) {
     }
 
     glXSwapBuffers(ui->display, ui->window);
+
+    // Un controllo trascinato o l'input appena arrivato chiedono ancora frame, il resto aspetta un evento
+    if (ui->input_frames > 0) --ui->input_frames;
+    ui->dirty = ui->input_frames > 0 || ImGui::IsAnyItemActive();
 }
 
-static void port_event(LV2_UI_Handle handle, LV2_URID port_urid, uint32_t buffer_size, uint32_t format, const void* buffer) {
+// Frame dei meter (vedi gla3a.h): letto sul posto nel buffer dell'host, senza copie né allocazioni.
+// Il plugin riporta la GR in dB positivi, la barra la vuole negativa.
+// Vero se un valore è cambiato: frame uguali (silenzio, compressore fermo) non ridisegnano la UI.
+static bool handle_meter_frame(Gla3aUI* ui, const LV2_Atom* atom) {
+    if (atom->type != ui->atom_Object) return false;
+    const LV2_Atom_Object* obj = (const LV2_Atom_Object*)atom;
+    if (obj->body.otype != ui->meter_frame) return false;
+
+    const LV2_Atom* values = NULL;
+    lv2_atom_object_get(obj, ui->meter_values, &values, 0);
+    const LV2_Atom_Vector* vec = (const LV2_Atom_Vector*)values;
+    if (!vec || vec->atom.type != ui->atom_Vector || vec->body.child_type != ui->atom_Float ||
+        vec->atom.size < sizeof(LV2_Atom_Vector_Body) + GLA3A_METER_NUM_VALUES * sizeof(float)) {
+        return false;
+    }
+    const float* m = (const float*)(vec + 1);
+    const bool changed = ui->peakInL_val != m[GLA3A_METER_IN_PEAK_L] || ui->peakInR_val != m[GLA3A_METER_IN_PEAK_R] ||
+                         ui->peakOutL_val != m[GLA3A_METER_OUT_PEAK_L] || ui->peakOutR_val != m[GLA3A_METER_OUT_PEAK_R] ||
+                         ui->peakGR_val != -m[GLA3A_METER_GR];
+    ui->peakInL_val = m[GLA3A_METER_IN_PEAK_L];
+    ui->peakInR_val = m[GLA3A_METER_IN_PEAK_R];
+    ui->peakOutL_val = m[GLA3A_METER_OUT_PEAK_L];
+    ui->peakOutR_val = m[GLA3A_METER_OUT_PEAK_R];
+    ui->peakGR_val = -m[GLA3A_METER_GR];
+    return changed;
+}
+
+static void port_event(LV2_UI_Handle handle, uint32_t port_index, uint32_t buffer_size, uint32_t format, const void* buffer) {
     Gla3aUI* ui = (Gla3aUI*)handle;
 
-    if (format == 0) { // LV2_Atom_Port_Float
-        if (port_urid == peakReduction_URID) {
-            ui->peakReduction_val = *(const float*)buffer;
-        } else if (port_urid == gain_URID) {
-            ui->gain_val = *(const float*)buffer;
-        } else if (port_urid == hfComp_URID) {
-            ui->hfComp_val = *(const float*)buffer;
-        } else if (port_urid == bypass_URID) {
-            ui->bypass_val = (*(const float*)buffer != 0.0f);
-        } else if (port_urid == ratioMode_URID) {
-            ui->ratioMode_val = (*(const float*)buffer != 0.0f);
-        } else if (port_urid == inputPad10dB_URID) {
-            ui->inputPad10dB_val = (*(const float*)buffer != 0.0f);
-        } else if (port_urid == oversamplingOn_URID) {
-            ui->oversamplingOn_val = (*(const float*)buffer != 0.0f);
-        } else if (port_urid == sidechainMode_URID) {
-            ui->sidechainMode_val = (*(const float*)buffer != 0.0f);
-        } else if (port_urid == scLpOn_URID) {
-            ui->scLpOn_val = (*(const float*)buffer != 0.0f);
-        } else if (port_urid == scLpFq_URID) {
-            ui->scLpFq_val = *(const float*)buffer;
-        } else if (port_urid == scLpQ_URID) {
-            ui->scLpQ_val = *(const float*)buffer;
-        } else if (port_urid == scHpOn_URID) {
-            ui->scHpOn_val = (*(const float*)buffer != 0.0f);
-        } else if (port_urid == scHpFq_URID) {
-            ui->scHpFq_val = *(const float*)buffer;
-        } else if (port_urid == scHpQ_URID) {
-            ui->scHpQ_val = *(const float*)buffer;
-        }
-        else if (port_urid == peakGR_URID) {
-            ui->peakGR_val = *(const float*)buffer;
-        } else if (port_urid == peakInL_URID) {
-            ui->peakInL_val = *(const float*)buffer;
-        } else if (port_urid == peakInR_URID) {
-            ui->peakInR_val = *(const float*)buffer;
-        } else if (port_urid == peakOutL_URID) {
-            ui->peakOutL_val = *(const float*)buffer;
-        } else if (port_urid == peakOutR_URID) {
-            ui->peakOutR_val = *(const float*)buffer;
+    if (format == 0) { // Porta di controllo: buffer è un float, nelle unità della porta
+        const float v = *(const float*)buffer;
+        switch (port_index) {
+            case GLA3A_PEAK_REDUCTION:
+                ui->peakReduction_val = GLA3A_PEAK_REDUCTION_MIN_DB + v * (GLA3A_PEAK_REDUCTION_MAX_DB - GLA3A_PEAK_REDUCTION_MIN_DB);
+                break;
+            case GLA3A_GAIN:                 ui->gain_val = v * GLA3A_GAIN_MAX_DB; break;
+            case GLA3A_BYPASS:               ui->bypass_val = (v > 0.5f); break;
+            case GLA3A_RATIO_MODE:           ui->ratioMode_val = (v > GLA3A_RATIO_9_TO_1 + 0.5f); break;
+            case GLA3A_OVERSAMPLING:         ui->oversamplingOn_val = (v > GLA3A_OS_1X + 0.5f); break;
+            case GLA3A_SC_LP_ON:             ui->scLpOn_val = (v > 0.5f); break;
+            case GLA3A_SC_LP_FREQ:           ui->scLpFq_val = v; break;
+            case GLA3A_SC_LP_Q:              ui->scLpQ_val = v; break;
+            case GLA3A_SC_HP_ON:             ui->scHpOn_val = (v > 0.5f); break;
+            case GLA3A_SC_HP_FREQ:           ui->scHpFq_val = v; break;
+            case GLA3A_SC_HP_Q:              ui->scHpQ_val = v; break;
+            default: break;
         }
+        ui->dirty = true;
+    } else if (format == ui->atom_eventTransfer && port_index == GLA3A_NOTIFY) {
+        if (handle_meter_frame(ui, (const LV2_Atom*)buffer)) ui->dirty = true;
     }
-    draw_ui(ui);
+    // Niente disegno qui: la prossima ui_idle() fa un frame solo per tutti gli eventi arrivati
 }
 
 
@@ -851,9 +882,13 @@ static int ui_extension_data(const char* uri) {
     return 0;
 }
 
+// Eventi X, poi al più un frame: solo se qualcosa è cambiato e se è passato 1/UI_MAX_FPS dall'ultimo
 static void ui_idle(LV2_UI_Handle handle) {
     Gla3aUI* ui = (Gla3aUI*)handle;
-    draw_ui(ui);
+    process_xevents(ui);
+    const double now = get_time_in_seconds();
+    if (!ui->dirty || now - ui->last_frame_time < 1.0 / UI_MAX_FPS) return;
+    draw_ui(ui, now);
 }
 
 static const LV2_UI_Idle_Interface idle_iface = { ui_idle };
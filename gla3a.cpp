@@ -1,19 +1,38 @@
 #include "gla3a.h"
+#include "gla3a_batch.h"
+#include "gla3a_oversampler.h"
+#include "gla3a_biquad_bank.h"
+#include "gla3a_svf.h"
+#include "gla3a_denormal.h"
+#include "gla3a_fastmath.h"
+#include "gla3a_gain_computer.h"
+#include "gla3a_isa.h"
+#include "gla3a_kernels.h"
+#include "gla3a_params.h"
+#include "gla3a_precision.h"
+#include "gla3a_stages.h"
+#include "gla3a_limiter.h"
+#include "gla3a_multiband.h"
+#include "gla3a_lanes.h"
 #include <lv2/core/lv2.h>
 #include <lv2/log/logger.h>
 #include <lv2/log/log.h>
+#include <lv2/urid/urid.h>
+#include <lv2/atom/atom.h>
+#include <lv2/atom/util.h>
+#include <lv2/atom/forge.h>
+#include <lv2/patch/patch.h>
+#include <lv2/options/options.h>
+#include <lv2/buf-size/buf-size.h>
+#include <lv2/worker/worker.h>
+#include <lv2/state/state.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-// --- Costanti e Definizioni ---
-#define M_PI_F 3.14159265358979323846f
-
 // --- Calibrazione del Compressore ---
-#define PEAK_REDUCTION_MIN_DB -60.0f // Soglia min per Peak Reduction (più compressione)
-#define PEAK_REDUCTION_MAX_DB -10.0f // Soglia max per Peak Reduction (meno compressione)
-#define GAIN_MAX_DB 12.0f            // Guadagno massimo applicabile in dB
+// Soglia e guadagno di uscita: GLA3A_PEAK_REDUCTION_MIN_DB e le altre in gla3a.h (servono anche alla GUI)
 #define KNEE_WIDTH_DB 10.0f          // Larghezza della soft-knee in dB
 
 // Tempi di smoothing per il detector e il gain (questi cambieranno con la ratio mode)
@@ -33,82 +52,134 @@
 #define RMS_METER_SMOOTH_MS 50.0f // Tempo in ms per la costante di tempo RMS del meter
 
 // --- OVERSEMPLING/UPSAMPLING ---
-#define UPSAMPLE_FACTOR 4 // Fattore di oversampling (2x, 4x, 8x, etc.)
-// Useremo 3 filtri biquad in cascata per l'upsampling e il downsampling,
-// per ottenere un filtro passa-basso di 6° ordine (36 dB/ottava).
-#define NUM_BIQUADS_FOR_OS_FILTER 3 
-#define OS_FILTER_Q 0.707f // Q di Butterworth per risposta piatta (o calibra per più risonanza)
-
-// --- FILTRI BIQUAD PER SIDECHAIN (6° ORDINE = 3 BIQUAD IN CASCATA) ---
-#define NUM_BIQUADS_FOR_6TH_ORDER 3 // Ogni biquad è 2° ordine (12 dB/ottava)
+// Il fattore (1x..8x) e il tipo di filtro si scelgono a runtime, vedi gla3a_oversampler.h.
+#define DEFAULT_BLOCK_SIZE 1024 // Blocco interno se l'host non riporta bufsz:maxBlockLength
+#define MAX_CHUNK_SIZE 8192     // Limite del blocco interno: blocchi più lunghi si elaborano a pezzi
 
+// --- FILTRI PER SIDECHAIN (6° ORDINE = 3 STADI IN CASCATA) ---
+#define NUM_BIQUADS_FOR_6TH_ORDER 3 // Ogni stadio è 2° ordine (12 dB/ottava)
 
-// --- Funzioni di Utilità Generali ---
+// SVF TPT con taglio e Q in glide (gla3a_svf.h), o con -DGLA3A_SIDECHAIN=GLA3A_SIDECHAIN_BIQUAD i
+// biquad progettati nel worker. Con i biquad, definire GLA3A_SCALAR_BIQUADS per filtrare la
+// sidechain con i BiquadFilter scalari (implementazione di riferimento) invece del banco M/S.
 
-static float to_db(float linear_val) {
-    if (linear_val <= 0.00000000001f) return -90.0f;
-    return 20.0f * log10f(linear_val);
-}
 
-static float db_to_linear(float db_val) {
-    return powf(10.0f, db_val / 20.0f);
+// --- Funzioni di Utilità Generali ---
+// to_db/db_to_linear, soft-clip e distorsione J-FET sono in gla3a_stages.h
+
+// Somme parziali dei meter: i quadrati si accumulano in due v8sf (16 somme indipendenti), poi
+// sommate in un ordine fisso. I v8sf sono due registri SSE in ciascuno, uno AVX nelle varianti di
+// gla3a_isa.h: il risultato non dipende dalla variante che lo calcola.
+#define METER_PARTIAL_SUMS 16
+
+// Somma delle somme parziali (gli accumulatori e gli ultimi campioni), in ordine fisso
+static float partial_sums_total(const v8sf* acc, const float* tail, uint32_t tail_len) {
+    float partial[METER_PARTIAL_SUMS];
+    memcpy(partial, acc, sizeof(partial));
+    for (uint32_t k = 0; k < tail_len; ++k) partial[k] += tail[k];
+    float sum = 0.0f;
+    for (int k = 0; k < METER_PARTIAL_SUMS; ++k) sum += partial[k];
+    return sum;
 }
 
-// Funzione per applicare il soft-clipping finale
-static float apply_final_soft_clip(float sample, float threshold_linear, float amount) {
-    float sign = (sample >= 0) ? 1.0f : -1.0f;
-    float abs_sample = fabsf(sample);
-
-    if (abs_sample <= threshold_linear) {
-        return sample;
-    } else {
-        float normalized_over_threshold = (abs_sample - threshold_linear) / (1.0f - threshold_linear);
-        float clipped_val = threshold_linear + (1.0f - threshold_linear) * (1.0f - expf(-amount * normalized_over_threshold));
-        return sign * fminf(clipped_val, 1.0f);
+// Media dei quadrati dei campioni
+static float mean_square(const float* buffer, uint32_t n_samples) {
+    v8sf acc[2] = { v8sf_set1(0.0f), v8sf_set1(0.0f) };
+    float tail[METER_PARTIAL_SUMS];
+    uint32_t i = 0;
+    for (; i + METER_PARTIAL_SUMS <= n_samples; i += METER_PARTIAL_SUMS) {
+        for (int k = 0; k < 2; ++k) {
+            v8sf x;
+            memcpy(&x, buffer + i + 8 * k, sizeof(x)); // I buffer dell'host non sono allineati
+            acc[k] += x * x;
+        }
     }
+    for (uint32_t k = 0; i + k < n_samples; ++k) tail[k] = buffer[i + k] * buffer[i + k];
+    return partial_sums_total(acc, tail, n_samples - i) / n_samples;
 }
 
-// Funzione per la distorsione J-FET (approssimazione sigmoide)
-static float apply_jfet_distortion(float sample, float k_factor, float threshold_jfet, float dry_wet_mix) {
-    float distorted_sample;
-    float abs_sample = fabsf(sample);
-
-    if (abs_sample <= threshold_jfet) {
-        distorted_sample = sample; // Nessuna distorsione significativa sotto la soglia
-    } else {
-        // Normalizza il sample oltre la soglia
-        float x_norm = (abs_sample - threshold_jfet) / (1.0f - threshold_jfet);
-        // Applica la funzione di shaping basata su arctan o tanh (più comune per J-FET)
-        // Usiamo una curva sigmoide più generale che include k_factor per variabilità
-        float shaped_x = x_norm / (1.0f + k_factor * x_norm);
-        distorted_sample = threshold_jfet + (1.0f - threshold_jfet) * shaped_x;
-
-        // Ri-applica il segno originale
-        distorted_sample = (sample >= 0) ? distorted_sample : -distorted_sample;
+// Media dei quadrati del canale Mid, (left + right) / 2
+static float mean_square_mid(const float* left, const float* right, uint32_t n_samples) {
+    v8sf acc[2] = { v8sf_set1(0.0f), v8sf_set1(0.0f) };
+    float tail[METER_PARTIAL_SUMS];
+    uint32_t i = 0;
+    for (; i + METER_PARTIAL_SUMS <= n_samples; i += METER_PARTIAL_SUMS) {
+        for (int k = 0; k < 2; ++k) {
+            v8sf l, r;
+            memcpy(&l, left + i + 8 * k, sizeof(l));
+            memcpy(&r, right + i + 8 * k, sizeof(r));
+            const v8sf mid = (l + r) * 0.5f;
+            acc[k] += mid * mid;
+        }
     }
-    
-    // Mix dry/wet
-    return sample * (1.0f - dry_wet_mix) + distorted_sample * dry_wet_mix;
+    for (uint32_t k = 0; i + k < n_samples; ++k) {
+        const float mid = (left[i + k] + right[i + k]) * 0.5f;
+        tail[k] = mid * mid;
+    }
+    return partial_sums_total(acc, tail, n_samples - i) / n_samples;
 }
 
-
 // Funzione per calcolare l'RMS per il meter di output
 static float calculate_rms_level(const float* buffer, uint32_t n_samples, float current_rms, float alpha) {
     if (n_samples == 0) return current_rms;
-    float sum_sq = 0.0f;
-    for (uint32_t i = 0; i < n_samples; ++i) {
-        sum_sq += buffer[i] * buffer[i];
+    float block_rms_linear = sqrtf(mean_square(buffer, n_samples));
+    return flush_denormal((current_rms * (1.0f - alpha)) + (block_rms_linear * alpha));
+}
+
+// Come calculate_rms_level, sul canale Mid ricavato al volo da L/R (senza buffer temporanei)
+static float calculate_mid_rms_level(const float* left, const float* right, uint32_t n_samples, float current_rms, float alpha) {
+    if (n_samples == 0) return current_rms;
+    float block_rms_linear = sqrtf(mean_square_mid(left, right, n_samples));
+    return flush_denormal((current_rms * (1.0f - alpha)) + (block_rms_linear * alpha));
+}
+
+// Picco e somma dei quadrati di un pezzo di segnale stereo, per i frame dei meter (GLA3A_NOTIFY)
+typedef struct {
+    float peak[2]; // [0] = Left, [1] = Right
+    float sum[2];
+} MeterSums;
+
+// Un canale: i quadrati con le somme parziali di mean_square(), il picco con il massimo per corsia
+static void meter_channel(const float* buffer, uint32_t n_samples, float* peak, float* sum) {
+    v8sf acc[2] = { v8sf_set1(0.0f), v8sf_set1(0.0f) };
+    v8sf max[2] = { v8sf_set1(0.0f), v8sf_set1(0.0f) };
+    float tail[METER_PARTIAL_SUMS];
+    uint32_t i = 0;
+    for (; i + METER_PARTIAL_SUMS <= n_samples; i += METER_PARTIAL_SUMS) {
+        for (int k = 0; k < 2; ++k) {
+            v8sf x;
+            memcpy(&x, buffer + i + 8 * k, sizeof(x));
+            acc[k] += x * x;
+            const v8sf a = v8sf_abs(x);
+            max[k] = v8sf_select(v8sf_gt(a, max[k]), a, max[k]);
+        }
     }
-    float block_rms_linear = sqrtf(sum_sq / n_samples);
-    return (current_rms * (1.0f - alpha)) + (block_rms_linear * alpha);
+    float lanes[METER_PARTIAL_SUMS];
+    memcpy(lanes, max, sizeof(lanes));
+    float m = 0.0f;
+    for (int k = 0; k < METER_PARTIAL_SUMS; ++k) m = fmaxf(m, lanes[k]);
+    for (uint32_t k = 0; i + k < n_samples; ++k) {
+        tail[k] = buffer[i + k] * buffer[i + k];
+        m = fmaxf(m, fabsf(buffer[i + k]));
+    }
+    *peak = m;
+    *sum = partial_sums_total(acc, tail, n_samples - i);
+}
+
+static void meter_sums(const float* left, const float* right, uint32_t n_samples, MeterSums* sums) {
+    meter_channel(left, n_samples, &sums->peak[0], &sums->sum[0]);
+    meter_channel(right, n_samples, &sums->peak[1], &sums->sum[1]);
 }
 
 
 // --- Strutture e Funzioni per Filtri Biquad ---
+// Solo per la sidechain a biquad (GLA3A_SIDECHAIN_BIQUAD)
+
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_BIQUAD
 
 typedef struct {
-    float a0, a1, a2, b0, b1, b2; // Coefficienti
-    float z1, z2;                 // Stati precedenti
+    FilterReal a0, a1, a2, b0, b1, b2; // Coefficienti (precisione in gla3a_precision.h)
+    FilterReal z1, z2;                 // Stati precedenti
 } BiquadFilter;
 
 static void biquad_init(BiquadFilter* f) {
@@ -116,13 +187,23 @@ static void biquad_init(BiquadFilter* f) {
     f->z1 = f->z2 = 0.0f;
 }
 
-static float biquad_process(BiquadFilter* f, float in) {
-    float out = in * f->b0 + f->z1;
+// Azzera solo lo stato: i coefficienti progettati restano (activate)
+static void biquad_reset(BiquadFilter* f) {
+    f->z1 = f->z2 = 0.0f;
+}
+
+static inline DetectorReal biquad_process(BiquadFilter* f, DetectorReal in) {
+    FilterReal out = in * f->b0 + f->z1;
     f->z1 = in * f->b1 + f->z2 - f->a1 * out;
     f->z2 = in * f->b2 - f->a2 * out;
     return out;
 }
 
+static inline void biquad_flush_denormals(BiquadFilter* f) {
+    f->z1 = flush_denormal(f->z1);
+    f->z2 = flush_denormal(f->z2);
+}
+
 // Calcola i coefficienti per un filtro biquad (Low Pass o High Pass)
 // freq_hz: frequenza di taglio
 // q_val: fattore di qualità (risonanza)
@@ -131,12 +212,12 @@ static void calculate_biquad_coeffs(BiquadFilter* f, double samplerate, float fr
     if (freq_hz <= 0.0f) freq_hz = 1.0f; // Evita divisione per zero o log(0)
     if (q_val <= 0.0f) q_val = 0.1f;    // Evita divisione per zero o Q troppo basso
 
-    float omega = 2.0f * M_PI_F * freq_hz / samplerate;
-    float sin_omega = sinf(omega);
-    float cos_omega = cosf(omega);
-    float alpha = sin_omega / (2.0f * q_val); // Q del filtro
+    FilterReal omega = 2 * FILTER_PI * freq_hz / samplerate;
+    FilterReal sin_omega = real_sin(omega);
+    FilterReal cos_omega = real_cos(omega);
+    FilterReal alpha = sin_omega / (2.0f * q_val); // Q del filtro
 
-    float b0, b1, b2, a0, a1, a2;
+    FilterReal b0, b1, b2, a0, a1, a2;
 
     if (type == 0) { // Low Pass Filter
         b0 = (1.0f - cos_omega) / 2.0f;
@@ -162,24 +243,46 @@ static void calculate_biquad_coeffs(BiquadFilter* f, double samplerate, float fr
     f->a2 = a2 / a0;
     f->a0 = 1.0f; // Questo non viene usato nel process, è solo per chiarezza
 }
+#endif // GLA3A_SIDECHAIN_BIQUAD
+
+
+// Grandezze costose da progettare (curva del gain computer, filtri della sidechain, crossover):
+// nel worker se l'host offre work:schedule, altrimenti direttamente nel run (vedi design_update())
+typedef struct {
+    ParamMask groups;           // Ingressi dei gruppi progettati (PARAMS_RATIO, PARAMS_SC_*, PARAMS_CROSSOVER)
+    GLA3A_RatioMode ratio_mode;
+    GainComputer gain_computer;
+    FilterReal detector_attack_alpha;
+    FilterReal detector_release_alpha;
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_BIQUAD
+    BiquadFilter sc_lp;         // Coefficienti comuni ai 3 stadi e ai due canali
+    BiquadFilter sc_hp;
+#endif
+    Crossover crossover;        // Solo bande, frequenze e coefficienti
+} CoeffDesign;
+
+// Richiesta al worker: i gruppi da progettare, i valori dei parametri al momento dell'invio e la
+// destinazione (-1: l'istanza, poi design_collect(); altrimenti uno slot del banco di preset).
+// La risposta porta solo la destinazione.
+typedef struct {
+    ParamMask groups;
+    int32_t slot;
+    float value[PARAMS_MAX_PORTS];
+} DesignRequest;
+
+// Slot del banco di preset: valori dei parametri (indicizzati per porta) e grandezze derivate già
+// progettate, così che richiamarlo nel run sia solo una copia
+typedef struct {
+    float value[PARAMS_MAX_PORTS];
+    CoeffDesign design;         // Valido se ready (altrimenti è del worker o ancora da progettare)
+    bool ready;
+} PresetSlot;
 
 
 // Struct del plugin
 typedef struct {
-    // Puntatori ai parametri di controllo
-    float* peak_reduction_ptr;
-    float* gain_ptr;
-    float* meter_ptr;
-    float* bypass_ptr;
-    float* ms_mode_active_ptr;
-    float* ratio_mode_ptr;
-
-    float* sc_lp_on_ptr;
-    float* sc_lp_freq_ptr;
-    float* sc_lp_q_ptr;
-    float* sc_hp_on_ptr;
-    float* sc_hp_freq_ptr;
-    float* sc_hp_q_ptr;
+    // Parametri di controllo in ingresso (porte, ultimi valori e bit di cambiamento)
+    ParamState params;
 
     // Puntatori per i meter (output del plugin, input per la GUI)
     float* output_rms_ptr;
@@ -191,117 +294,771 @@ typedef struct {
     float* audio_out_l_ptr;
     float* audio_out_r_ptr;
 
+    // Latenza riportata all'host
+    float* latency_ptr;
+
+    // Eventi patch:Set in ingresso (parametri con il loro timestamp)
+    const LV2_Atom_Sequence* control_ptr;
+
+    // Frame dei meter in uscita (vedi meter_feed()), scritti con il forge nel buffer dell'host
+    LV2_Atom_Sequence* notify_ptr;
+    LV2_Atom_Forge forge;
+    LV2_Atom_Forge_Frame notify_frame;
+    bool notify_open;           // Sequenza aperta: solo durante run(), se la porta ha spazio
+
     // Variabili di stato del plugin
+    int isa;                       // Variante dei kernel (GLA3A_ISA_*), scelta in instantiate()
     double samplerate;
     double oversampled_samplerate; // Nuovo
     LV2_Log_Log* log;
     LV2_Log_Logger logger;
 
     // Variabili di stato per l'algoritmo di compressione
-    float detector_envelope_M; // Envelope del detector per Mid/Left
-    float detector_envelope_S; // Envelope del detector per Side/Right
+    FilterReal detector_envelope_M; // Envelope del detector per Mid/Left
+    FilterReal detector_envelope_S; // Envelope del detector per Side/Right
+
+    FilterReal current_gain_M;      // Guadagno attuale per Mid/Left (lineare)
+    FilterReal current_gain_S;      // Guadagno attuale per Side/Right (lineare)
 
-    float current_gain_M;      // Guadagno attuale per Mid/Left (lineare)
-    float current_gain_S;      // Guadagno attuale per Side/Right (lineare)
+    // Curva soft-knee precalcolata (ricostruita solo al cambio di ratio)
+    GainComputer gain_computer;
 
     // Filtri Sidechain (6° Ordine)
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    // Taglio e Q in glide verso i target di update_derived_params(), M e S insieme
+    SvfBank sc_lp_svf;
+    SvfBank sc_hp_svf;
+#else
+    // I BiquadFilter scalari tengono i coefficienti (e gli stati nel percorso di riferimento),
+    // i banchi vettoriali elaborano M e S insieme.
     BiquadFilter sc_lp_filters_M[NUM_BIQUADS_FOR_6TH_ORDER];
     BiquadFilter sc_hp_filters_M[NUM_BIQUADS_FOR_6TH_ORDER];
     BiquadFilter sc_lp_filters_S[NUM_BIQUADS_FOR_6TH_ORDER];
     BiquadFilter sc_hp_filters_S[NUM_BIQUADS_FOR_6TH_ORDER];
+    BiquadBank sc_lp_bank;
+    BiquadBank sc_hp_bank;
+#endif
 
     // Parametri di smoothing (alpha) pre-calcolati (variano con la ratio mode)
-    float detector_attack_alpha;
-    float detector_release_alpha;
-    float gain_smooth_alpha; // Smoothing molto veloce per il guadagno applicato
+    FilterReal detector_attack_alpha;
+    FilterReal detector_release_alpha;
+    FilterReal gain_smooth_alpha; // Smoothing molto veloce per il guadagno applicato
     float rms_meter_alpha;   // Smoothing per il meter RMS di output
 
-    // Cache per i parametri dei filtri (per evitare ricalcoli inutili)
-    float last_sc_lp_freq;
-    float last_sc_lp_q;
-    float last_sc_hp_freq;
-    float last_sc_hp_q;
-
-    // Buffer per oversampling (per blocco di input completo)
-    float* oversample_buffer_M; // Nuovo
-    float* oversample_buffer_S; // Nuovo
-    uint32_t oversample_buffer_size; // size = sample_count * UPSAMPLE_FACTOR // Nuovo
-
-    // Filtri per upsampling/downsampling (Biquad di 6° Ordine) // Nuovo
-    BiquadFilter upsample_lp_filters_M[NUM_BIQUADS_FOR_OS_FILTER];
-    BiquadFilter upsample_lp_filters_S[NUM_BIQUADS_FOR_OS_FILTER];
-    BiquadFilter downsample_lp_filters_M[NUM_BIQUADS_FOR_OS_FILTER];
-    BiquadFilter downsample_lp_filters_S[NUM_BIQUADS_FOR_OS_FILTER];
+    // Grandezze derivate dai parametri (ricalcolate solo quando cambiano i loro ingressi)
+    GLA3A_RatioMode ratio_mode;
+    float current_threshold_db;
+    float current_threshold_linear;
+    float make_up_gain_linear;
+    float final_soft_clip_threshold_linear;
+
+    // Buffer di lavoro, tutti ricavati da un'unica arena allineata allocata in create_instance().
+    // run() elabora al massimo max_block_size campioni alla volta: blocchi più lunghi vanno a pezzi.
+    float* arena;
+    float* base_buffer_M;       // M/S (o L/R) alla frequenza originale, prima e dopo l'oversampling
+    float* base_buffer_S;
+    float* oversample_buffer_M;
+    float* oversample_buffer_S;
+    float* oversample_scratch_M; // Appoggio per gli stadi intermedi dell'interpolazione
+    float* oversample_scratch_S;
+    DetectorReal* sidechain_buffer_M; // Segnale del detector (rettificato e filtrato)
+    DetectorReal* sidechain_buffer_S;
+    float* limiter_memory;      // Linee di ritardo e finestre del limiter lookahead
+    float* bypass_delay_l;      // Ingresso ritardato per il bypass (anelli di bypass_delay_mask + 1)
+    float* bypass_delay_r;
+    uint32_t bypass_delay_mask;
+    uint32_t bypass_delay_pos;
+    uint32_t max_block_size;    // Campioni alla frequenza originale che i buffer possono contenere
+    LV2_URID_Map* map;
+
+    // URID per decodificare i patch:Set (tutti 0 se l'host non fornisce urid:map)
+    struct {
+        LV2_URID atom_Object;
+        LV2_URID atom_Blank;
+        LV2_URID atom_Float;
+        LV2_URID atom_Double;
+        LV2_URID atom_Int;
+        LV2_URID atom_Long;
+        LV2_URID atom_Bool;
+        LV2_URID atom_URID;
+        LV2_URID atom_Vector;
+        LV2_URID patch_Set;
+        LV2_URID patch_property;
+        LV2_URID patch_value;
+        LV2_URID preset;
+        LV2_URID preset_store;
+        LV2_URID preset_bank;
+        LV2_URID meter_frame;
+        LV2_URID meter_values;
+    } uris;
+    LV2_URID param_urids[GLA3A_NUM_PARAMETERS]; // Stesso ordine di gla3a_parameters[]
+
+    // Oversampler polifase (M e S nelle corsie dello stesso vettore)
+    Oversampler oversampler;
+    int os_factor;              // Fattore attivo (1, 2, 4, 8)
+    int os_mode;                // OversamplerMode attivo
+
+    // Limiter lookahead (solo in modalità Limit, al posto del compressore)
+    LookaheadLimiter limiter;
+
+    // Modalità multibanda (con più di una banda, al posto del detector a banda singola)
+    Crossover crossover;
+    BandDynamics band_dynamics_M;
+    BandDynamics band_dynamics_S;
+    v4sf band_threshold_db;     // Soglia di ogni banda: Peak Reduction + offset della banda
+    v4sf* band_buffer_M;        // Campioni divisi in bande, un v4sf per campione
+    v4sf* band_buffer_S;
+
+    // Riposo: il silenzio in ingresso non cambia più lo stato, i blocchi si saltano (vedi run_segment)
+    bool idle;
+
+    // Progetto dei coefficienti nel worker (NULL se l'host non offre work:schedule)
+    LV2_Worker_Schedule* schedule;
+    CoeffDesign design;         // Del worker da quando la richiesta parte a quando run() la applica
+    ParamMask design_pending;   // Ingressi cambiati non ancora mandati al worker
+    bool design_in_flight;      // Una richiesta mandata e non ancora applicata (al massimo una)
+    bool design_ready;          // work_response() arrivata: si applica all'inizio della prossima run
+    bool design_inline;         // Prima progettazione dopo instantiate/activate: subito, nel run
+    bool design_discard;        // Il progetto in volo è superato da un preset o dal restore
+    int32_t design_slot;        // Destinazione della richiesta in volo (come DesignRequest::slot)
+    ParamMask design_preloaded; // Ingressi già progettati da un preset o dal restore, con i valori
+    float preload_value[PARAMS_MAX_PORTS]; // per cui sono stati progettati
+
+    // Banco di preset (vedi preset_recall()); slot salvati da progettare nel worker, un bit per slot
+    PresetSlot presets[GLA3A_NUM_PRESETS];
+    uint32_t preset_store_pending;
     
     // Meter display
     float current_output_rms_level;
     float current_gain_reduction_display;
 
+    // Finestra dei frame per la GUI: meter_count campioni su meter_period
+    uint32_t meter_period;
+    uint32_t meter_count;
+    MeterSums meter_in;
+    MeterSums meter_out;
+    float meter_gain;           // Guadagno più basso della finestra (current_gain_reduction())
+
 } Gla3a;
 
 
-// Funzione di istanziazione del plugin
-static LV2_Handle
-instantiate(const LV2_Descriptor* descriptor,
-            double                    samplerate,
-            const char* bundle_path,
-            const LV2_Feature* const* features) {
-    Gla3a* self = (Gla3a*)calloc(1, sizeof(Gla3a));
-    if (!self) return NULL;
+static void free_buffers(Gla3a* self) {
+    free(self->arena);
+    self->arena = NULL;
+    self->base_buffer_M = self->base_buffer_S = NULL;
+    self->oversample_buffer_M = self->oversample_buffer_S = NULL;
+    self->oversample_scratch_M = self->oversample_scratch_S = NULL;
+    self->sidechain_buffer_M = self->sidechain_buffer_S = NULL;
+    self->limiter_memory = NULL;
+    self->bypass_delay_l = self->bypass_delay_r = NULL;
+    self->band_buffer_M = self->band_buffer_S = NULL;
+    self->max_block_size = 0;
+}
+
+// Numero di float occupati da un buffer nell'arena, arrotondato a 64 byte
+static size_t arena_slot(size_t n_floats) {
+    return (n_floats + 15) & ~(size_t)15;
+}
+
+// Alloca l'arena per blocchi fino a 'block_size' campioni (dimensionata per il fattore massimo)
+// e per il lookahead massimo del limiter alla frequenza di campionamento dell'istanza. La linea di
+// ritardo del bypass copre la latenza massima: l'oversampler deve essere già progettato.
+// Chiamata solo da create_instance(): run() non alloca mai.
+static bool allocate_buffers(Gla3a* self, uint32_t block_size) {
+    free_buffers(self);
+
+    const size_t base = arena_slot(block_size);
+    const size_t oversampled = arena_slot((size_t)block_size * OS_MAX_FACTOR);
+    const size_t scratch = arena_slot((size_t)block_size * OS_MAX_FACTOR / 2);
+    const size_t sidechain = arena_slot((size_t)block_size * sizeof(DetectorReal) / sizeof(float));
+    const uint32_t limiter_capacity = limiter_length_from_ms(LIMITER_MAX_LOOKAHEAD_MS, self->samplerate);
+    const size_t limiter = arena_slot(limiter_memory_floats(limiter_capacity));
+    const size_t bands = arena_slot((size_t)block_size * MULTIBAND_MAX_BANDS);
+    const uint32_t max_latency = oversampler_max_latency(&self->oversampler) + limiter_capacity;
+    uint32_t bypass_size = 1;
+    while (bypass_size <= max_latency) bypass_size <<= 1;
+    const size_t bypass = arena_slot(bypass_size);
+    const size_t total = 2 * (base + oversampled + scratch + sidechain + bands + bypass) + limiter;
+
+    if (posix_memalign((void**)&self->arena, 64, total * sizeof(float)) != 0) {
+        self->arena = NULL;
+        return false;
+    }
+    memset(self->arena, 0, total * sizeof(float));
+
+    float* p = self->arena;
+    self->base_buffer_M = p;         p += base;
+    self->base_buffer_S = p;         p += base;
+    self->oversample_buffer_M = p;   p += oversampled;
+    self->oversample_buffer_S = p;   p += oversampled;
+    self->oversample_scratch_M = p;  p += scratch;
+    self->oversample_scratch_S = p;  p += scratch;
+    self->sidechain_buffer_M = (DetectorReal*)p; p += sidechain;
+    self->sidechain_buffer_S = (DetectorReal*)p; p += sidechain;
+    self->limiter_memory = p;        p += limiter;
+    self->band_buffer_M = (v4sf*)p;  p += bands;
+    self->band_buffer_S = (v4sf*)p;  p += bands;
+    self->bypass_delay_l = p;        p += bypass;
+    self->bypass_delay_r = p;        p += bypass;
+    self->bypass_delay_mask = bypass_size - 1;
+    self->bypass_delay_pos = 0;
+    limiter_init(&self->limiter, self->limiter_memory, limiter_capacity);
+
+    self->max_block_size = block_size;
+    return true;
+}
+
+// Dimensione del blocco interno: bufsz:maxBlockLength dalle opzioni dell'host, se presente
+static uint32_t block_size_from_options(const LV2_Options_Option* options, LV2_URID_Map* map) {
+    if (!options || !map) return DEFAULT_BLOCK_SIZE;
+
+    const LV2_URID max_block_length = map->map(map->handle, LV2_BUF_SIZE__maxBlockLength);
+    const LV2_URID atom_int = map->map(map->handle, LV2_ATOM__Int);
+    const LV2_URID atom_long = map->map(map->handle, LV2_ATOM__Long);
+
+    for (const LV2_Options_Option* o = options; o->key; ++o) {
+        if (o->context != LV2_OPTIONS_INSTANCE || o->key != max_block_length) continue;
+        int64_t value = 0;
+        if (o->type == atom_int) value = *(const int32_t*)o->value;
+        else if (o->type == atom_long) value = *(const int64_t*)o->value;
+        if (value <= 0) return DEFAULT_BLOCK_SIZE;
+        return (value > MAX_CHUNK_SIZE) ? MAX_CHUNK_SIZE : (uint32_t)value;
+    }
+    return DEFAULT_BLOCK_SIZE;
+}
+
+// Converte il valore della porta GLA3A_OVERSAMPLING nel fattore (1, 2, 4, 8)
+static int oversampling_factor_from_port(float value) {
+    int index = (int)(value + 0.5f);
+    if (index < GLA3A_OS_1X) index = GLA3A_OS_1X;
+    if (index > GLA3A_OS_8X) index = GLA3A_OS_8X;
+    return 1 << index;
+}
+
+// Converte il valore della porta GLA3A_RATIO_MODE in un GLA3A_RatioMode valido
+static GLA3A_RatioMode ratio_mode_from_port(float value) {
+    int index = (int)(value + 0.5f);
+    if (index < GLA3A_RATIO_3_TO_1) index = GLA3A_RATIO_3_TO_1;
+    if (index > GLA3A_RATIO_LIMIT) index = GLA3A_RATIO_LIMIT;
+    return (GLA3A_RatioMode)index;
+}
+
+// Converte il valore della porta GLA3A_STEREO_LINK in un GLA3A_StereoLink valido
+static GLA3A_StereoLink stereo_link_from_port(float value) {
+    int index = (int)(value + 0.5f);
+    if (index < GLA3A_LINK_UNLINKED) index = GLA3A_LINK_UNLINKED;
+    if (index > GLA3A_LINK_BLEND) index = GLA3A_LINK_BLEND;
+    return (GLA3A_StereoLink)index;
+}
+
+// --- Aggiornamento dei Parametri Derivati ---
+// Ingressi di ogni gruppo di grandezze derivate: il gruppo si ricalcola solo se uno dei bit è acceso.
+#define PARAMS_THRESHOLD    PARAM_BIT(GLA3A_PEAK_REDUCTION)
+#define PARAMS_MAKE_UP      PARAM_BIT(GLA3A_GAIN)
+#define PARAMS_RATIO        PARAM_BIT(GLA3A_RATIO_MODE)
+#define PARAMS_SC_LP        (PARAM_BIT(GLA3A_SC_LP_FREQ) | PARAM_BIT(GLA3A_SC_LP_Q))
+#define PARAMS_SC_HP        (PARAM_BIT(GLA3A_SC_HP_FREQ) | PARAM_BIT(GLA3A_SC_HP_Q))
+#define PARAMS_SC_LP_ON     (PARAMS_SC_LP | PARAM_BIT(GLA3A_SC_LP_ON))
+#define PARAMS_SC_HP_ON     (PARAMS_SC_HP | PARAM_BIT(GLA3A_SC_HP_ON))
+#define PARAMS_OVERSAMPLING (PARAM_BIT(GLA3A_OVERSAMPLING) | PARAM_BIT(GLA3A_OS_MODE))
+#define PARAMS_LIMITER      (PARAM_BIT(GLA3A_RATIO_MODE) | PARAM_BIT(GLA3A_LOOKAHEAD))
+#define PARAMS_CROSSOVER    (PARAM_BIT(GLA3A_BANDS) | PARAM_BIT(GLA3A_CROSSOVER_1) | \
+                             PARAM_BIT(GLA3A_CROSSOVER_2) | PARAM_BIT(GLA3A_CROSSOVER_3))
+#define PARAMS_BAND_OFFSETS (PARAM_BIT(GLA3A_BAND_1_OFFSET) | PARAM_BIT(GLA3A_BAND_2_OFFSET) | \
+                             PARAM_BIT(GLA3A_BAND_3_OFFSET) | PARAM_BIT(GLA3A_BAND_4_OFFSET))
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_BIQUAD
+#define PARAMS_DESIGN_SC    (PARAMS_SC_LP | PARAMS_SC_HP)
+#else
+#define PARAMS_DESIGN_SC    0 // Gli SVF prendono solo i target, in update_derived_params()
+#endif
+#define PARAMS_DESIGN       (PARAMS_RATIO | PARAMS_DESIGN_SC | PARAMS_CROSSOVER)
+
+// --- Progetto dei Coefficienti (Worker) ---
+// Ricostruire la curva del gain computer e progettare i filtri della sidechain e del crossover
+// (trigonometria in double, tabelle) è troppo per il thread audio quando i parametri si muovono
+// di continuo. Con work:schedule run() manda al worker i valori dei parametri (DesignRequest),
+// work() progetta in self->design e risponde; all'inizio della run successiva il progetto si copia
+// nell'istanza: solo coefficienti, gli stati dei filtri e dei detector proseguono.
+// C'è al massimo una richiesta in volo, quindi self->design ha sempre un solo proprietario e lo
+// scambio non ha bisogno di lock: i cambi arrivati intanto si accumulano in design_pending e
+// partono con la richiesta successiva. Fino all'applicazione si elabora con i coefficienti vecchi.
+// Senza work:schedule (e alla prima run dopo instantiate/activate, quando non ci sono coefficienti
+// validi da tenere) il progetto si fa subito, come un tempo.
+// Lo stesso progetto serve al banco di preset: ogni slot tiene le sue grandezze derivate già pronte
+// (vedi preset_recall()), e uno slot salvato durante il run si progetta nel worker come un cambio.
+
+// Progetta i gruppi 'groups' a partire dai valori dei parametri (stessi indici di ParamState::value)
+static void design_coeffs(CoeffDesign* d, const float* value, ParamMask groups, double samplerate) {
+    d->groups = groups;
+
+    // --- Parametri di Attacco/Rilascio e Ratio in base alla modalità ---
+    if (groups & PARAMS_RATIO) {
+        float current_ratio;
+        float current_detector_attack_ms;
+        float current_detector_release_ms;
+
+        d->ratio_mode = ratio_mode_from_port(value[GLA3A_RATIO_MODE]);
+        switch (d->ratio_mode) {
+            case GLA3A_RATIO_3_TO_1:
+            default:
+                current_ratio = 3.0f;
+                current_detector_attack_ms = 10.0f; // Veloce
+                current_detector_release_ms = 200.0f; // Lento
+                break;
+            case GLA3A_RATIO_6_TO_1:
+                current_ratio = 6.0f;
+                current_detector_attack_ms = 5.0f; // Più veloce
+                current_detector_release_ms = 100.0f; // Medio
+                break;
+            case GLA3A_RATIO_9_TO_1:
+                current_ratio = 9.0f;
+                current_detector_attack_ms = 3.0f; // Ancora più veloce
+                current_detector_release_ms = 50.0f; // Più veloce
+                break;
+            case GLA3A_RATIO_LIMIT: // Limiter lookahead: l'attacco è dato dalla finestra
+                current_ratio = 20.0f; // Ratio molto alta, quasi infinita
+                current_detector_attack_ms = 1.0f; // Molto veloce
+                current_detector_release_ms = 20.0f; // Veloce, anche per il rilascio del limiter
+                break;
+        }
+
+        gain_computer_update(&d->gain_computer, current_ratio, KNEE_WIDTH_DB);
+        d->detector_attack_alpha = 1.0f - real_exp((FilterReal)(-1.0f / (samplerate * (current_detector_attack_ms / 1000.0f))));
+        d->detector_release_alpha = 1.0f - real_exp((FilterReal)(-1.0f / (samplerate * (current_detector_release_ms / 1000.0f))));
+    }
+
+    // --- Coefficienti Filtri Sidechain ---
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_BIQUAD
+    if (groups & PARAMS_SC_LP) {
+        calculate_biquad_coeffs(&d->sc_lp, samplerate, value[GLA3A_SC_LP_FREQ], value[GLA3A_SC_LP_Q], 0); // Type 0 = LP
+    }
+    if (groups & PARAMS_SC_HP) {
+        calculate_biquad_coeffs(&d->sc_hp, samplerate, value[GLA3A_SC_HP_FREQ], value[GLA3A_SC_HP_Q], 1); // Type 1 = HP
+    }
+#endif
+
+    // --- Crossover (modalità multibanda) ---
+    if (groups & PARAMS_CROSSOVER) {
+        const float crossover_freq[MULTIBAND_MAX_CROSSOVERS] = {
+            value[GLA3A_CROSSOVER_1], value[GLA3A_CROSSOVER_2], value[GLA3A_CROSSOVER_3]
+        };
+        crossover_configure(&d->crossover, (int)(value[GLA3A_BANDS] + 0.5f), crossover_freq, samplerate);
+    }
+}
+
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_BIQUAD
+static void biquad_copy_coeffs(BiquadFilter* f, const BiquadFilter* from) {
+    f->a0 = from->a0;
+    f->a1 = from->a1;
+    f->a2 = from->a2;
+    f->b0 = from->b0;
+    f->b1 = from->b1;
+    f->b2 = from->b2;
+}
+#endif
+
+// Copia nell'istanza i gruppi progettati (sul thread audio, a inizio blocco o nel progetto diretto)
+static void design_apply(Gla3a* self, const CoeffDesign* d) {
+    if (d->groups & PARAMS_RATIO) {
+        self->ratio_mode = d->ratio_mode;
+        self->gain_computer = d->gain_computer;
+        self->detector_attack_alpha = d->detector_attack_alpha;
+        self->detector_release_alpha = d->detector_release_alpha;
+    }
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_BIQUAD
+    if (d->groups & PARAMS_SC_LP) {
+        for (int i = 0; i < NUM_BIQUADS_FOR_6TH_ORDER; ++i) {
+            biquad_copy_coeffs(&self->sc_lp_filters_M[i], &d->sc_lp);
+            biquad_copy_coeffs(&self->sc_lp_filters_S[i], &d->sc_lp);
+            biquad_bank_set_stage(&self->sc_lp_bank, i, d->sc_lp.b0, d->sc_lp.b1, d->sc_lp.b2, d->sc_lp.a1, d->sc_lp.a2);
+        }
+    }
+    if (d->groups & PARAMS_SC_HP) {
+        for (int i = 0; i < NUM_BIQUADS_FOR_6TH_ORDER; ++i) {
+            biquad_copy_coeffs(&self->sc_hp_filters_M[i], &d->sc_hp);
+            biquad_copy_coeffs(&self->sc_hp_filters_S[i], &d->sc_hp);
+            biquad_bank_set_stage(&self->sc_hp_bank, i, d->sc_hp.b0, d->sc_hp.b1, d->sc_hp.b2, d->sc_hp.a1, d->sc_hp.a2);
+        }
+    }
+#endif
+    if (d->groups & PARAMS_CROSSOVER) {
+        if (d->crossover.num_bands != self->crossover.num_bands) {
+            band_dynamics_reset(&self->band_dynamics_M);
+            band_dynamics_reset(&self->band_dynamics_S);
+        }
+        crossover_copy_coeffs(&self->crossover, &d->crossover);
+    }
+    // Modalità e curve nuove possono spostare il punto fisso del riposo
+    self->idle = false;
+}
+
+// Raccoglie gli ingressi cambiati e progetta subito o li manda al worker (da update_derived_params())
+static void design_update(Gla3a* self) {
+    ParamMask changed = self->params.dirty & PARAMS_DESIGN;
+    for (ParamMask covered = changed & self->design_preloaded; covered; covered &= covered - 1) {
+        const int port = __builtin_ctzll(covered);
+        if (self->params.value[port] == self->preload_value[port]) changed &= ~PARAM_BIT(port);
+    }
+    self->design_preloaded = 0;
+    self->design_pending |= changed;
+    if (self->design_in_flight) return;
+
+    if (!self->schedule || self->design_inline) {
+        if (!self->design_pending) return;
+        design_coeffs(&self->design, self->params.value, self->design_pending, self->samplerate);
+        design_apply(self, &self->design);
+        self->design_pending = 0;
+        self->design_inline = false;
+        return;
+    }
+
+    // Prima i cambi dell'istanza, poi gli slot salvati con presetStore
+    DesignRequest request;
+    if (self->design_pending) {
+        request.groups = self->design_pending;
+        request.slot = -1;
+        memcpy(request.value, self->params.value, sizeof(request.value));
+    } else if (self->preset_store_pending) {
+        request.groups = PARAMS_DESIGN;
+        request.slot = __builtin_ctz(self->preset_store_pending);
+        memcpy(request.value, self->presets[request.slot].value, sizeof(request.value));
+    } else {
+        return;
+    }
+    if (self->schedule->schedule_work(self->schedule->handle, sizeof(request), &request) == LV2_WORKER_SUCCESS) {
+        self->design_in_flight = true;
+        self->design_slot = request.slot;
+        if (request.slot < 0) self->design_pending = 0;
+        else self->preset_store_pending &= ~(1u << request.slot);
+    } // Altrimenti (coda piena) si riprova al prossimo segmento
+}
+
+// Applica il progetto arrivato dal worker: chiamata all'inizio di run(), al confine del blocco
+static void design_collect(Gla3a* self) {
+    if (!self->design_ready) return;
+    if (!self->design_discard) design_apply(self, &self->design);
+    self->design_ready = false;
+    self->design_discard = false;
+    self->design_in_flight = false;
+}
+
+// Thread del worker: progetta nella destinazione della richiesta, poi risponde con la destinazione
+static LV2_Worker_Status
+work(LV2_Handle instance, LV2_Worker_Respond_Function respond, LV2_Worker_Respond_Handle handle,
+     uint32_t size, const void* data) {
+    Gla3a* self = (Gla3a*)instance;
+    // Richiesta non nostra: nessuna risposta, e lo stato dell'istanza (del thread audio) non si tocca
+    if (size != sizeof(DesignRequest)) return LV2_WORKER_ERR_UNKNOWN;
+    const DesignRequest* request = (const DesignRequest*)data;
+    const int32_t slot = request->slot;
+    CoeffDesign* d = (slot < 0) ? &self->design : &self->presets[slot].design;
+    design_coeffs(d, request->value, request->groups, self->samplerate);
+    return respond(handle, sizeof(slot), &slot);
+}
+
+// Thread audio (tra una run e l'altra): il progetto è pronto. Uno slot salvato di nuovo mentre
+// il worker lo progettava resta da rifare: non diventa pronto con i valori vecchi.
+static LV2_Worker_Status
+work_response(LV2_Handle instance, uint32_t size, const void* body) {
+    Gla3a* self = (Gla3a*)instance;
+    const int32_t slot = (size == sizeof(int32_t)) ? *(const int32_t*)body : -1;
+    if (slot < 0) {
+        self->design_ready = true;
+        return LV2_WORKER_SUCCESS;
+    }
+    if (!(self->preset_store_pending & (1u << slot))) self->presets[slot].ready = true;
+    self->design_in_flight = false;
+    return LV2_WORKER_SUCCESS;
+}
+
+// Ricalcola i gruppi con un ingresso cambiato (a ogni segmento di run(), prima di elaborarlo)
+static void update_derived_params(Gla3a* self) {
+    ParamState* ps = &self->params;
+
+    if (params_changed(ps, PARAMS_THRESHOLD)) {
+        self->current_threshold_db = GLA3A_PEAK_REDUCTION_MIN_DB + (params_get(ps, GLA3A_PEAK_REDUCTION) * (GLA3A_PEAK_REDUCTION_MAX_DB - GLA3A_PEAK_REDUCTION_MIN_DB));
+        self->current_threshold_linear = db_to_linear(self->current_threshold_db);
+    }
+
+    if (params_changed(ps, PARAMS_MAKE_UP)) {
+        self->make_up_gain_linear = db_to_linear(params_get(ps, GLA3A_GAIN) * GLA3A_GAIN_MAX_DB);
+    }
+
+    // --- Limiter Lookahead ---
+    // La finestra (e la latenza) cambia solo entrando in Limit o muovendo il lookahead
+    if (params_changed(ps, PARAMS_LIMITER)) {
+        const GLA3A_RatioMode ratio_mode = ratio_mode_from_port(params_get(ps, GLA3A_RATIO_MODE));
+        const uint32_t length = limiter_length_from_ms(params_get(ps, GLA3A_LOOKAHEAD), self->samplerate);
+        if (ratio_mode == GLA3A_RATIO_LIMIT &&
+            (self->ratio_mode != GLA3A_RATIO_LIMIT || length != self->limiter.length)) {
+            limiter_set_length(&self->limiter, length);
+        }
+    }
+
+    // --- Ratio, Filtri Sidechain e Crossover (progetto costoso) ---
+    design_update(self);
+
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    // --- Filtri Sidechain (SVF) ---
+    // Solo i target: il blocco ci arriva con il glide. Un filtro spento non avanza, quindi salta
+    // subito al target e si riaccende dove l'utente l'ha lasciato.
+    if (params_changed(ps, PARAMS_SC_LP_ON)) {
+        svf_bank_set_target(&self->sc_lp_svf, params_get(ps, GLA3A_SC_LP_FREQ), params_get(ps, GLA3A_SC_LP_Q), self->samplerate);
+        if (params_get(ps, GLA3A_SC_LP_ON) <= 0.5f) svf_bank_snap(&self->sc_lp_svf);
+    }
+    if (params_changed(ps, PARAMS_SC_HP_ON)) {
+        svf_bank_set_target(&self->sc_hp_svf, params_get(ps, GLA3A_SC_HP_FREQ), params_get(ps, GLA3A_SC_HP_Q), self->samplerate);
+        if (params_get(ps, GLA3A_SC_HP_ON) <= 0.5f) svf_bank_snap(&self->sc_hp_svf);
+    }
+#endif
+
+    // --- Soglie per Banda (modalità multibanda) ---
+    if (params_changed(ps, PARAMS_THRESHOLD | PARAMS_BAND_OFFSETS)) {
+        for (int k = 0; k < MULTIBAND_MAX_BANDS; ++k) {
+            self->band_threshold_db[k] = self->current_threshold_db + params_get(ps, GLA3A_BAND_1_OFFSET + k);
+        }
+    }
+
+    // --- Cambio di Fattore/Modalità di Oversampling ---
+    // I kernel sono già progettati: si aggiorna solo la cascata attiva e si azzerano gli stati.
+    if (params_changed(ps, PARAMS_OVERSAMPLING)) {
+        const int os_factor = oversampling_factor_from_port(params_get(ps, GLA3A_OVERSAMPLING));
+        const int os_mode = (params_get(ps, GLA3A_OS_MODE) > 0.5f) ? OS_MODE_LOW_LATENCY : OS_MODE_LINEAR_PHASE;
+        if (os_factor != self->os_factor || os_mode != self->os_mode) {
+            self->os_factor = os_factor;
+            self->os_mode = os_mode;
+            self->oversampled_samplerate = self->samplerate * os_factor;
+            oversampler_configure(&self->oversampler, os_factor, os_mode);
+        }
+    }
+
+    params_clear(ps);
+}
+
+// --- Banco di Preset ---
+// Gli slot partono dai preset di fabbrica e si sovrascrivono con presetStore; il banco si salva
+// nello stato. Ogni slot si progetta quando entra nel banco (instantiate, restore, o nel worker
+// dopo presetStore): richiamarlo nel run copia valori e coefficienti, senza calcoli, quindi un
+// cambio di scena vale dal campione dell'evento.
+
+typedef struct {
+    GLA3A_PortIndex port;
+    float value;
+} PresetSetting;
+
+typedef struct {
+    const PresetSetting* settings;
+    size_t num_settings;
+} FactoryPreset;
 
+// Sopra i default di gla3a.ttl (un preset senza impostazioni è il default)
+static const PresetSetting preset_voice[] = {
+    { GLA3A_PEAK_REDUCTION, 0.5f }, { GLA3A_GAIN, 0.2f }, { GLA3A_SC_HP_ON, 1.0f }, { GLA3A_SC_HP_FREQ, 120.0f },
+};
+static const PresetSetting preset_drum_bus[] = {
+    { GLA3A_PEAK_REDUCTION, 0.6f }, { GLA3A_GAIN, 0.3f }, { GLA3A_RATIO_MODE, GLA3A_RATIO_6_TO_1 },
+    { GLA3A_STEREO_LINK, GLA3A_LINK_LINKED }, { GLA3A_SC_HP_ON, 1.0f }, { GLA3A_SC_HP_FREQ, 80.0f },
+};
+static const PresetSetting preset_bass[] = {
+    { GLA3A_PEAK_REDUCTION, 0.55f }, { GLA3A_GAIN, 0.25f }, { GLA3A_RATIO_MODE, GLA3A_RATIO_9_TO_1 },
+    { GLA3A_SC_LP_ON, 1.0f }, { GLA3A_SC_LP_FREQ, 1500.0f },
+};
+static const PresetSetting preset_multiband_master[] = {
+    { GLA3A_PEAK_REDUCTION, 0.4f }, { GLA3A_GAIN, 0.15f }, { GLA3A_BANDS, 3.0f }, { GLA3A_CROSSOVER_1, 150.0f },
+    { GLA3A_CROSSOVER_2, 2500.0f }, { GLA3A_STEREO_LINK, GLA3A_LINK_LINKED },
+};
+static const PresetSetting preset_limit[] = {
+    { GLA3A_PEAK_REDUCTION, 0.8f }, { GLA3A_RATIO_MODE, GLA3A_RATIO_LIMIT }, { GLA3A_LOOKAHEAD, 3.0f },
+    { GLA3A_STEREO_LINK, GLA3A_LINK_LINKED },
+};
+static const PresetSetting preset_light_blend[] = {
+    { GLA3A_PEAK_REDUCTION, 0.3f }, { GLA3A_GAIN, 0.1f }, { GLA3A_STEREO_LINK, GLA3A_LINK_BLEND },
+    { GLA3A_LINK_AMOUNT, 0.3f },
+};
+
+// La lunghezza di ogni lista viene dal suo sizeof: nessun terminatore, ogni valore è impostabile
+#define FACTORY_PRESET(list) { list, sizeof(list) / sizeof(list[0]) }
+
+static const FactoryPreset factory_presets[GLA3A_NUM_PRESETS] = {
+    { NULL, 0 }, // Default
+    FACTORY_PRESET(preset_voice),
+    FACTORY_PRESET(preset_drum_bus),
+    FACTORY_PRESET(preset_bass),
+    FACTORY_PRESET(preset_multiband_master),
+    FACTORY_PRESET(preset_limit),
+    FACTORY_PRESET(preset_light_blend),
+    { NULL, 0 }, // Default
+};
+
+// Progetta tutte le grandezze derivate di uno slot (fuori dal thread audio)
+static void preset_design(PresetSlot* slot, double samplerate) {
+    gain_computer_init(&slot->design.gain_computer);
+    crossover_init(&slot->design.crossover);
+    design_coeffs(&slot->design, slot->value, PARAMS_DESIGN, samplerate);
+    slot->ready = true;
+}
+
+static void preset_bank_init(Gla3a* self) {
+    for (int p = 0; p < GLA3A_NUM_PRESETS; ++p) {
+        PresetSlot* slot = &self->presets[p];
+        for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+            slot->value[gla3a_parameters[i].port] = gla3a_parameters[i].default_value;
+        }
+        for (size_t k = 0; k < factory_presets[p].num_settings; ++k) {
+            slot->value[factory_presets[p].settings[k].port] = factory_presets[p].settings[k].value;
+        }
+        preset_design(slot, self->samplerate);
+    }
+}
+
+// Da qui in poi le grandezze costose dell'istanza sono quelle di 'd', progettate per 'value' (preset
+// o restore): il progetto in volo, fatto con i valori vecchi, non si applica, e al prossimo
+// design_update() si progettano solo gli ingressi che nel frattempo hanno un valore diverso.
+static void design_preload(Gla3a* self, const CoeffDesign* d, const float* value) {
+    design_apply(self, d);
+    memcpy(self->preload_value, value, sizeof(self->preload_value));
+    self->design_preloaded = PARAMS_DESIGN;
+    self->design_pending = 0;
+    if (self->design_in_flight && self->design_slot < 0) self->design_discard = true;
+}
+
+// Richiama uno slot (thread audio, al timestamp del patch:Set): i parametri prendono i valori dello
+// slot come da un patch:Set; i coefficienti sono già pronti, salvo uno slot ancora nel worker,
+// che si progetta come un cambio normale
+static void preset_recall(Gla3a* self, int index) {
+    const PresetSlot* slot = &self->presets[index];
+    for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+        params_set(&self->params, gla3a_parameters[i].port, slot->value[gla3a_parameters[i].port]);
+    }
+    if (slot->ready) design_preload(self, &slot->design, slot->value);
+}
+
+// Salva nello slot i valori correnti (thread audio): il progetto va al worker, o si fa subito senza
+static void preset_store(Gla3a* self, int index) {
+    PresetSlot* slot = &self->presets[index];
+    memcpy(slot->value, self->params.value, sizeof(slot->value));
+    if (!self->schedule) {
+        design_coeffs(&slot->design, slot->value, PARAMS_DESIGN, self->samplerate);
+        slot->ready = true;
+        return;
+    }
+    slot->ready = false;
+    self->preset_store_pending |= 1u << index;
+}
+
+// Crea un'istanza con i buffer per blocchi fino a 'block_size' campioni (0 = dalle opzioni
+// dell'host, bufsz:maxBlockLength). La usano instantiate() e gla3a_batch_new().
+static Gla3a* create_instance(double samplerate, const LV2_Feature* const* features, uint32_t block_size) {
+    // Allineamento a 64 byte: la struct contiene stati vettoriali (v4sf)
+    Gla3a* self = NULL;
+    if (posix_memalign((void**)&self, 64, sizeof(Gla3a)) != 0) return NULL;
+    memset(self, 0, sizeof(Gla3a));
+
+    self->isa = isa_select();
     self->samplerate = samplerate;
-    self->oversampled_samplerate = samplerate * UPSAMPLE_FACTOR; // Nuovo
+    self->os_factor = 4; // Come il comportamento storico (4x), finché la porta non dice altro
+    self->os_mode = OS_MODE_LINEAR_PHASE;
+    self->oversampled_samplerate = samplerate * self->os_factor;
 
+    const LV2_Options_Option* options = NULL;
     for (int i = 0; features[i]; ++i) {
         if (!strcmp(features[i]->URI, LV2_LOG__log)) {
             self->log = (LV2_Log_Log*)features[i]->data;
+        } else if (!strcmp(features[i]->URI, LV2_URID__map)) {
+            self->map = (LV2_URID_Map*)features[i]->data;
+        } else if (!strcmp(features[i]->URI, LV2_OPTIONS__options)) {
+            options = (const LV2_Options_Option*)features[i]->data;
+        } else if (!strcmp(features[i]->URI, LV2_WORKER__schedule)) {
+            self->schedule = (LV2_Worker_Schedule*)features[i]->data;
         }
     }
-    lv2_log_logger_init(&self->logger, NULL, self->log);
+    lv2_log_logger_init(&self->logger, self->map, self->log);
+
+    // URID per gli eventi patch:Set (senza urid:map la porta atom viene ignorata)
+    if (self->map) {
+        LV2_URID_Map* map = self->map;
+        self->uris.atom_Object = map->map(map->handle, LV2_ATOM__Object);
+        self->uris.atom_Blank = map->map(map->handle, LV2_ATOM__Blank);
+        self->uris.atom_Float = map->map(map->handle, LV2_ATOM__Float);
+        self->uris.atom_Double = map->map(map->handle, LV2_ATOM__Double);
+        self->uris.atom_Int = map->map(map->handle, LV2_ATOM__Int);
+        self->uris.atom_Long = map->map(map->handle, LV2_ATOM__Long);
+        self->uris.atom_Bool = map->map(map->handle, LV2_ATOM__Bool);
+        self->uris.atom_URID = map->map(map->handle, LV2_ATOM__URID);
+        self->uris.atom_Vector = map->map(map->handle, LV2_ATOM__Vector);
+        self->uris.patch_Set = map->map(map->handle, LV2_PATCH__Set);
+        self->uris.patch_property = map->map(map->handle, LV2_PATCH__property);
+        self->uris.patch_value = map->map(map->handle, LV2_PATCH__value);
+        self->uris.preset = map->map(map->handle, GLA3A_PRESET_URI);
+        self->uris.preset_store = map->map(map->handle, GLA3A_PRESET_STORE_URI);
+        self->uris.preset_bank = map->map(map->handle, GLA3A_PRESET_BANK_URI);
+        self->uris.meter_frame = map->map(map->handle, GLA3A_METER_FRAME_URI);
+        self->uris.meter_values = map->map(map->handle, GLA3A_METER_VALUES_URI);
+        lv2_atom_forge_init(&self->forge, map);
+        for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+            self->param_urids[i] = map->map(map->handle, gla3a_parameters[i].uri);
+        }
+    }
+
+    // Tutti i parametri partono "dirty": la prima run calcola ogni grandezza derivata
+    params_init(&self->params);
 
     // Inizializzazione variabili di stato
     self->detector_envelope_M = 0.0f;
     self->detector_envelope_S = 0.0f;
     self->current_gain_M = 1.0f;
     self->current_gain_S = 1.0f;
-
-    // Inizializzazione filtri biquad sidechain
+    gain_computer_init(&self->gain_computer);
+    crossover_init(&self->crossover);
+    gain_computer_init(&self->design.gain_computer);
+    crossover_init(&self->design.crossover);
+    self->design_inline = true;
+    self->design_slot = -1;
+    preset_bank_init(self);
+    band_dynamics_reset(&self->band_dynamics_M);
+    band_dynamics_reset(&self->band_dynamics_S);
+
+    // Inizializzazione filtri sidechain
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    svf_bank_init(&self->sc_lp_svf, NUM_BIQUADS_FOR_6TH_ORDER, self->samplerate);
+    svf_bank_init(&self->sc_hp_svf, NUM_BIQUADS_FOR_6TH_ORDER, self->samplerate);
+#else
     for(int i = 0; i < NUM_BIQUADS_FOR_6TH_ORDER; ++i) {
         biquad_init(&self->sc_lp_filters_M[i]);
         biquad_init(&self->sc_hp_filters_M[i]);
         biquad_init(&self->sc_lp_filters_S[i]);
         biquad_init(&self->sc_hp_filters_S[i]);
     }
+    biquad_bank_init(&self->sc_lp_bank, NUM_BIQUADS_FOR_6TH_ORDER);
+    biquad_bank_init(&self->sc_hp_bank, NUM_BIQUADS_FOR_6TH_ORDER);
+#endif
 
-    // Inizializzazione filtri biquad per oversampling/downsampling // Nuovo
-    for(int i = 0; i < NUM_BIQUADS_FOR_OS_FILTER; ++i) {
-        biquad_init(&self->upsample_lp_filters_M[i]);
-        biquad_init(&self->upsample_lp_filters_S[i]);
-        biquad_init(&self->downsample_lp_filters_M[i]);
-        biquad_init(&self->downsample_lp_filters_S[i]);
-    }
+    // Progettazione dei kernel di oversampling (FIR e IIR half-band, una volta sola)
+    oversampler_init(&self->oversampler);
+    oversampler_configure(&self->oversampler, self->os_factor, self->os_mode);
 
+    // Costanti che dipendono solo dalla frequenza di campionamento
     self->rms_meter_alpha = 1.0f - expf(-1.0f / (self->samplerate * (RMS_METER_SMOOTH_MS / 1000.0f)));
+    self->gain_smooth_alpha = 1.0f - real_exp((FilterReal)(-1.0f / (self->samplerate * 0.001f))); // Molto veloce
+    self->final_soft_clip_threshold_linear = db_to_linear(FINAL_SOFT_CLIP_THRESHOLD_DB);
+    self->meter_period = (uint32_t)fmax(1.0, round(self->samplerate / GLA3A_METER_RATE_HZ));
 
-    // Inizializza cache per i parametri dei filtri con valori "impossibili" per forzare il primo calcolo
-    self->last_sc_lp_freq = -1.0f;
-    self->last_sc_lp_q = -1.0f;
-    self->last_sc_hp_freq = -1.0f;
-    self->last_sc_hp_q = -1.0f;
-
-    // Alloca buffer per oversampling // Nuovo
-    self->oversample_buffer_size = 1024 * UPSAMPLE_FACTOR; // Max block size * OS_FACTOR
-    self->oversample_buffer_M = (float*)calloc(self->oversample_buffer_size, sizeof(float));
-    self->oversample_buffer_S = (float*)calloc(self->oversample_buffer_size, sizeof(float));
-
-    if (!self->oversample_buffer_M || !self->oversample_buffer_S) {
-        free(self->oversample_buffer_M);
-        free(self->oversample_buffer_S);
+    // Alloca tutti i buffer di lavoro (l'unica allocazione dopo la struct)
+    if (!allocate_buffers(self, block_size ? block_size : block_size_from_options(options, self->map))) {
         free(self);
         return NULL;
     }
     
-    return (LV2_Handle)self;
+    return self;
+}
+
+// Funzione di istanziazione del plugin
+static LV2_Handle
+instantiate(const LV2_Descriptor* descriptor,
+            double                    samplerate,
+            const char* bundle_path,
+            const LV2_Feature* const* features) {
+    return (LV2_Handle)create_instance(samplerate, features, 0);
 }
 
 // Funzione per connettere le porte
@@ -310,24 +1067,43 @@ connect_port(LV2_Handle instance, uint32_t port, void* data_location) {
     Gla3a* self = (Gla3a*)instance;
 
     switch ((GLA3A_PortIndex)port) {
-        case GLA3A_PEAK_REDUCTION:     self->peak_reduction_ptr = (float*)data_location; break;
-        case GLA3A_GAIN:               self->gain_ptr = (float*)data_location; break;
-        case GLA3A_METER:              self->meter_ptr = (float*)data_location; break;
-        case GLA3A_BYPASS:             self->bypass_ptr = (float*)data_location; break;
-        case GLA3A_MS_MODE_ACTIVE:     self->ms_mode_active_ptr = (float*)data_location; break;
-        case GLA3A_RATIO_MODE:         self->ratio_mode_ptr = (float*)data_location; break;
-        case GLA3A_SC_LP_ON:           self->sc_lp_on_ptr = (float*)data_location; break;
-        case GLA3A_SC_LP_FREQ:         self->sc_lp_freq_ptr = (float*)data_location; break;
-        case GLA3A_SC_LP_Q:            self->sc_lp_q_ptr = (float*)data_location; break;
-        case GLA3A_SC_HP_ON:           self->sc_hp_on_ptr = (float*)data_location; break;
-        case GLA3A_SC_HP_FREQ:         self->sc_hp_freq_ptr = (float*)data_location; break;
-        case GLA3A_SC_HP_Q:            self->sc_hp_q_ptr = (float*)data_location; break;
+        case GLA3A_PEAK_REDUCTION:
+        case GLA3A_GAIN:
+        case GLA3A_METER:
+        case GLA3A_BYPASS:
+        case GLA3A_MS_MODE_ACTIVE:
+        case GLA3A_RATIO_MODE:
+        case GLA3A_SC_LP_ON:
+        case GLA3A_SC_LP_FREQ:
+        case GLA3A_SC_LP_Q:
+        case GLA3A_SC_HP_ON:
+        case GLA3A_SC_HP_FREQ:
+        case GLA3A_SC_HP_Q:
+        case GLA3A_OVERSAMPLING:
+        case GLA3A_OS_MODE:
+        case GLA3A_LOOKAHEAD:
+        case GLA3A_BANDS:
+        case GLA3A_CROSSOVER_1:
+        case GLA3A_CROSSOVER_2:
+        case GLA3A_CROSSOVER_3:
+        case GLA3A_BAND_1_OFFSET:
+        case GLA3A_BAND_2_OFFSET:
+        case GLA3A_BAND_3_OFFSET:
+        case GLA3A_BAND_4_OFFSET:
+        case GLA3A_STEREO_LINK:
+        case GLA3A_LINK_DETECTOR:
+        case GLA3A_LINK_AMOUNT:
+            params_connect(&self->params, port, (const float*)data_location);
+            break;
         case GLA3A_OUTPUT_RMS:         self->output_rms_ptr = (float*)data_location; break;
         case GLA3A_GAIN_REDUCTION_METER: self->gain_reduction_meter_ptr = (float*)data_location; break;
         case GLA3A_AUDIO_IN_L:         self->audio_in_l_ptr = (const float*)data_location; break;
         case GLA3A_AUDIO_IN_R:         self->audio_in_r_ptr = (const float*)data_location; break;
         case GLA3A_AUDIO_OUT_L:        self->audio_out_l_ptr = (float*)data_location; break;
         case GLA3A_AUDIO_OUT_R:        self->audio_out_r_ptr = (float*)data_location; break;
+        case GLA3A_LATENCY:            self->latency_ptr = (float*)data_location; break;
+        case GLA3A_CONTROL:            self->control_ptr = (const LV2_Atom_Sequence*)data_location; break;
+        case GLA3A_NOTIFY:             self->notify_ptr = (LV2_Atom_Sequence*)data_location; break;
     }
 }
 
@@ -341,345 +1117,867 @@ activate(LV2_Handle instance) {
     self->current_gain_S = 1.0f;
     self->current_output_rms_level = db_to_linear(-60.0f);
     self->current_gain_reduction_display = 0.0f;
-
-    // Reinitalizza stati interni dei filtri biquad sidechain
+    self->meter_count = 0;
+    memset(&self->meter_in, 0, sizeof(self->meter_in));
+    memset(&self->meter_out, 0, sizeof(self->meter_out));
+    self->meter_gain = 1.0f;
+    self->idle = false;
+    memset(self->bypass_delay_l, 0, sizeof(float) * (self->bypass_delay_mask + 1));
+    memset(self->bypass_delay_r, 0, sizeof(float) * (self->bypass_delay_mask + 1));
+    self->bypass_delay_pos = 0;
+
+    // Reinitalizza stati interni dei filtri sidechain (gli SVF ripartono dal target, senza glide)
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    svf_bank_reset(&self->sc_lp_svf);
+    svf_bank_reset(&self->sc_hp_svf);
+#else
     for(int i = 0; i < NUM_BIQUADS_FOR_6TH_ORDER; ++i) {
-        biquad_init(&self->sc_lp_filters_M[i]);
-        biquad_init(&self->sc_hp_filters_M[i]);
-        biquad_init(&self->sc_lp_filters_S[i]);
-        biquad_init(&self->sc_hp_filters_S[i]);
+        biquad_reset(&self->sc_lp_filters_M[i]);
+        biquad_reset(&self->sc_hp_filters_M[i]);
+        biquad_reset(&self->sc_lp_filters_S[i]);
+        biquad_reset(&self->sc_hp_filters_S[i]);
     }
+    biquad_bank_reset(&self->sc_lp_bank);
+    biquad_bank_reset(&self->sc_hp_bank);
+#endif
+
+    // Reinitalizza stati interni dei filtri di oversampling/downsampling
+    oversampler_reset(&self->oversampler);
+    limiter_reset(&self->limiter);
+    crossover_reset(&self->crossover);
+    band_dynamics_reset(&self->band_dynamics_M);
+    band_dynamics_reset(&self->band_dynamics_S);
+
+    // Forza il ricalcolo dei coefficienti alla prossima run (subito, senza aspettare il worker).
+    // Un progetto precaricato dal restore resta: i suoi ingressi non si riprogettano se non cambiano.
+    params_invalidate(&self->params);
+    self->design_inline = true;
+}
 
-    // Reinitalizza stati interni dei filtri di oversampling/downsampling // Nuovo
-    for(int i = 0; i < NUM_BIQUADS_FOR_OS_FILTER; ++i) {
-        biquad_init(&self->upsample_lp_filters_M[i]);
-        biquad_init(&self->upsample_lp_filters_S[i]);
-        biquad_init(&self->downsample_lp_filters_M[i]);
-        biquad_init(&self->downsample_lp_filters_S[i]);
+// Filtri sidechain (6° ordine) sul segnale del detector. sc_S == NULL: detector collegato, un canale solo.
+// LP/HP: filtro acceso o spento per il kernel (gla3a_kernels.h), o KERNEL_RUNTIME per leggerlo dalle porte.
+template <int LP, int HP>
+static void
+sidechain_filter(Gla3a* self, DetectorReal* sc_M, DetectorReal* sc_S, uint32_t n) {
+    const bool lp_on = KERNEL_FLAG(LP, params_get(&self->params, GLA3A_SC_LP_ON) > 0.5f);
+    const bool hp_on = KERNEL_FLAG(HP, params_get(&self->params, GLA3A_SC_HP_ON) > 0.5f);
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    if (LP != KERNEL_RUNTIME && HP != KERNEL_RUNTIME) {
+        if (lp_on || hp_on) {
+            svf_bank_process_chain<LP ? NUM_BIQUADS_FOR_6TH_ORDER : 0, HP ? NUM_BIQUADS_FOR_6TH_ORDER : 0>(
+                &self->sc_lp_svf, &self->sc_hp_svf, sc_M, sc_S, n);
+        }
+        return;
     }
-
-    // Forza il ricalcolo dei coefficienti alla prossima run
-    self->last_sc_lp_freq = -1.0f;
-    self->last_sc_lp_q = -1.0f;
-    self->last_sc_hp_freq = -1.0f;
-    self->last_sc_hp_q = -1.0f;
+    if (lp_on) svf_bank_process<SVF_LOWPASS>(&self->sc_lp_svf, sc_M, sc_S, n);
+    if (hp_on) svf_bank_process<SVF_HIGHPASS>(&self->sc_hp_svf, sc_M, sc_S, n);
+#elif defined(GLA3A_SCALAR_BIQUADS)
+    for (uint32_t i = 0; i < n; ++i) {
+        if (lp_on) {
+            for(int k = 0; k < NUM_BIQUADS_FOR_6TH_ORDER; ++k) {
+                sc_M[i] = biquad_process(&self->sc_lp_filters_M[k], sc_M[i]);
+                if (sc_S) sc_S[i] = biquad_process(&self->sc_lp_filters_S[k], sc_S[i]);
+            }
+        }
+        if (hp_on) {
+            for(int k = 0; k < NUM_BIQUADS_FOR_6TH_ORDER; ++k) {
+                sc_M[i] = biquad_process(&self->sc_hp_filters_M[k], sc_M[i]);
+                if (sc_S) sc_S[i] = biquad_process(&self->sc_hp_filters_S[k], sc_S[i]);
+            }
+        }
+    }
+#else
+    if (LP != KERNEL_RUNTIME && HP != KERNEL_RUNTIME) {
+        // Le cascate accese in un passo solo, con gli stadi noti a compilazione
+        if (lp_on || hp_on) {
+            biquad_bank_process_chain<LP ? NUM_BIQUADS_FOR_6TH_ORDER : 0, HP ? NUM_BIQUADS_FOR_6TH_ORDER : 0>(
+                &self->sc_lp_bank, &self->sc_hp_bank, sc_M, sc_S, n);
+        }
+        return;
+    }
+    if (lp_on) {
+        if (sc_S) biquad_bank_process(&self->sc_lp_bank, sc_M, sc_S, n);
+        else      biquad_bank_process_mono(&self->sc_lp_bank, sc_M, n);
+    }
+    if (hp_on) {
+        if (sc_S) biquad_bank_process(&self->sc_hp_bank, sc_M, sc_S, n);
+        else      biquad_bank_process_mono(&self->sc_hp_bank, sc_M, n);
+    }
+#endif
 }
 
-// Funzione di elaborazione audio (run)
+// Azzera gli stati ricorsivi decaduti verso i denormali (dopo ogni blocco, vedi gla3a_denormal.h).
+// Gli stati sotto soglia non contribuiscono all'uscita: il risultato non cambia.
 static void
-run(LV2_Handle instance, uint32_t sample_count) {
-    Gla3a* self = (Gla3a*)instance;
-
-    const float* in_l = self->audio_in_l_ptr;
-    const float* in_r = self->audio_in_r_ptr;
-    float* out_l = self->audio_out_l_ptr;
-    float* out_r = self->audio_out_r_ptr;
+flush_denormal_state(Gla3a* self) {
+    self->detector_envelope_M = flush_denormal(self->detector_envelope_M);
+    self->detector_envelope_S = flush_denormal(self->detector_envelope_S);
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    svf_bank_flush_denormals(&self->sc_lp_svf);
+    svf_bank_flush_denormals(&self->sc_hp_svf);
+#elif defined(GLA3A_SCALAR_BIQUADS)
+    for (int k = 0; k < NUM_BIQUADS_FOR_6TH_ORDER; ++k) {
+        biquad_flush_denormals(&self->sc_lp_filters_M[k]);
+        biquad_flush_denormals(&self->sc_lp_filters_S[k]);
+        biquad_flush_denormals(&self->sc_hp_filters_M[k]);
+        biquad_flush_denormals(&self->sc_hp_filters_S[k]);
+    }
+#else
+    biquad_bank_flush_denormals(&self->sc_lp_bank);
+    biquad_bank_flush_denormals(&self->sc_hp_bank);
+#endif
+    oversampler_flush_denormals(&self->oversampler);
+    crossover_flush_denormals(&self->crossover);
+    band_dynamics_flush_denormals(&self->band_dynamics_M);
+    band_dynamics_flush_denormals(&self->band_dynamics_S);
+}
 
-    const float bypass = *self->bypass_ptr;
-    const float ms_mode_active = *self->ms_mode_active_ptr;
-    const float ratio_mode = *self->ratio_mode_ptr;
+// --- Riposo (Silenzio a Stato Fermo) ---
+// Un blocco di silenzio che parte con filtri, storie ed envelope tutti a zero li lascia a zero;
+// se lascia invariati anche i guadagni, lo stato è un punto fisso: ogni altro blocco di silenzio
+// darebbe uscita nulla e lo stesso stato. Da lì run_segment() scrive solo zeri, finché non arriva
+// un campione non nullo o cambia un parametro. Saltare è esatto: al ritorno del segnale lo stato
+// è quello che avrebbe avuto un'elaborazione continua, senza nulla da riallineare o resettare.
+// Dopo un segnale il riposo arriva quando gli envelope scendono sotto la soglia di flush
+// (gla3a_denormal.h): qualche secondo con i rilasci lunghi.
 
-    // Sidechain filter controls
-    const float sc_lp_on = *self->sc_lp_on_ptr;
-    const float sc_lp_freq = *self->sc_lp_freq_ptr;
-    const float sc_lp_q = *self->sc_lp_q_ptr;
-    const float sc_hp_on = *self->sc_hp_on_ptr;
-    const float sc_hp_freq = *self->sc_hp_freq_ptr;
-    const float sc_hp_q = *self->sc_hp_q_ptr;
+// Guadagni che il silenzio fa ancora convergere (lo smoothing si ferma sul suo punto fisso)
+typedef struct {
+    FilterReal gain_M;
+    FilterReal gain_S;
+    v4sf band_gain_M;
+    v4sf band_gain_S;
+    float limiter_gain;
+} RestGains;
 
-    // --- Calcolo Parametri di Controllo del Compressore ---
-    const float current_threshold_db = PEAK_REDUCTION_MIN_DB + (*self->peak_reduction_ptr * (PEAK_REDUCTION_MAX_DB - PEAK_REDUCTION_MIN_DB));
-    const float current_threshold_linear = db_to_linear(current_threshold_db);
+static void
+rest_gains_save(const Gla3a* self, RestGains* g) {
+    g->gain_M = self->current_gain_M;
+    g->gain_S = self->current_gain_S;
+    g->band_gain_M = self->band_dynamics_M.gain;
+    g->band_gain_S = self->band_dynamics_S.gain;
+    g->limiter_gain = self->limiter.gain;
+}
 
-    const float make_up_gain_db = *self->gain_ptr * GAIN_MAX_DB;
-    const float make_up_gain_linear = db_to_linear(make_up_gain_db);
+static bool
+rest_gains_unchanged(const Gla3a* self, const RestGains* g) {
+    v4sf moved_M = self->band_dynamics_M.gain - g->band_gain_M;
+    v4sf moved_S = self->band_dynamics_S.gain - g->band_gain_S;
+    return g->gain_M == self->current_gain_M && g->gain_S == self->current_gain_S &&
+           v4sf_all_zero(&moved_M, 1) && v4sf_all_zero(&moved_S, 1) && g->limiter_gain == self->limiter.gain;
+}
 
-    const float final_soft_clip_threshold_linear = db_to_linear(FINAL_SOFT_CLIP_THRESHOLD_DB);
+// Campioni tutti nulli (anche -0.0); si ferma al primo non nullo, quindi costa poco col segnale
+static bool
+samples_are_zero(const float* left, const float* right, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        if (left[i] != 0.0f || right[i] != 0.0f) return false;
+    }
+    return true;
+}
 
-    // --- Parametri di Attacco/Rilascio e Ratio in base alla modalità ---
-    float current_ratio;
-    float current_detector_attack_ms;
-    float current_detector_release_ms;
-
-    switch ((GLA3A_RatioMode)ratio_mode) {
-        case GLA3A_RATIO_3_TO_1:
-            current_ratio = 3.0f;
-            current_detector_attack_ms = 10.0f; // Veloce
-            current_detector_release_ms = 200.0f; // Lento
-            break;
-        case GLA3A_RATIO_6_TO_1:
-            current_ratio = 6.0f;
-            current_detector_attack_ms = 5.0f; // Più veloce
-            current_detector_release_ms = 100.0f; // Medio
-            break;
-        case GLA3A_RATIO_9_TO_1:
-            current_ratio = 9.0f;
-            current_detector_attack_ms = 3.0f; // Ancora più veloce
-            current_detector_release_ms = 50.0f; // Più veloce
-            break;
-        case GLA3A_RATIO_LIMIT: // Comportamento da Limiter
-            current_ratio = 20.0f; // Ratio molto alta, quasi infinita
-            current_detector_attack_ms = 1.0f; // Molto veloce
-            current_detector_release_ms = 20.0f; // Veloce
-            break;
+// Vero se tutto lo stato che la modalità corrente fa avanzare è a zero.
+// I filtri spenti non avanzano: il loro stato non conta.
+static bool
+state_is_at_rest(const Gla3a* self) {
+    if (!oversampler_is_silent(&self->oversampler)) return false;
+    if (self->ratio_mode == GLA3A_RATIO_LIMIT) return limiter_is_silent(&self->limiter);
+    if (self->crossover.num_bands > 1) {
+        return v4sf_all_zero(&self->band_dynamics_M.envelope, 1) && v4sf_all_zero(&self->band_dynamics_S.envelope, 1) &&
+               crossover_is_silent(&self->crossover);
     }
+    if (self->detector_envelope_M != 0.0f || self->detector_envelope_S != 0.0f) return false;
+
+    const bool lp_on = params_get(&self->params, GLA3A_SC_LP_ON) > 0.5f;
+    const bool hp_on = params_get(&self->params, GLA3A_SC_HP_ON) > 0.5f;
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    return (!lp_on || svf_bank_is_silent(&self->sc_lp_svf)) && (!hp_on || svf_bank_is_silent(&self->sc_hp_svf));
+#elif defined(GLA3A_SCALAR_BIQUADS)
+    for (int k = 0; k < NUM_BIQUADS_FOR_6TH_ORDER; ++k) {
+        if (lp_on && (self->sc_lp_filters_M[k].z1 != 0.0f || self->sc_lp_filters_M[k].z2 != 0.0f ||
+                      self->sc_lp_filters_S[k].z1 != 0.0f || self->sc_lp_filters_S[k].z2 != 0.0f)) return false;
+        if (hp_on && (self->sc_hp_filters_M[k].z1 != 0.0f || self->sc_hp_filters_M[k].z2 != 0.0f ||
+                      self->sc_hp_filters_S[k].z1 != 0.0f || self->sc_hp_filters_S[k].z2 != 0.0f)) return false;
+    }
+    return true;
+#else
+    return (!lp_on || biquad_bank_is_silent(&self->sc_lp_bank)) && (!hp_on || biquad_bank_is_silent(&self->sc_hp_bank));
+#endif
+}
 
-    // Ricomputa gli alpha in base ai nuovi tempi
-    self->detector_attack_alpha = 1.0f - expf(-1.0f / (self->samplerate * (current_detector_attack_ms / 1000.0f)));
-    self->detector_release_alpha = 1.0f - expf(-1.0f / (self->samplerate * (current_detector_release_ms / 1000.0f)));
-    self->gain_smooth_alpha = 1.0f - expf(-1.0f / (self->samplerate * 0.001f)); // Molto veloce
+// Ingresso del blocco, fino al segnale decimato in base_buffer_M/S (M/S o L/R).
+// MS e STAGES (stadi di oversampling) come in process_block_kernel().
+template <int MS, int STAGES>
+static void
+process_front_kernel(Gla3a* self, const float* in_l, const float* in_r, uint32_t n) {
+    float* audio_M = self->base_buffer_M;
+    float* audio_S = self->base_buffer_S;
+
+    // --- Conversione M/S (o L/R) alla Frequenza Campionamento Originale ---
+    stage_encode(in_l, in_r, audio_M, audio_S, n, KERNEL_FLAG(MS, params_get(&self->params, GLA3A_MS_MODE_ACTIVE) > 0.5f));
+
+    // --- Interpolazione Polifase ---
+    const uint32_t os_n = n << KERNEL_PARAM(STAGES, self->oversampler.num_stages);
+    oversampler_upsample<STAGES>(&self->oversampler, audio_M, audio_S,
+                                 self->oversample_buffer_M, self->oversample_buffer_S,
+                                 self->oversample_scratch_M, self->oversample_scratch_S, n);
+
+    // --- Saturazione J-FET (applicata ad alta frequenza campionamento) ---
+    stage_saturate(self->oversample_buffer_M, os_n, JF_K_FACTOR, JF_SATURATION_THRESHOLD, JF_DRY_WET_MIX);
+    stage_saturate(self->oversample_buffer_S, os_n, JF_K_FACTOR, JF_SATURATION_THRESHOLD, JF_DRY_WET_MIX);
+
+    // --- Decimazione Polifase (filtro anti-aliasing prima di scartare i campioni) ---
+    oversampler_downsample<STAGES>(&self->oversampler, self->oversample_buffer_M, self->oversample_buffer_S,
+                                   audio_M, audio_S, n);
+}
 
+// Uscita del blocco compresso (compressore a banda singola o multibanda): base_buffer_M/S -> L/R
+template <int MS = KERNEL_RUNTIME>
+static void
+process_back(Gla3a* self, float* out_l, float* out_r, uint32_t n) {
+    // --- Decodifica M/S in L/R (a valle della compressione/distorsione) ---
+    stage_decode(self->base_buffer_M, self->base_buffer_S, out_l, out_r, n,
+                 KERNEL_FLAG(MS, params_get(&self->params, GLA3A_MS_MODE_ACTIVE) > 0.5f));
+
+    // --- Soft-Clipping Finale (Limiter di Sicurezza in Output) ---
+    stage_clip(out_l, n, self->final_soft_clip_threshold_linear, FINAL_SOFT_CLIP_AMOUNT);
+    stage_clip(out_r, n, self->final_soft_clip_threshold_linear, FINAL_SOFT_CLIP_AMOUNT);
+}
 
-    // --- Aggiornamento Coefficienti Filtri Sidechain (solo se i parametri sono cambiati) ---
-    bool lp_coeffs_changed = false;
-    if (fabsf(sc_lp_freq - self->last_sc_lp_freq) > 1e-6 || fabsf(sc_lp_q - self->last_sc_lp_q) > 1e-6) {
-        lp_coeffs_changed = true;
-        self->last_sc_lp_freq = sc_lp_freq;
-        self->last_sc_lp_q = sc_lp_q;
-    }
+// Ingresso del blocco nella variante ISA dell'istanza (definita con le varianti, più sotto)
+static void process_front(Gla3a* self, const float* in_l, const float* in_r, uint32_t n);
 
-    bool hp_coeffs_changed = false;
-    if (fabsf(sc_hp_freq - self->last_sc_hp_freq) > 1e-6 || fabsf(sc_hp_q - self->last_sc_hp_q) > 1e-6) {
-        hp_coeffs_changed = true;
-        self->last_sc_hp_freq = sc_hp_freq;
-        self->last_sc_hp_q = sc_hp_q;
+// Elabora un blocco di al massimo max_block_size campioni attraverso tutti gli stadi.
+// Ogni parametro del template fissa una scelta della configurazione (gla3a_kernels.h): M/S,
+// LowPass e HighPass della sidechain, stadi di oversampling, modalità Limit.
+template <int MS, int LP, int HP, int STAGES, int LIMIT>
+static void
+process_block_kernel(Gla3a* self, const float* in_l, const float* in_r, float* out_l, float* out_r, uint32_t n) {
+    const bool ms_active = KERNEL_FLAG(MS, params_get(&self->params, GLA3A_MS_MODE_ACTIVE) > 0.5f);
+    // Il collegamento stereo vale solo in L/R: Mid e Side non sono una coppia di canali
+    const GLA3A_StereoLink link = ms_active ? GLA3A_LINK_UNLINKED
+                                  : stereo_link_from_port(params_get(&self->params, GLA3A_STEREO_LINK));
+    const bool link_sum = params_get(&self->params, GLA3A_LINK_DETECTOR) > 0.5f;
+    const float link_amount = params_get(&self->params, GLA3A_LINK_AMOUNT);
+
+    float* audio_M = self->base_buffer_M;
+    float* audio_S = self->base_buffer_S;
+    DetectorReal* sc_M = self->sidechain_buffer_M;
+    DetectorReal* sc_S = self->sidechain_buffer_S;
+
+    process_front(self, in_l, in_r, n);
+
+    // --- Modalità Limit: limiter lookahead sul segnale L/R al posto del compressore ---
+    if (KERNEL_FLAG(LIMIT, self->ratio_mode == GLA3A_RATIO_LIMIT)) {
+        stage_decode(audio_M, audio_S, out_l, out_r, n, ms_active);
+        limiter_process(&self->limiter, out_l, out_r, n, self->current_threshold_linear,
+                        self->make_up_gain_linear, self->detector_release_alpha);
+        stage_clip(out_l, n, self->final_soft_clip_threshold_linear, FINAL_SOFT_CLIP_AMOUNT);
+        stage_clip(out_r, n, self->final_soft_clip_threshold_linear, FINAL_SOFT_CLIP_AMOUNT);
+        return;
     }
 
-    if (lp_coeffs_changed) {
-        for(int i = 0; i < NUM_BIQUADS_FOR_6TH_ORDER; ++i) {
-            calculate_biquad_coeffs(&self->sc_lp_filters_M[i], self->samplerate, sc_lp_freq, sc_lp_q, 0); // Type 0 = LP
-            calculate_biquad_coeffs(&self->sc_lp_filters_S[i], self->samplerate, sc_lp_freq, sc_lp_q, 0);
+    // --- Modalità Multibanda: crossover, poi detector e guadagno di tutte le bande in un passo ---
+    // I filtri della sidechain sono per il detector a banda singola e qui non si usano.
+    if (self->crossover.num_bands > 1) {
+        const BandDetector det = { &self->gain_computer, self->band_threshold_db, self->make_up_gain_linear,
+                                   (float)self->detector_attack_alpha, (float)self->detector_release_alpha,
+                                   (float)self->gain_smooth_alpha }; // Le bande sono sempre float
+        stage_crossover(&self->crossover, audio_M, audio_S, self->band_buffer_M, self->band_buffer_S, n);
+        if (link == GLA3A_LINK_LINKED) {
+            stage_band_dynamics_linked(&self->band_dynamics_M, self->band_buffer_M, self->band_buffer_S,
+                                       audio_M, audio_S, n, &det, link_sum);
+            self->band_dynamics_S = self->band_dynamics_M;
+        } else if (link == GLA3A_LINK_BLEND) {
+            stage_band_dynamics_blend(&self->band_dynamics_M, &self->band_dynamics_S, self->band_buffer_M,
+                                      self->band_buffer_S, audio_M, audio_S, n, &det, link_amount, link_sum);
+        } else {
+            stage_band_dynamics(&self->band_dynamics_M, self->band_buffer_M, audio_M, n, &det);
+            stage_band_dynamics(&self->band_dynamics_S, self->band_buffer_S, audio_S, n, &det);
         }
-    }
-    if (hp_coeffs_changed) {
-        for(int i = 0; i < NUM_BIQUADS_FOR_6TH_ORDER; ++i) {
-            calculate_biquad_coeffs(&self->sc_hp_filters_M[i], self->samplerate, sc_hp_freq, sc_hp_q, 1); // Type 1 = HP
-            calculate_biquad_coeffs(&self->sc_hp_filters_S[i], self->samplerate, sc_hp_freq, sc_hp_q, 1);
+    } else if (link == GLA3A_LINK_LINKED) {
+        // --- Detector Collegato: un solo envelope/gain computer, stesso guadagno sui due canali ---
+        stage_rectify_linked(audio_M, audio_S, sc_M, n, link_sum);
+        sidechain_filter<LP, HP>(self, sc_M, NULL, n);
+        stage_envelope(sc_M, n, &self->detector_envelope_M, self->detector_attack_alpha, self->detector_release_alpha);
+        stage_gain_computer(sc_M, n, &self->gain_computer, self->current_threshold_db, self->make_up_gain_linear);
+        stage_gain_smooth(sc_M, n, &self->current_gain_M, self->gain_smooth_alpha);
+        stage_apply(audio_M, sc_M, n);
+        stage_apply(audio_S, sc_M, n);
+
+        // Il canale S riparte da qui se si torna a detector separati
+        self->detector_envelope_S = self->detector_envelope_M;
+        self->current_gain_S = self->current_gain_M;
+    } else {
+        // --- Sidechain: Rettifica e Filtraggio del Segnale Decimato ---
+        stage_rectify(audio_M, sc_M, n);
+        stage_rectify(audio_S, sc_S, n);
+        sidechain_filter<LP, HP>(self, sc_M, sc_S, n);
+
+        // --- COMPRESSIONE con Soft-Knee e Ratio Variabile ---
+        // Il buffer della sidechain diventa via via envelope, guadagno target e guadagno applicato.
+        stage_envelope(sc_M, n, &self->detector_envelope_M, self->detector_attack_alpha, self->detector_release_alpha);
+        stage_envelope(sc_S, n, &self->detector_envelope_S, self->detector_attack_alpha, self->detector_release_alpha);
+        if (link == GLA3A_LINK_BLEND) {
+            stage_link_blend(sc_M, sc_S, n, link_amount, link_sum);
         }
-    }
 
-    // --- Aggiornamento Coefficienti Filtri Oversampling (sempre un Low Pass) --- // Nuovo
-    // Frequenza di taglio è Nyquist del sample rate originale, divisa per il fattore di oversampling
-    float os_cutoff_freq = (self->samplerate / 2.0f) / UPSAMPLE_FACTOR;
-    for(int i = 0; i < NUM_BIQUADS_FOR_OS_FILTER; ++i) {
-        calculate_biquad_coeffs(&self->upsample_lp_filters_M[i], self->oversampled_samplerate, os_cutoff_freq, OS_FILTER_Q, 0); // Type 0 = LP
-        calculate_biquad_coeffs(&self->upsample_lp_filters_S[i], self->oversampled_samplerate, os_cutoff_freq, OS_FILTER_Q, 0);
-        calculate_biquad_coeffs(&self->downsample_lp_filters_M[i], self->oversampled_samplerate, os_cutoff_freq, OS_FILTER_Q, 0);
-        calculate_biquad_coeffs(&self->downsample_lp_filters_S[i], self->oversampled_samplerate, os_cutoff_freq, OS_FILTER_Q, 0);
+        stage_gain_computer(sc_M, n, &self->gain_computer, self->current_threshold_db, self->make_up_gain_linear);
+        stage_gain_computer(sc_S, n, &self->gain_computer, self->current_threshold_db, self->make_up_gain_linear);
+
+        stage_gain_smooth(sc_M, n, &self->current_gain_M, self->gain_smooth_alpha);
+        stage_gain_smooth(sc_S, n, &self->current_gain_S, self->gain_smooth_alpha);
+
+        stage_apply(audio_M, sc_M, n);
+        stage_apply(audio_S, sc_S, n);
     }
 
+    process_back<MS>(self, out_l, out_r, n);
+}
 
-    // --- Logica True Bypass ---
-    if (bypass > 0.5f) {
-        if (in_l != out_l) { memcpy(out_l, in_l, sizeof(float) * sample_count); }
-        if (in_r != out_r) { memcpy(out_r, in_r, sizeof(float) * sample_count); }
+// --- Varianti ISA (gla3a_isa.h) ---
+// Solo l'ingresso (oversampling e saturazione) e i meter: ogni wrapper istanzia il kernel con le
+// istruzioni della sua variante, e flatten incorpora quello che chiama, che si ricompila con il
+// target del wrapper. Detector, gain computer e limiter sono ricorsivi campione per campione e
+// restano nella base, come il resto del blocco.
+#if GLA3A_ISA_DISPATCH
+template <int MS, int STAGES>
+ISA_TARGET_AVX2 ISA_FLATTEN static void
+process_front_avx2(Gla3a* self, const float* in_l, const float* in_r, uint32_t n) {
+    process_front_kernel<MS, STAGES>(self, in_l, in_r, n);
+}
 
-        // Aggiorna l'RMS dell'output con il segnale di input in bypass
-        float temp_rms_buffer_M[sample_count];
-        float temp_rms_buffer_S[sample_count];
-        if (ms_mode_active > 0.5f) {
-            for(uint32_t j=0; j<sample_count; ++j) {
-                temp_rms_buffer_M[j] = (in_l[j] + in_r[j]) * 0.5f;
-                temp_rms_buffer_S[j] = (in_l[j] - in_r[j]) * 0.5f;
-            }
-        } else {
-            memcpy(temp_rms_buffer_M, in_l, sizeof(float) * sample_count);
-            memcpy(temp_rms_buffer_S, in_r, sizeof(float) * sample_count);
+template <int MS, int STAGES>
+ISA_TARGET_AVX512 ISA_FLATTEN static void
+process_front_avx512(Gla3a* self, const float* in_l, const float* in_r, uint32_t n) {
+    process_front_kernel<MS, STAGES>(self, in_l, in_r, n);
+}
+
+ISA_TARGET_AVX2 ISA_FLATTEN static float
+calculate_rms_level_avx2(const float* buffer, uint32_t n_samples, float current_rms, float alpha) {
+    return calculate_rms_level(buffer, n_samples, current_rms, alpha);
+}
+
+ISA_TARGET_AVX512 ISA_FLATTEN static float
+calculate_rms_level_avx512(const float* buffer, uint32_t n_samples, float current_rms, float alpha) {
+    return calculate_rms_level(buffer, n_samples, current_rms, alpha);
+}
+
+ISA_TARGET_AVX2 ISA_FLATTEN static float
+calculate_mid_rms_level_avx2(const float* left, const float* right, uint32_t n_samples, float current_rms, float alpha) {
+    return calculate_mid_rms_level(left, right, n_samples, current_rms, alpha);
+}
+
+ISA_TARGET_AVX512 ISA_FLATTEN static float
+calculate_mid_rms_level_avx512(const float* left, const float* right, uint32_t n_samples, float current_rms, float alpha) {
+    return calculate_mid_rms_level(left, right, n_samples, current_rms, alpha);
+}
+
+ISA_TARGET_AVX2 ISA_FLATTEN static void
+meter_sums_avx2(const float* left, const float* right, uint32_t n_samples, MeterSums* sums) {
+    meter_sums(left, right, n_samples, sums);
+}
+
+ISA_TARGET_AVX512 ISA_FLATTEN static void
+meter_sums_avx512(const float* left, const float* right, uint32_t n_samples, MeterSums* sums) {
+    meter_sums(left, right, n_samples, sums);
+}
+#endif
+
+typedef void (*FrontKernel)(Gla3a* self, const float* in_l, const float* in_r, uint32_t n);
+typedef void (*BlockKernel)(Gla3a* self, const float* in_l, const float* in_r, float* out_l, float* out_r, uint32_t n);
+
+#if GLA3A_KERNEL == GLA3A_KERNEL_SPECIALIZED
+// Le otto combinazioni di M/S, LowPass e HighPass per un numero di stadi; Limit non usa la sidechain
+#define BLOCK_KERNELS_COMPRESSOR(kernel, stages) \
+    kernel<0, 0, 0, stages, 0>, kernel<1, 0, 0, stages, 0>, kernel<0, 1, 0, stages, 0>, kernel<1, 1, 0, stages, 0>, \
+    kernel<0, 0, 1, stages, 0>, kernel<1, 0, 1, stages, 0>, kernel<0, 1, 1, stages, 0>, kernel<1, 1, 1, stages, 0>
+#define BLOCK_KERNELS_LIMIT(kernel, stages) \
+    kernel<0, 0, 0, stages, 1>, kernel<1, 0, 0, stages, 1>
+
+// Indice: 8 * stadi + 4 * HighPass + 2 * LowPass + M/S; in Limit BLOCK_KERNELS_LIMIT_FIRST + 2 * stadi + M/S
+#define BLOCK_KERNELS(kernel) \
+    BLOCK_KERNELS_COMPRESSOR(kernel, 0), BLOCK_KERNELS_COMPRESSOR(kernel, 1), \
+    BLOCK_KERNELS_COMPRESSOR(kernel, 2), BLOCK_KERNELS_COMPRESSOR(kernel, 3), \
+    BLOCK_KERNELS_LIMIT(kernel, 0), BLOCK_KERNELS_LIMIT(kernel, 1), BLOCK_KERNELS_LIMIT(kernel, 2), BLOCK_KERNELS_LIMIT(kernel, 3)
+#define BLOCK_KERNELS_LIMIT_FIRST (8 * (OS_MAX_STAGES + 1))
+#define BLOCK_KERNELS_COUNT (BLOCK_KERNELS_LIMIT_FIRST + 2 * (OS_MAX_STAGES + 1))
+
+// Solo l'ingresso, per le strisce dell'API a blocchi: indice 2 * stadi + M/S
+#define FRONT_KERNELS(kernel) \
+    kernel<0, 0>, kernel<1, 0>, kernel<0, 1>, kernel<1, 1>, kernel<0, 2>, kernel<1, 2>, kernel<0, 3>, kernel<1, 3>
+#define FRONT_KERNELS_COUNT (2 * (OS_MAX_STAGES + 1))
+#else
+#define BLOCK_KERNELS(kernel) kernel<KERNEL_RUNTIME, KERNEL_RUNTIME, KERNEL_RUNTIME, KERNEL_RUNTIME, KERNEL_RUNTIME>
+#define BLOCK_KERNELS_COUNT 1
+#define FRONT_KERNELS(kernel) kernel<KERNEL_RUNTIME, KERNEL_RUNTIME>
+#define FRONT_KERNELS_COUNT 1
+#endif
+
+// Indice: come in process_block()
+static const BlockKernel block_kernels[BLOCK_KERNELS_COUNT] = { BLOCK_KERNELS(process_block_kernel) };
+
+// I kernel di una variante ISA
+typedef struct {
+    FrontKernel front[FRONT_KERNELS_COUNT];
+    float (*rms_level)(const float* buffer, uint32_t n_samples, float current_rms, float alpha);
+    float (*mid_rms_level)(const float* left, const float* right, uint32_t n_samples, float current_rms, float alpha);
+    void (*meter_sums)(const float* left, const float* right, uint32_t n_samples, MeterSums* sums);
+} IsaKernels;
+
+// Indice: GLA3A_ISA_* (Gla3a::isa)
+static const IsaKernels isa_kernels[] = {
+    { { FRONT_KERNELS(process_front_kernel) },
+      calculate_rms_level, calculate_mid_rms_level, meter_sums },
+#if GLA3A_ISA_DISPATCH
+    { { FRONT_KERNELS(process_front_avx2) },
+      calculate_rms_level_avx2, calculate_mid_rms_level_avx2, meter_sums_avx2 },
+    { { FRONT_KERNELS(process_front_avx512) },
+      calculate_rms_level_avx512, calculate_mid_rms_level_avx512, meter_sums_avx512 },
+#endif
+};
+
+// Dispatcher dell'ingresso del blocco (process_front_kernel()), come process_block()
+static void
+process_front(Gla3a* self, const float* in_l, const float* in_r, uint32_t n) {
+    const IsaKernels* kernels = &isa_kernels[self->isa];
+#if GLA3A_KERNEL == GLA3A_KERNEL_SPECIALIZED
+    const int ms = params_get(&self->params, GLA3A_MS_MODE_ACTIVE) > 0.5f;
+    kernels->front[2 * self->oversampler.num_stages + ms](self, in_l, in_r, n);
+#else
+    kernels->front[0](self, in_l, in_r, n);
+#endif
+}
+
+// Dispatcher: a ogni blocco il kernel con la configurazione corrente fissata a compilazione
+static void
+process_block(Gla3a* self, const float* in_l, const float* in_r, float* out_l, float* out_r, uint32_t n) {
+#if GLA3A_KERNEL == GLA3A_KERNEL_SPECIALIZED
+    const int ms = params_get(&self->params, GLA3A_MS_MODE_ACTIVE) > 0.5f;
+    const int lp = params_get(&self->params, GLA3A_SC_LP_ON) > 0.5f;
+    const int hp = params_get(&self->params, GLA3A_SC_HP_ON) > 0.5f;
+    const int stages = self->oversampler.num_stages;
+    const int index = (self->ratio_mode == GLA3A_RATIO_LIMIT) ? BLOCK_KERNELS_LIMIT_FIRST + 2 * stages + ms
+                                                              : 8 * stages + 4 * hp + 2 * lp + ms;
+    block_kernels[index](self, in_l, in_r, out_l, out_r, n);
+#else
+    block_kernels[0](self, in_l, in_r, out_l, out_r, n);
+#endif
+}
+
+// --- Eventi patch:Set ---
+// Valore numerico di un atom (Float, Double, Int, Long o Bool); false se il tipo non è numerico
+static bool atom_to_float(const Gla3a* self, const LV2_Atom* atom, float* out) {
+    if (!atom) return false;
+    if (atom->type == self->uris.atom_Float)  { *out = ((const LV2_Atom_Float*)atom)->body; return true; }
+    if (atom->type == self->uris.atom_Double) { *out = (float)((const LV2_Atom_Double*)atom)->body; return true; }
+    if (atom->type == self->uris.atom_Int)    { *out = (float)((const LV2_Atom_Int*)atom)->body; return true; }
+    if (atom->type == self->uris.atom_Long)   { *out = (float)((const LV2_Atom_Long*)atom)->body; return true; }
+    if (atom->type == self->uris.atom_Bool)   { *out = ((const LV2_Atom_Bool*)atom)->body ? 1.0f : 0.0f; return true; }
+    return false;
+}
+
+// Applica un patch:Set a un parametro noto o al banco di preset; gli altri eventi si ignorano
+static void handle_event(Gla3a* self, const LV2_Atom* atom) {
+    if (atom->type != self->uris.atom_Object && atom->type != self->uris.atom_Blank) return;
+    const LV2_Atom_Object* obj = (const LV2_Atom_Object*)atom;
+    if (obj->body.otype != self->uris.patch_Set) return;
+
+    const LV2_Atom* property = NULL;
+    const LV2_Atom* value = NULL;
+    lv2_atom_object_get(obj, self->uris.patch_property, &property, self->uris.patch_value, &value, 0);
+    if (!property || property->type != self->uris.atom_URID) return;
+
+    float v;
+    if (!atom_to_float(self, value, &v)) return;
+    const LV2_URID key = ((const LV2_Atom_URID*)property)->body;
+    for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+        if (self->param_urids[i] == key) {
+            params_set(&self->params, gla3a_parameters[i].port, v);
+            return;
         }
-        self->current_output_rms_level = calculate_rms_level(temp_rms_buffer_M, sample_count, self->current_output_rms_level, self->rms_meter_alpha);
-        *self->output_rms_ptr = to_db(self->current_output_rms_level);
-        *self->gain_reduction_meter_ptr = 0.0f; // Nessuna gain reduction in bypass
-        return;
     }
 
-    // Assicurati che il buffer di oversampling sia abbastanza grande // Nuovo
-    if (sample_count * UPSAMPLE_FACTOR > self->oversample_buffer_size) {
-        lv2_log_logger_error(&self->logger, "Oversample buffer too small! Reallocating...");
-        // Reallocate if needed, though this should ideally be avoided in run()
-        free(self->oversample_buffer_M);
-        free(self->oversample_buffer_S);
-        self->oversample_buffer_size = sample_count * UPSAMPLE_FACTOR;
-        self->oversample_buffer_M = (float*)calloc(self->oversample_buffer_size, sizeof(float));
-        self->oversample_buffer_S = (float*)calloc(self->oversample_buffer_size, sizeof(float));
-        if (!self->oversample_buffer_M || !self->oversample_buffer_S) {
-            lv2_log_logger_error(&self->logger, "Failed to reallocate oversample buffers!");
-            // Fallback to bypass or handle error
-            if (in_l != out_l) { memcpy(out_l, in_l, sizeof(float) * sample_count); }
-            if (in_r != out_r) { memcpy(out_r, in_r, sizeof(float) * sample_count); }
-            return;
+    // Banco di preset: numero dello slot, arrotondato al più vicino (-0.6 è -1, fuori dal banco).
+    // NaN e valori enormi si scartano prima: lrintf() non avrebbe un risultato definito.
+    if (!(fabsf(v) <= GLA3A_NUM_PRESETS)) return;
+    const long index = lrintf(v);
+    if (index < 0 || index >= GLA3A_NUM_PRESETS) return;
+    if (key == self->uris.preset) preset_recall(self, index);
+    else if (key == self->uris.preset_store) preset_store(self, index);
+}
+
+// Gain reduction attuale come guadagno lineare (1 = nessuna): il limiter, o il guadagno più basso
+// tra M/S e tra le bande senza il make-up. In dB con gain_reduction_db(), una volta sola per meter.
+static float current_gain_reduction(const Gla3a* self) {
+    if (self->ratio_mode == GLA3A_RATIO_LIMIT) return self->limiter.gain;
+    float min_gain = fminf(self->current_gain_M, self->current_gain_S);
+    if (self->crossover.num_bands > 1) {
+        min_gain = fminf(self->band_dynamics_M.gain[0], self->band_dynamics_S.gain[0]);
+        for (int k = 1; k < self->crossover.num_bands; ++k) {
+            min_gain = fminf(min_gain, fminf(self->band_dynamics_M.gain[k], self->band_dynamics_S.gain[k]));
         }
     }
+    return min_gain / self->make_up_gain_linear;
+}
 
+// Gain reduction in dB positivi per i meter
+static float gain_reduction_db(float gain) {
+    return fmaxf(0.0f, -to_db(gain));
+}
 
-    // --- Oversampling per il Blocco Corrente --- // Nuovo
-    // Interleave sample e applica filtro LP di interpolazione (6° ordine)
-    for (uint32_t i = 0; i < sample_count; ++i) {
-        float input_l = in_l[i];
-        float input_r = in_r[i];
+// --- Frame dei Meter (porta GLA3A_NOTIFY) ---
+// Picchi e RMS per canale, d'ingresso e d'uscita, e GR si accumulano su finestre di meter_period
+// campioni. Alla chiusura di una finestra un frame entra nella sequenza in uscita, con il timestamp
+// del suo ultimo campione: GLA3A_METER_RATE_HZ eventi da METER_FRAME_BYTES al secondo, qualunque
+// sia il blocco dell'host. Il forge scrive nel buffer della porta (niente allocazioni nella run).
+// run_segment() taglia i pezzi al confine delle finestre e misura l'ingresso prima di elaborarlo,
+// perché l'host può dare lo stesso buffer a ingresso e uscita.
+
+// Timestamp, oggetto, chiave e vettore di un frame
+#define METER_FRAME_BYTES (sizeof(int64_t) + sizeof(LV2_Atom_Object) + sizeof(LV2_Atom_Property_Body_Head) + \
+                           sizeof(LV2_Atom_Vector) + lv2_atom_pad_size(GLA3A_METER_NUM_VALUES * sizeof(float)))
+
+// Apre la sequenza nel buffer della porta (l'host mette in atom.size lo spazio disponibile)
+static void meter_begin(Gla3a* self) {
+    self->notify_open = false;
+    if (!self->notify_ptr || !self->uris.meter_frame) return;
+    lv2_atom_forge_set_buffer(&self->forge, (uint8_t*)self->notify_ptr, self->notify_ptr->atom.size);
+    self->notify_open = lv2_atom_forge_sequence_head(&self->forge, &self->notify_frame, 0) != 0;
+}
 
-        // Converti a M/S o resta L/R per il processing interno
-        float M_original_input, S_original_input;
-        if (ms_mode_active > 0.5f) {
-            M_original_input = (input_l + input_r) * 0.5f;
-            S_original_input = (input_l - input_r) * 0.5f;
-        } else {
-            M_original_input = input_l;
-            S_original_input = input_r;
-        }
+static void meter_end(Gla3a* self) {
+    if (self->notify_open) lv2_atom_forge_pop(&self->forge, &self->notify_frame);
+    self->notify_open = false;
+}
+
+// Campioni che mancano alla chiusura della finestra (nessun limite se i frame non si scrivono)
+static uint32_t meter_window_left(const Gla3a* self) {
+    return self->notify_open ? self->meter_period - self->meter_count : UINT32_MAX;
+}
 
-        for (int j = 0; j < UPSAMPLE_FACTOR; ++j) {
-            // Per una semplice interpolazione, ripetiamo il campione e lo filtriamo.
-            // Tecniche più avanzate userebbero un FIR sinc interpolation.
-            float interpolated_M = M_original_input; 
-            float interpolated_S = S_original_input;
+// Somme di un pezzo; un pezzo silenzioso non si legge
+static void meter_measure(const Gla3a* self, const float* left, const float* right, uint32_t n, bool silent,
+                          MeterSums* sums) {
+    if (silent) memset(sums, 0, sizeof(MeterSums));
+    else isa_kernels[self->isa].meter_sums(left, right, n, sums);
+}
 
-            // Apply interpolation filter (LPF)
-            for(int k = 0; k < NUM_BIQUADS_FOR_OS_FILTER; ++k) {
-                interpolated_M = biquad_process(&self->upsample_lp_filters_M[k], interpolated_M);
-                interpolated_S = biquad_process(&self->upsample_lp_filters_S[k], interpolated_S);
-            }
-            
-            self->oversample_buffer_M[i * UPSAMPLE_FACTOR + j] = interpolated_M;
-            self->oversample_buffer_S[i * UPSAMPLE_FACTOR + j] = interpolated_S;
-        }
+// Aggiunge un pezzo di n campioni alla finestra. Se la chiude, scrive il frame: 'end' è la posizione
+// nella run del campione dopo il pezzo. Senza spazio nel buffer il frame si perde.
+static void meter_feed(Gla3a* self, const MeterSums* in, const MeterSums* out, float gain, uint32_t n, uint32_t end) {
+    for (int c = 0; c < 2; ++c) {
+        self->meter_in.peak[c] = fmaxf(self->meter_in.peak[c], in->peak[c]);
+        self->meter_in.sum[c] += in->sum[c];
+        self->meter_out.peak[c] = fmaxf(self->meter_out.peak[c], out->peak[c]);
+        self->meter_out.sum[c] += out->sum[c];
+    }
+    self->meter_gain = fminf(self->meter_gain, gain);
+    self->meter_count += n;
+    if (self->meter_count < self->meter_period) return;
+
+    float values[GLA3A_METER_NUM_VALUES];
+    const float inv_period = 1.0f / (float)self->meter_period;
+    for (int c = 0; c < 2; ++c) {
+        values[GLA3A_METER_IN_PEAK_L + c] = to_db(self->meter_in.peak[c]);
+        values[GLA3A_METER_IN_RMS_L + c] = to_db(sqrtf(self->meter_in.sum[c] * inv_period));
+        values[GLA3A_METER_OUT_PEAK_L + c] = to_db(self->meter_out.peak[c]);
+        values[GLA3A_METER_OUT_RMS_L + c] = to_db(sqrtf(self->meter_out.sum[c] * inv_period));
+    }
+    values[GLA3A_METER_GR] = gain_reduction_db(self->meter_gain);
+
+    LV2_Atom_Forge* forge = &self->forge;
+    if (forge->offset + METER_FRAME_BYTES <= forge->size) {
+        LV2_Atom_Forge_Frame object;
+        lv2_atom_forge_frame_time(forge, end - 1);
+        lv2_atom_forge_object(forge, &object, 0, self->uris.meter_frame);
+        lv2_atom_forge_key(forge, self->uris.meter_values);
+        lv2_atom_forge_vector(forge, sizeof(float), self->uris.atom_Float, GLA3A_METER_NUM_VALUES, values);
+        lv2_atom_forge_pop(forge, &object);
     }
 
-    // --- Loop di elaborazione audio sample per sample a Frequenza Campionamento Maggiore --- // Nuovo
-    for (uint32_t os_idx = 0; os_idx < sample_count * UPSAMPLE_FACTOR; ++os_idx) {
-        float M_audio_os = self->oversample_buffer_M[os_idx];
-        float S_audio_os = self->oversample_buffer_S[os_idx];
+    self->meter_count = 0;
+    memset(&self->meter_in, 0, sizeof(self->meter_in));
+    memset(&self->meter_out, 0, sizeof(self->meter_out));
+    self->meter_gain = 1.0f;
+}
 
-        // --- Saturazione J-FET (applicata ad alta frequenza campionamento) ---
-        M_audio_os = apply_jfet_distortion(M_audio_os, JF_K_FACTOR, JF_SATURATION_THRESHOLD, JF_DRY_WET_MIX);
-        S_audio_os = apply_jfet_distortion(S_audio_os, JF_K_FACTOR, JF_SATURATION_THRESHOLD, JF_DRY_WET_MIX);
+// Latenza in campioni: filtri di oversampling, più la finestra del limiter in modalità Limit
+static uint32_t current_latency(const Gla3a* self) {
+    const bool limiting = (self->ratio_mode == GLA3A_RATIO_LIMIT);
+    return (uint32_t)roundf(self->oversampler.latency) + (limiting ? limiter_latency(&self->limiter) : 0);
+}
 
-        self->oversample_buffer_M[os_idx] = M_audio_os;
-        self->oversample_buffer_S[os_idx] = S_audio_os;
+// --- Ritardo del Bypass ---
+// In bypass l'uscita è l'ingresso ritardato di current_latency(): la latenza riportata all'host
+// resta vera e attivare il bypass non sposta la traccia. L'anello riceve l'ingresso anche fuori
+// dal bypass, così quando si attiva contiene già gli ultimi campioni.
+
+static void bypass_delay_write(Gla3a* self, const float* left, const float* right, uint32_t n) {
+    const uint32_t size = self->bypass_delay_mask + 1;
+    if (n > size) { // Contano solo gli ultimi 'size' campioni
+        left += n - size;
+        right += n - size;
+        self->bypass_delay_pos = (self->bypass_delay_pos + n - size) & self->bypass_delay_mask;
+        n = size;
     }
+    const uint32_t pos = self->bypass_delay_pos;
+    const uint32_t first = (n < size - pos) ? n : size - pos;
+    memcpy(self->bypass_delay_l + pos, left, sizeof(float) * first);
+    memcpy(self->bypass_delay_r + pos, right, sizeof(float) * first);
+    memcpy(self->bypass_delay_l, left + first, sizeof(float) * (n - first));
+    memcpy(self->bypass_delay_r, right + first, sizeof(float) * (n - first));
+    self->bypass_delay_pos = (pos + n) & self->bypass_delay_mask;
+}
 
-    // --- Loop di elaborazione audio sample per sample a Frequenza Campionamento Originale ---
-    for (uint32_t i = 0; i < sample_count; ++i) {
-        // Prendiamo il campione oversamplato dal buffer che ha subito la distorsione
-        // e lo passiamo attraverso il filtro di decimazione.
-        float M_audio_pre_comp = self->oversample_buffer_M[i * UPSAMPLE_FACTOR]; 
-        float S_audio_pre_comp = self->oversample_buffer_S[i * UPSAMPLE_FACTOR];
+// Ingresso e uscita possono coincidere: ogni campione entra nell'anello prima di leggere l'uscita
+static void bypass_delay_process(Gla3a* self, const float* in_l, const float* in_r, float* out_l, float* out_r, uint32_t n) {
+    const uint32_t latency = current_latency(self);
+    const uint32_t mask = self->bypass_delay_mask;
+    uint32_t pos = self->bypass_delay_pos;
+    for (uint32_t i = 0; i < n; ++i) {
+        self->bypass_delay_l[pos] = in_l[i];
+        self->bypass_delay_r[pos] = in_r[i];
+        const uint32_t tap = (pos - latency) & mask;
+        out_l[i] = self->bypass_delay_l[tap];
+        out_r[i] = self->bypass_delay_r[tap];
+        pos = (pos + 1) & mask;
+    }
+    self->bypass_delay_pos = pos;
+}
 
-        // Applica filtro LP di decimazione (6° ordine) per anti-aliasing // Nuovo
-        for(int k = 0; k < NUM_BIQUADS_FOR_OS_FILTER; ++k) {
-            M_audio_pre_comp = biquad_process(&self->downsample_lp_filters_M[k], M_audio_pre_comp);
-            S_audio_pre_comp = biquad_process(&self->downsample_lp_filters_S[k], S_audio_pre_comp);
+// Elabora [offset, offset + n) con i parametri correnti: bypass o pezzi di max_block_size campioni
+// (più corti alla fine di una finestra dei meter). Ogni stadio porta il suo stato da un pezzo al
+// successivo: il risultato non dipende dal taglio.
+static void run_segment(Gla3a* self, uint32_t offset, uint32_t n) {
+    const float* in_l = self->audio_in_l_ptr + offset;
+    const float* in_r = self->audio_in_r_ptr + offset;
+    float* out_l = self->audio_out_l_ptr + offset;
+    float* out_r = self->audio_out_r_ptr + offset;
+
+    // Un parametro cambiato può spostare il punto fisso (soglia, make-up, modalità): si ridimostra
+    if (self->params.dirty) self->idle = false;
+    update_derived_params(self);
+
+    // --- Bypass: l'ingresso con la latenza del percorso elaborato, senza gain reduction ---
+    if (params_get(&self->params, GLA3A_BYPASS) > 0.5f) {
+        for (uint32_t done = 0, piece; done < n; done += piece) {
+            piece = n - done;
+            if (self->notify_open && piece > meter_window_left(self)) piece = meter_window_left(self);
+            MeterSums in_sums, out_sums;
+            if (self->notify_open) meter_measure(self, in_l + done, in_r + done, piece, false, &in_sums);
+            bypass_delay_process(self, in_l + done, in_r + done, out_l + done, out_r + done, piece);
+            if (self->notify_open) {
+                meter_measure(self, out_l + done, out_r + done, piece, false, &out_sums);
+                meter_feed(self, &in_sums, &out_sums, 1.0f, piece, offset + done + piece);
+            }
         }
+        return;
+    }
+
+    for (uint32_t done = 0, chunk; done < n; done += chunk) {
+        const uint32_t remaining = n - done;
+        chunk = (remaining < self->max_block_size) ? remaining : self->max_block_size;
+        if (chunk > meter_window_left(self)) chunk = meter_window_left(self);
+        bypass_delay_write(self, in_l + done, in_r + done, chunk);
+        const bool silent = samples_are_zero(in_l + done, in_r + done, chunk);
+        MeterSums in_sums;
+        if (self->notify_open) meter_measure(self, in_l + done, in_r + done, chunk, silent, &in_sums);
+
+        // --- Riposo: uscita nulla senza toccare lo stato ---
+        if (silent && self->idle) {
+            memset(out_l + done, 0, sizeof(float) * chunk);
+            memset(out_r + done, 0, sizeof(float) * chunk);
+        } else {
+            const bool at_rest = silent && state_is_at_rest(self);
+            RestGains gains;
+            rest_gains_save(self, &gains);
 
-        // Il resto della logica del compressore opera su sample_count originale
-        float M_sidechain_in = fabsf(M_audio_pre_comp); // Detector su ampiezza del segnale filtrato
-        float S_sidechain_in = fabsf(S_audio_pre_comp);
+            process_block(self, in_l + done, in_r + done, out_l + done, out_r + done, chunk);
+            flush_denormal_state(self);
 
-        // --- FILTRAGGIO SIDECHAIN (6° Ordine) ---
-        if (sc_lp_on > 0.5f) {
-            for(int k = 0; k < NUM_BIQUADS_FOR_6TH_ORDER; ++k) {
-                M_sidechain_in = biquad_process(&self->sc_lp_filters_M[k], M_sidechain_in);
-                S_sidechain_in = biquad_process(&self->sc_lp_filters_S[k], S_sidechain_in);
-            }
+            self->idle = at_rest && rest_gains_unchanged(self, &gains) && samples_are_zero(out_l + done, out_r + done, chunk);
         }
-        if (sc_hp_on > 0.5f) {
-            for(int k = 0; k < NUM_BIQUADS_FOR_6TH_ORDER; ++k) {
-                M_sidechain_in = biquad_process(&self->sc_hp_filters_M[k], M_sidechain_in);
-                S_sidechain_in = biquad_process(&self->sc_hp_filters_S[k], S_sidechain_in);
-            }
+
+        if (self->notify_open) {
+            MeterSums out_sums;
+            meter_measure(self, out_l + done, out_r + done, chunk, silent && self->idle, &out_sums);
+            meter_feed(self, &in_sums, &out_sums, current_gain_reduction(self), chunk, offset + done + chunk);
         }
+    }
+}
 
-        // --- COMPRESSIONE con Soft-Knee e Ratio Variabile ---
-        // Canale M/Left
-        if (M_sidechain_in > self->detector_envelope_M) { // Attacco
-            self->detector_envelope_M = (self->detector_envelope_M * (1.0f - self->detector_attack_alpha)) + (M_sidechain_in * self->detector_attack_alpha);
-        } else { // Rilascio
-            self->detector_envelope_M = (self->detector_envelope_M * (1.0f - self->detector_release_alpha)) + (M_sidechain_in * self->detector_release_alpha);
-        }
-
-        float target_gr_db_M = 0.0f;
-        float detector_env_db_M = to_db(self->detector_envelope_M);
-
-        if (detector_env_db_M > (current_threshold_db + KNEE_WIDTH_DB)) {
-            float over_threshold_db = detector_env_db_M - (current_threshold_db + KNEE_WIDTH_DB);
-            target_gr_db_M = over_threshold_db * (1.0f - (1.0f / current_ratio));
-        } else if (detector_env_db_M > current_threshold_db) {
-            float normalized_pos_in_knee = (detector_env_db_M - current_threshold_db) / KNEE_WIDTH_DB;
-            float effective_ratio_in_knee = 1.0f + (current_ratio - 1.0f) * normalized_pos_in_knee;
-            target_gr_db_M = (detector_env_db_M - current_threshold_db) * (1.0f - (1.0f / effective_ratio_in_knee));
-        }
-        target_gr_db_M = fmaxf(0.0f, target_gr_db_M);
-
-        float target_total_gain_M = db_to_linear(-target_gr_db_M) * make_up_gain_linear;
-        self->current_gain_M = (self->current_gain_M * (1.0f - self->gain_smooth_alpha)) + (target_total_gain_M * self->gain_smooth_alpha);
-        
-        float processed_M = M_audio_pre_comp * self->current_gain_M;
-
-        // Canale S/Right (duplicazione logica di compressione)
-        if (S_sidechain_in > self->detector_envelope_S) { // Attacco
-            self->detector_envelope_S = (self->detector_envelope_S * (1.0f - self->detector_attack_alpha)) + (S_sidechain_in * self->detector_attack_alpha);
-        } else { // Rilascio
-            self->detector_envelope_S = (self->detector_envelope_S * (1.0f - self->detector_release_alpha)) + (S_sidechain_in * self->detector_release_alpha);
-        }
-
-        float target_gr_db_S = 0.0f;
-        float detector_env_db_S = to_db(self->detector_envelope_S);
-
-        if (detector_env_db_S > (current_threshold_db + KNEE_WIDTH_DB)) {
-            float over_threshold_db = detector_env_db_S - (current_threshold_db + KNEE_WIDTH_DB);
-            target_gr_db_S = over_threshold_db * (1.0f - (1.0f / current_ratio));
-        } else if (detector_env_db_S > current_threshold_db) {
-            float normalized_pos_in_knee = (detector_env_db_S - current_threshold_db) / KNEE_WIDTH_DB;
-            float effective_ratio_in_knee = 1.0f + (current_ratio - 1.0f) * normalized_pos_in_knee;
-            target_gr_db_S = (detector_env_db_S - current_threshold_db) * (1.0f - (1.0f / effective_ratio_in_knee));
-        }
-        target_gr_db_S = fmaxf(0.0f, target_gr_db_S);
-
-        float target_total_gain_S = db_to_linear(-target_gr_db_S) * make_up_gain_linear;
-        self->current_gain_S = (self->current_gain_S * (1.0f - self->gain_smooth_alpha)) + (target_total_gain_S * self->gain_smooth_alpha);
-        
-        float processed_S = S_audio_pre_comp * self->current_gain_S;
-
-
-        // --- Decodifica M/S in L/R (a valle della compressione/distorsione) ---
-        float output_l, output_r;
-        if (ms_mode_active > 0.5f) {
-            output_l = processed_M + processed_S;
-            output_r = processed_M - processed_S;
-        } else {
-            output_l = processed_M;
-            output_r = processed_S;
+// Funzione di elaborazione audio (run)
+static void
+run(LV2_Handle instance, uint32_t sample_count) {
+    Gla3a* self = (Gla3a*)instance;
+
+    // FTZ/DAZ solo per la durata di run(): il registro torna com'era prima di ogni return
+    DenormalGuard denormal_guard;
+    denormal_guard_enter(&denormal_guard);
+
+    // --- Parametri di Controllo ---
+    // Le porte si leggono una volta per blocco; le grandezze derivate si ricalcolano solo per
+    // i parametri cambiati (dalla porta o da un evento)
+    params_read(&self->params);
+    meter_begin(self);
+
+    // Coefficienti progettati dal worker dopo l'ultima run: si scambiano qui, al confine del blocco
+    design_collect(self);
+
+    // --- Eventi a campione preciso ---
+    // Il blocco si spezza al timestamp di ogni patch:Set: il segmento prima dell'evento usa i
+    // parametri vecchi, quello dopo i nuovi. Più eventi sullo stesso campione si applicano
+    // insieme (il segmento in mezzo è vuoto), quindi i coefficienti si ricalcolano una volta sola.
+    uint32_t offset = 0;
+    if (self->control_ptr && self->uris.patch_Set) {
+        LV2_ATOM_SEQUENCE_FOREACH(self->control_ptr, ev) {
+            uint32_t frame = (ev->time.frames < 0) ? 0 : (uint32_t)ev->time.frames;
+            if (frame > sample_count) frame = sample_count;
+            if (frame > offset) {
+                run_segment(self, offset, frame - offset);
+                offset = frame;
+            }
+            handle_event(self, &ev->body);
         }
+    }
+    if (offset < sample_count) {
+        run_segment(self, offset, sample_count - offset);
+    }
+
+    meter_end(self);
 
-        // --- Soft-Clipping Finale (Limiter di Sicurezza in Output) ---
-        output_l = apply_final_soft_clip(output_l, final_soft_clip_threshold_linear, FINAL_SOFT_CLIP_AMOUNT);
-        output_r = apply_final_soft_clip(output_r, final_soft_clip_threshold_linear, FINAL_SOFT_CLIP_AMOUNT);
+    // Parametri dagli eventi in fondo al blocco (o con sample_count = 0): si applicano subito
+    update_derived_params(self);
 
-        // Scrivi i sample elaborati nei buffer di output
-        out_l[i] = output_l;
-        out_r[i] = output_r;
+    *self->latency_ptr = current_latency(self);
+
+    const float* out_l = self->audio_out_l_ptr;
+    const float* out_r = self->audio_out_r_ptr;
+
+    // --- Meter in bypass ---
+    if (params_get(&self->params, GLA3A_BYPASS) > 0.5f) {
+        // Aggiorna l'RMS dell'output con il segnale di input in bypass (Mid o Left)
+        if (params_get(&self->params, GLA3A_MS_MODE_ACTIVE) > 0.5f) {
+            self->current_output_rms_level = isa_kernels[self->isa].mid_rms_level(out_l, out_r, sample_count, self->current_output_rms_level, self->rms_meter_alpha);
+        } else {
+            self->current_output_rms_level = isa_kernels[self->isa].rms_level(out_l, sample_count, self->current_output_rms_level, self->rms_meter_alpha);
+        }
+        *self->output_rms_ptr = to_db(self->current_output_rms_level);
+        *self->gain_reduction_meter_ptr = 0.0f; // Nessuna gain reduction in bypass
+        denormal_guard_leave(&denormal_guard);
+        return;
     }
 
     // --- Aggiornamento dei valori dei meter per l'intero blocco ---
-    self->current_output_rms_level = calculate_rms_level(out_l, sample_count, self->current_output_rms_level, self->rms_meter_alpha);
+    self->current_output_rms_level = isa_kernels[self->isa].rms_level(out_l, sample_count, self->current_output_rms_level, self->rms_meter_alpha);
     *self->output_rms_ptr = to_db(self->current_output_rms_level);
 
-    // Calcolo della Gain Reduction Media per il meter di GR
-    float actual_gr_db_M = to_db(make_up_gain_linear) - to_db(self->current_gain_M);
-    float actual_gr_db_S = to_db(make_up_gain_linear) - to_db(self->current_gain_S);
-
-    self->current_gain_reduction_display = fmaxf(0.0f, fmaxf(actual_gr_db_M, actual_gr_db_S));
+    // Gain reduction per il meter di GR
+    self->current_gain_reduction_display = gain_reduction_db(current_gain_reduction(self));
     *self->gain_reduction_meter_ptr = self->current_gain_reduction_display;
+    denormal_guard_leave(&denormal_guard);
 }
 
 // Funzione di pulizia
 static void
 cleanup(LV2_Handle instance) {
     Gla3a* self = (Gla3a*)instance;
-    free(self->oversample_buffer_M); // Nuovo
-    free(self->oversample_buffer_S); // Nuovo
+    free_buffers(self);
     free(instance);
 }
 
+// --- Stato (state:interface) ---
+// Il valore corrente di ogni parametro (atom:Float con l'URI del parametro, come nei patch:Set) e
+// il banco di preset (GLA3A_PRESET_BANK_URI, vedi gla3a.h). save() e restore() non girano insieme
+// a run(): restore() progetta qui banco e parametri, e la run successiva si limita a copiare.
+
+typedef struct {
+    LV2_Atom_Vector_Body body;
+    float value[GLA3A_NUM_PRESETS * GLA3A_NUM_PARAMETERS];
+} PresetBankBody;
+
+static LV2_State_Status
+save(LV2_Handle instance, LV2_State_Store_Function store, LV2_State_Handle handle,
+     uint32_t flags, const LV2_Feature* const* features) {
+    Gla3a* self = (Gla3a*)instance;
+    if (!self->map) return LV2_STATE_ERR_NO_FEATURE;
+    const uint32_t pod = LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE;
+
+    for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+        const float v = params_get(&self->params, gla3a_parameters[i].port);
+        const LV2_State_Status status = store(handle, self->param_urids[i], &v, sizeof(v), self->uris.atom_Float, pod);
+        if (status != LV2_STATE_SUCCESS) return status;
+    }
+
+    PresetBankBody bank;
+    bank.body.child_size = sizeof(float);
+    bank.body.child_type = self->uris.atom_Float;
+    for (int p = 0; p < GLA3A_NUM_PRESETS; ++p) {
+        for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+            bank.value[p * GLA3A_NUM_PARAMETERS + i] = self->presets[p].value[gla3a_parameters[i].port];
+        }
+    }
+    return store(handle, self->uris.preset_bank, &bank, sizeof(bank), self->uris.atom_Vector, pod);
+}
+
+// Le chiavi mancanti (stati di versioni precedenti) lasciano il valore corrente
+static LV2_State_Status
+restore(LV2_Handle instance, LV2_State_Retrieve_Function retrieve, LV2_State_Handle handle,
+        uint32_t flags, const LV2_Feature* const* features) {
+    Gla3a* self = (Gla3a*)instance;
+    if (!self->map) return LV2_STATE_ERR_NO_FEATURE;
+    size_t size;
+    uint32_t type, value_flags;
+
+    const PresetBankBody* bank = (const PresetBankBody*)retrieve(handle, self->uris.preset_bank, &size, &type, &value_flags);
+    if (bank && type == self->uris.atom_Vector && size == sizeof(PresetBankBody) &&
+        bank->body.child_type == self->uris.atom_Float && bank->body.child_size == sizeof(float)) {
+        for (int p = 0; p < GLA3A_NUM_PRESETS; ++p) {
+            PresetSlot* slot = &self->presets[p];
+            for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+                slot->value[gla3a_parameters[i].port] = bank->value[p * GLA3A_NUM_PARAMETERS + i];
+            }
+            // Lo slot che il worker sta progettando si rifà con i valori nuovi
+            if (self->design_in_flight && self->design_slot == p) {
+                slot->ready = false;
+                self->preset_store_pending |= 1u << p;
+            } else {
+                self->preset_store_pending &= ~(1u << p);
+                preset_design(slot, self->samplerate);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+        const float* v = (const float*)retrieve(handle, self->param_urids[i], &size, &type, &value_flags);
+        if (v && type == self->uris.atom_Float && size == sizeof(float)) {
+            params_restore(&self->params, gla3a_parameters[i].port, *v);
+        }
+    }
+
+    // Grandezze derivate dei parametri ripristinati: progettate qui, applicate dalla prossima run
+    CoeffDesign* d = (CoeffDesign*)malloc(sizeof(CoeffDesign));
+    if (!d) return LV2_STATE_ERR_UNKNOWN;
+    gain_computer_init(&d->gain_computer);
+    crossover_init(&d->crossover);
+    design_coeffs(d, self->params.value, PARAMS_DESIGN, self->samplerate);
+    design_preload(self, d, self->params.value);
+    free(d);
+    return LV2_STATE_SUCCESS;
+}
+
+// Interfacce opzionali: work:interface per il progetto dei coefficienti fuori dal thread audio,
+// state:interface per parametri e banco di preset
+static const void*
+extension_data(const char* uri) {
+    static const LV2_Worker_Interface worker = { work, work_response, NULL };
+    static const LV2_State_Interface state = { save, restore };
+    if (!strcmp(uri, LV2_WORKER__interface)) return &worker;
+    if (!strcmp(uri, LV2_STATE__interface)) return &state;
+    return NULL;
+}
+
 // Descrittore del plugin
 static const LV2_Descriptor descriptor = {
     GLA3A_URI,
@@ -689,7 +1987,7 @@ static const LV2_Descriptor descriptor = {
     run,
     NULL, // deactivate
     cleanup,
-    NULL // extension_data
+    extension_data
 };
 
 // Punto di ingresso LV2
@@ -700,3 +1998,388 @@ const LV2_Descriptor* lv2_descriptor(uint32_t index) {
     }
     return NULL;
 }
+
+
+// --- API a Blocchi (gla3a_batch.h) ---
+// Ogni striscia è una Gla3a completa: parametri, grandezze derivate e percorsi che non stanno nelle
+// corsie (Limit, multibanda, bypass) restano quelli del plugin. Per le strisce nelle corsie la Gla3a
+// fa ingresso e uscita del blocco (M/S, oversampling, saturazione, decodifica, clip) e il gruppo fa
+// il detector: envelope, guadagni e filtri della sidechain vivono nelle corsie e tornano nella Gla3a
+// solo quando la striscia passa a un percorso che non sta nelle corsie.
+
+typedef struct {
+    Gla3a* strips[LANES];       // NULL nelle corsie oltre l'ultima striscia
+    bool in_lanes[LANES];       // Lo stato del detector della striscia è nelle corsie, non nella Gla3a
+    LaneDetector det;
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    LaneSvfBank sc_lp, sc_hp;
+#else
+    LaneBiquadBank sc_lp_M, sc_lp_S, sc_hp_M, sc_hp_S;
+#endif
+    v8sf envelope_M, envelope_S;
+    v8sf gain_M, gain_S;
+} BatchGroup;
+
+struct Gla3aBatch {
+    uint32_t num_strips;
+    uint32_t num_groups;
+    uint32_t block_size;        // Campioni elaborati in un passo
+    BatchGroup* groups;
+    float* arena;
+    v8sf* lanes_M;              // Sidechain del gruppo, un v8sf per campione
+    v8sf* lanes_S;
+    float* silence;             // Ingresso delle corsie senza una striscia nelle corsie
+    float* discard_M;           // Uscita delle stesse corsie
+    float* discard_S;
+};
+
+static Gla3a* batch_strip(const Gla3aBatch* batch, uint32_t strip) {
+    return batch->groups[strip / LANES].strips[strip % LANES];
+}
+
+// Le corsie fanno solo il compressore a banda singola, in float; il resto passa da run_segment()
+static bool batch_lane_eligible(const Gla3a* self) {
+    return GLA3A_PRECISION == GLA3A_PRECISION_FLOAT && params_get(&self->params, GLA3A_BYPASS) <= 0.5f &&
+           self->ratio_mode != GLA3A_RATIO_LIMIT && self->crossover.num_bands <= 1;
+}
+
+// Copia lo stato del detector dalla Gla3a alla corsia (load) o indietro
+static void batch_lane_transfer(BatchGroup* g, int k, bool load) {
+    Gla3a* self = g->strips[k];
+    FilterReal* envelope[2] = { &self->detector_envelope_M, &self->detector_envelope_S };
+    FilterReal* gain[2] = { &self->current_gain_M, &self->current_gain_S };
+    v8sf* lane_envelope[2] = { &g->envelope_M, &g->envelope_S };
+    v8sf* lane_gain[2] = { &g->gain_M, &g->gain_S };
+    for (int c = 0; c < 2; ++c) {
+        if (load) {
+            (*lane_envelope[c])[k] = *envelope[c];
+            (*lane_gain[c])[k] = *gain[c];
+        } else {
+            *envelope[c] = (*lane_envelope[c])[k];
+            *gain[c] = (*lane_gain[c])[k];
+        }
+    }
+
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    for (int f = 0; f < 4; ++f) {
+        LaneSvfBank* lanes = (f < 2) ? &g->sc_lp : &g->sc_hp;
+        SvfBank* bank = (f < 2) ? &self->sc_lp_svf : &self->sc_hp_svf;
+        const int lane = (f & 1) ? LANE_S : LANE_M;
+        v8sf* lane_ic1 = (f & 1) ? lanes->ic1_S : lanes->ic1_M;
+        v8sf* lane_ic2 = (f & 1) ? lanes->ic2_S : lanes->ic2_M;
+        for (int i = 0; i < NUM_BIQUADS_FOR_6TH_ORDER; ++i) {
+            FilterReal* ic1 = (FilterReal*)&bank->ic1[i] + lane;
+            FilterReal* ic2 = (FilterReal*)&bank->ic2[i] + lane;
+            if (load) {
+                lane_ic1[i][k] = *ic1;
+                lane_ic2[i][k] = *ic2;
+            } else {
+                *ic1 = lane_ic1[i][k];
+                *ic2 = lane_ic2[i][k];
+            }
+        }
+    }
+#else
+    LaneBiquadBank* lanes[4] = { &g->sc_lp_M, &g->sc_lp_S, &g->sc_hp_M, &g->sc_hp_S };
+    for (int f = 0; f < 4; ++f) {
+        for (int i = 0; i < NUM_BIQUADS_FOR_6TH_ORDER; ++i) {
+#ifdef GLA3A_SCALAR_BIQUADS
+            BiquadFilter* filters[4] = { self->sc_lp_filters_M, self->sc_lp_filters_S,
+                                         self->sc_hp_filters_M, self->sc_hp_filters_S };
+            FilterReal* z1 = &filters[f][i].z1;
+            FilterReal* z2 = &filters[f][i].z2;
+#else
+            BiquadBank* bank = (f < 2) ? &self->sc_lp_bank : &self->sc_hp_bank;
+            const int lane = (f & 1) ? LANE_S : LANE_M;
+            FilterReal* z1 = (FilterReal*)&bank->z1[i] + lane;
+            FilterReal* z2 = (FilterReal*)&bank->z2[i] + lane;
+#endif
+            if (load) {
+                lanes[f]->z1[i][k] = *z1;
+                lanes[f]->z2[i][k] = *z2;
+            } else {
+                *z1 = lanes[f]->z1[i][k];
+                *z2 = lanes[f]->z2[i][k];
+            }
+        }
+    }
+#endif
+
+    // Lo stato è cambiato fuori da run_segment(): il riposo va ridimostrato
+    if (!load) self->idle = false;
+}
+
+// Parametri della corsia dalle grandezze derivate della Gla3a (dopo update_derived_params())
+static void batch_lane_configure(BatchGroup* g, int k) {
+    const Gla3a* self = g->strips[k];
+    const ParamState* ps = &self->params;
+    LaneDetector* det = &g->det;
+
+    // Stesse scelte di process_block()
+    const GLA3A_StereoLink link = (params_get(ps, GLA3A_MS_MODE_ACTIVE) > 0.5f) ? GLA3A_LINK_UNLINKED
+                                  : stereo_link_from_port(params_get(ps, GLA3A_STEREO_LINK));
+    det->attack_alpha[k] = self->detector_attack_alpha;
+    det->release_alpha[k] = self->detector_release_alpha;
+    det->gain_smooth_alpha[k] = self->gain_smooth_alpha;
+    det->threshold_db[k] = self->current_threshold_db;
+    det->make_up_gain_linear[k] = self->make_up_gain_linear;
+    det->link_amount[k] = params_get(ps, GLA3A_LINK_AMOUNT);
+    det->linked[k] = (link == GLA3A_LINK_LINKED) ? -1 : 0;
+    det->blend[k] = (link == GLA3A_LINK_BLEND) ? -1 : 0;
+    det->link_sum[k] = (params_get(ps, GLA3A_LINK_DETECTOR) > 0.5f) ? -1 : 0;
+    det->gain_computer[k] = &self->gain_computer;
+
+    // Con il detector collegato il banco M/S filtra silenzio sulla corsia S, mentre il percorso
+    // scalare lascia fermi i filtri S: la corsia fa lo stesso del plugin compilato allo stesso modo
+    const bool lp_on = params_get(ps, GLA3A_SC_LP_ON) > 0.5f;
+    const bool hp_on = params_get(ps, GLA3A_SC_HP_ON) > 0.5f;
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    // Gli SVF non hanno la versione scalare: M e S filtrano sempre insieme
+    g->sc_lp.on[k] = lp_on ? -1 : 0;
+    g->sc_hp.on[k] = hp_on ? -1 : 0;
+    lane_svf_bank_set(&g->sc_lp, k, &self->sc_lp_svf);
+    lane_svf_bank_set(&g->sc_hp, k, &self->sc_hp_svf);
+#else
+#ifdef GLA3A_SCALAR_BIQUADS
+    const bool side_runs = (link != GLA3A_LINK_LINKED);
+#else
+    const bool side_runs = true;
+#endif
+    g->sc_lp_M.on[k] = lp_on ? -1 : 0;
+    g->sc_lp_S.on[k] = (lp_on && side_runs) ? -1 : 0;
+    g->sc_hp_M.on[k] = hp_on ? -1 : 0;
+    g->sc_hp_S.on[k] = (hp_on && side_runs) ? -1 : 0;
+    for (int i = 0; i < NUM_BIQUADS_FOR_6TH_ORDER; ++i) {
+        const BiquadFilter* lp = &self->sc_lp_filters_M[i];
+        const BiquadFilter* hp = &self->sc_hp_filters_M[i];
+        lane_biquad_bank_set_stage(&g->sc_lp_M, k, i, lp->b0, lp->b1, lp->b2, lp->a1, lp->a2);
+        lane_biquad_bank_set_stage(&g->sc_lp_S, k, i, lp->b0, lp->b1, lp->b2, lp->a1, lp->a2);
+        lane_biquad_bank_set_stage(&g->sc_hp_M, k, i, hp->b0, hp->b1, hp->b2, hp->a1, hp->a2);
+        lane_biquad_bank_set_stage(&g->sc_hp_S, k, i, hp->b0, hp->b1, hp->b2, hp->a1, hp->a2);
+    }
+#endif
+}
+
+// Detector del gruppo sulle corsie: stessi stadi di process_block() a banda singola
+static void batch_detector(Gla3aBatch* batch, BatchGroup* g, const float* const in_M[LANES], const float* const in_S[LANES],
+                           float* const audio_M[LANES], float* const audio_S[LANES], uint32_t n) {
+    const LaneDetector* det = &g->det;
+    v8sf* sc_M = batch->lanes_M;
+    v8sf* sc_S = batch->lanes_S;
+
+    stage_rectify_lanes(in_M, in_S, sc_M, sc_S, n, det);
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    lane_svf_bank_process<SVF_LOWPASS>(&g->sc_lp, sc_M, sc_S, n);
+    lane_svf_bank_process<SVF_HIGHPASS>(&g->sc_hp, sc_M, sc_S, n);
+#else
+    lane_biquad_bank_process(&g->sc_lp_M, sc_M, n);
+    lane_biquad_bank_process(&g->sc_lp_S, sc_S, n);
+    lane_biquad_bank_process(&g->sc_hp_M, sc_M, n);
+    lane_biquad_bank_process(&g->sc_hp_S, sc_S, n);
+#endif
+
+    stage_envelope_lanes(sc_M, n, &g->envelope_M, det);
+    stage_envelope_lanes(sc_S, n, &g->envelope_S, det);
+    stage_link_blend_lanes(sc_M, sc_S, n, det);
+
+    stage_gain_computer_lanes(sc_M, n, det);
+    stage_gain_computer_lanes(sc_S, n, det);
+    stage_gain_smooth_lanes(sc_M, n, &g->gain_M, det);
+    stage_gain_smooth_lanes(sc_S, n, &g->gain_S, det);
+    stage_apply_lanes(audio_M, audio_S, sc_M, sc_S, n, det);
+
+    // Il canale S riparte dal detector collegato se si torna a detector separati
+    g->envelope_S = v8sf_select(det->linked, g->envelope_M, g->envelope_S);
+    g->gain_S = v8sf_select(det->linked, g->gain_M, g->gain_S);
+
+    // Come flush_denormal_state() per la parte di stato che vive nelle corsie
+    g->envelope_M = flush_denormal_v8(g->envelope_M);
+    g->envelope_S = flush_denormal_v8(g->envelope_S);
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+    lane_svf_bank_flush_denormals(&g->sc_lp);
+    lane_svf_bank_flush_denormals(&g->sc_hp);
+#else
+    lane_biquad_bank_flush_denormals(&g->sc_lp_M);
+    lane_biquad_bank_flush_denormals(&g->sc_lp_S);
+    lane_biquad_bank_flush_denormals(&g->sc_hp_M);
+    lane_biquad_bank_flush_denormals(&g->sc_hp_S);
+#endif
+}
+
+// Elabora [offset, offset + n) delle strisce di un gruppo (n <= block_size)
+static void batch_process_group(Gla3aBatch* batch, BatchGroup* g, uint32_t first_strip,
+                                const float* const* in_l, const float* const* in_r,
+                                float* const* out_l, float* const* out_r, uint32_t offset, uint32_t n) {
+    const float* lane_in_M[LANES];
+    const float* lane_in_S[LANES];
+    float* lane_audio_M[LANES];
+    float* lane_audio_S[LANES];
+    bool any_lane = false;
+
+    for (int k = 0; k < LANES; ++k) {
+        lane_in_M[k] = lane_in_S[k] = batch->silence;
+        lane_audio_M[k] = batch->discard_M;
+        lane_audio_S[k] = batch->discard_S;
+
+        Gla3a* self = g->strips[k];
+        if (!self) continue;
+        const uint32_t strip = first_strip + k;
+        self->audio_in_l_ptr = in_l[strip] + offset;
+        self->audio_in_r_ptr = in_r[strip] + offset;
+        self->audio_out_l_ptr = out_l[strip] + offset;
+        self->audio_out_r_ptr = out_r[strip] + offset;
+
+        const bool changed = self->params.dirty != 0;
+        if (changed) self->idle = false;
+        update_derived_params(self);
+
+        if (!batch_lane_eligible(self)) {
+            if (g->in_lanes[k]) {
+                batch_lane_transfer(g, k, false);
+                g->in_lanes[k] = false;
+            }
+            run_segment(self, 0, n);
+            continue;
+        }
+        if (!g->in_lanes[k]) {
+            batch_lane_transfer(g, k, true);
+            batch_lane_configure(g, k);
+            g->in_lanes[k] = true;
+        } else if (changed) {
+            batch_lane_configure(g, k);
+        }
+
+        bypass_delay_write(self, self->audio_in_l_ptr, self->audio_in_r_ptr, n);
+        process_front(self, self->audio_in_l_ptr, self->audio_in_r_ptr, n);
+        lane_in_M[k] = lane_audio_M[k] = self->base_buffer_M;
+        lane_in_S[k] = lane_audio_S[k] = self->base_buffer_S;
+        any_lane = true;
+    }
+    if (!any_lane) return;
+
+    batch_detector(batch, g, lane_in_M, lane_in_S, lane_audio_M, lane_audio_S, n);
+
+    for (int k = 0; k < LANES; ++k) {
+        Gla3a* self = g->strips[k];
+        if (!self || !g->in_lanes[k]) continue;
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+        // Il glide dei filtri della sidechain è andato avanti nelle corsie
+        lane_svf_bank_get(&g->sc_lp, k, &self->sc_lp_svf);
+        lane_svf_bank_get(&g->sc_hp, k, &self->sc_hp_svf);
+#endif
+        process_back(self, self->audio_out_l_ptr, self->audio_out_r_ptr, n);
+        flush_denormal_state(self);
+    }
+}
+
+void gla3a_batch_free(Gla3aBatch* batch) {
+    if (!batch) return;
+    for (uint32_t s = 0; batch->groups && s < batch->num_strips; ++s) {
+        Gla3a* self = batch_strip(batch, s);
+        if (self) cleanup(self);
+    }
+    free(batch->groups);
+    free(batch->arena);
+    free(batch);
+}
+
+Gla3aBatch* gla3a_batch_new(double samplerate, uint32_t num_strips, uint32_t max_block_length) {
+    if (num_strips == 0) return NULL;
+    Gla3aBatch* batch = (Gla3aBatch*)calloc(1, sizeof(Gla3aBatch));
+    if (!batch) return NULL;
+
+    uint32_t block_size = max_block_length ? max_block_length : DEFAULT_BLOCK_SIZE;
+    if (block_size > MAX_CHUNK_SIZE) block_size = MAX_CHUNK_SIZE;
+    batch->num_strips = num_strips;
+    batch->num_groups = (num_strips + LANES - 1) / LANES;
+    batch->block_size = block_size;
+
+    // Gruppi (con stati v8sf) e buffer allineati a 64 byte, come la struct del plugin
+    const size_t lanes = arena_slot((size_t)block_size * LANES);
+    const size_t base = arena_slot(block_size);
+    const size_t total = 2 * lanes + 3 * base;
+    if (posix_memalign((void**)&batch->groups, 64, batch->num_groups * sizeof(BatchGroup)) != 0 ||
+        posix_memalign((void**)&batch->arena, 64, total * sizeof(float)) != 0) {
+        gla3a_batch_free(batch);
+        return NULL;
+    }
+    memset(batch->groups, 0, batch->num_groups * sizeof(BatchGroup));
+    memset(batch->arena, 0, total * sizeof(float));
+
+    float* p = batch->arena;
+    batch->lanes_M = (v8sf*)p;  p += lanes;
+    batch->lanes_S = (v8sf*)p;  p += lanes;
+    batch->silence = p;         p += base;
+    batch->discard_M = p;       p += base;
+    batch->discard_S = p;       p += base;
+
+    const LV2_Feature* const no_features[] = { NULL };
+    for (uint32_t s = 0; s < num_strips; ++s) {
+        Gla3a* self = create_instance(samplerate, no_features, block_size);
+        if (!self) {
+            gla3a_batch_free(batch);
+            return NULL;
+        }
+        batch->groups[s / LANES].strips[s % LANES] = self;
+        for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+            params_set(&self->params, gla3a_parameters[i].port, gla3a_parameters[i].default_value);
+        }
+        activate(self);
+    }
+
+    // Le corsie vuote leggono comunque una curva valida (quella della prima striscia del gruppo)
+    for (uint32_t g = 0; g < batch->num_groups; ++g) {
+        BatchGroup* group = &batch->groups[g];
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+        lane_svf_bank_init(&group->sc_lp);
+        lane_svf_bank_init(&group->sc_hp);
+#else
+        lane_biquad_bank_init(&group->sc_lp_M);
+        lane_biquad_bank_init(&group->sc_lp_S);
+        lane_biquad_bank_init(&group->sc_hp_M);
+        lane_biquad_bank_init(&group->sc_hp_S);
+#endif
+        for (int k = 0; k < LANES; ++k) group->det.gain_computer[k] = &group->strips[0]->gain_computer;
+    }
+    return batch;
+}
+
+void gla3a_batch_reset(Gla3aBatch* batch) {
+    for (uint32_t s = 0; s < batch->num_strips; ++s) {
+        activate(batch_strip(batch, s));
+        batch->groups[s / LANES].in_lanes[s % LANES] = false; // Le corsie si ricaricano dalla Gla3a azzerata
+    }
+}
+
+bool gla3a_batch_set_param(Gla3aBatch* batch, uint32_t strip, GLA3A_PortIndex port, float value) {
+    if (strip >= batch->num_strips) return false;
+    // Solo le porte di gla3a_parameters[], come per i patch:Set (handle_event())
+    for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+        if (gla3a_parameters[i].port == port) {
+            params_set(&batch_strip(batch, strip)->params, port, value);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t gla3a_batch_latency(const Gla3aBatch* batch, uint32_t strip) {
+    if (strip >= batch->num_strips) return 0;
+    return current_latency(batch_strip(batch, strip));
+}
+
+void gla3a_batch_process(Gla3aBatch* batch, const float* const* in_l, const float* const* in_r,
+                         float* const* out_l, float* const* out_r, uint32_t n) {
+    DenormalGuard denormal_guard;
+    denormal_guard_enter(&denormal_guard);
+
+    for (uint32_t offset = 0; offset < n; offset += batch->block_size) {
+        const uint32_t remaining = n - offset;
+        const uint32_t chunk = (remaining < batch->block_size) ? remaining : batch->block_size;
+        for (uint32_t g = 0; g < batch->num_groups; ++g) {
+            batch_process_group(batch, &batch->groups[g], g * LANES, in_l, in_r, out_l, out_r, offset, chunk);
+        }
+    }
+
+    denormal_guard_leave(&denormal_guard);
+}
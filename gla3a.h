@@ -28,9 +28,106 @@ typedef enum {
     GLA3A_AUDIO_IN_L = 14,
     GLA3A_AUDIO_IN_R = 15,
     GLA3A_AUDIO_OUT_L = 16,
-    GLA3A_AUDIO_OUT_R = 17
+    GLA3A_AUDIO_OUT_R = 17,
+    GLA3A_OVERSAMPLING = 18,     // Fattore di oversampling (0=1x, 1=2x, 2=4x, 3=8x)
+    GLA3A_OS_MODE = 19,          // Filtri di oversampling (0=Fase Lineare, 1=Bassa Latenza)
+    GLA3A_LATENCY = 20,          // Output: latenza riportata all'host (campioni)
+    GLA3A_LOOKAHEAD = 21,        // Lookahead del limiter in modalità Limit (ms)
+    GLA3A_BANDS = 22,            // Numero di bande del compressore (1 = banda singola, fino a 4)
+    GLA3A_CROSSOVER_1 = 23,      // Frequenze di crossover (Hz), in ordine crescente
+    GLA3A_CROSSOVER_2 = 24,
+    GLA3A_CROSSOVER_3 = 25,
+    GLA3A_BAND_1_OFFSET = 26,    // Offset di soglia per banda (dB, relativo alla Peak Reduction)
+    GLA3A_BAND_2_OFFSET = 27,
+    GLA3A_BAND_3_OFFSET = 28,
+    GLA3A_BAND_4_OFFSET = 29,
+    GLA3A_STEREO_LINK = 30,      // Collegamento dei detector in L/R (0=Scollegati, 1=Collegati, 2=Misto)
+    GLA3A_LINK_DETECTOR = 31,    // Livello dei detector collegati (0=Massimo, 1=Somma)
+    GLA3A_LINK_AMOUNT = 32,      // Quanto del livello collegato entra in ogni canale, in modalità Misto
+    GLA3A_CONTROL = 33,          // Ingresso atom: eventi patch:Set sui parametri, con il loro timestamp
+    GLA3A_NOTIFY = 34            // Uscita atom: frame dei meter per la GUI (GLA3A_METER_FRAME_URI)
 } GLA3A_PortIndex;
 
+#define GLA3A_NUM_PORTS 35
+
+// Calibrazione delle porte in dB: Peak Reduction (0..1) va sulla soglia da MIN a MAX, Gain (0..1)
+// sul guadagno di uscita da 0 a MAX. Le usano il DSP e la GUI, che mostra i knob in dB.
+#define GLA3A_PEAK_REDUCTION_MIN_DB -60.0f // Soglia min per Peak Reduction (più compressione)
+#define GLA3A_PEAK_REDUCTION_MAX_DB -10.0f // Soglia max per Peak Reduction (meno compressione)
+#define GLA3A_GAIN_MAX_DB 12.0f            // Guadagno massimo applicabile in dB
+
+// URI dei parametri, per i patch:Set sulla porta GLA3A_CONTROL (GUI e automazione dell'host).
+// Ogni parametro corrisponde a una porta di controllo in ingresso e usa le sue stesse unità.
+#define GLA3A_PARAM_PREFIX GLA3A_URI "#"
+
+typedef struct {
+    GLA3A_PortIndex port;
+    const char* uri;
+    float default_value; // lv2:default della porta in gla3a.ttl
+} GLA3A_Parameter;
+
+static const GLA3A_Parameter gla3a_parameters[] = {
+    { GLA3A_PEAK_REDUCTION,  GLA3A_PARAM_PREFIX "peakReduction", 0.0f },
+    { GLA3A_GAIN,            GLA3A_PARAM_PREFIX "gain",          0.0f },
+    { GLA3A_METER,           GLA3A_PARAM_PREFIX "meter",         0.0f },
+    { GLA3A_BYPASS,          GLA3A_PARAM_PREFIX "bypass",        0.0f },
+    { GLA3A_MS_MODE_ACTIVE,  GLA3A_PARAM_PREFIX "msMode",        0.0f },
+    { GLA3A_RATIO_MODE,      GLA3A_PARAM_PREFIX "ratioMode",     0.0f },
+    { GLA3A_SC_LP_ON,        GLA3A_PARAM_PREFIX "scLpOn",        0.0f },
+    { GLA3A_SC_LP_FREQ,      GLA3A_PARAM_PREFIX "scLpFq",        2000.0f },
+    { GLA3A_SC_LP_Q,         GLA3A_PARAM_PREFIX "scLpQ",         0.707f },
+    { GLA3A_SC_HP_ON,        GLA3A_PARAM_PREFIX "scHpOn",        0.0f },
+    { GLA3A_SC_HP_FREQ,      GLA3A_PARAM_PREFIX "scHpFq",        100.0f },
+    { GLA3A_SC_HP_Q,         GLA3A_PARAM_PREFIX "scHpQ",         0.707f },
+    { GLA3A_OVERSAMPLING,    GLA3A_PARAM_PREFIX "oversampling",  2.0f },
+    { GLA3A_OS_MODE,         GLA3A_PARAM_PREFIX "osMode",        0.0f },
+    { GLA3A_LOOKAHEAD,       GLA3A_PARAM_PREFIX "lookahead",     5.0f },
+    { GLA3A_BANDS,           GLA3A_PARAM_PREFIX "bands",         1.0f },
+    { GLA3A_CROSSOVER_1,     GLA3A_PARAM_PREFIX "crossover1",    200.0f },
+    { GLA3A_CROSSOVER_2,     GLA3A_PARAM_PREFIX "crossover2",    1000.0f },
+    { GLA3A_CROSSOVER_3,     GLA3A_PARAM_PREFIX "crossover3",    5000.0f },
+    { GLA3A_BAND_1_OFFSET,   GLA3A_PARAM_PREFIX "band1Offset",   0.0f },
+    { GLA3A_BAND_2_OFFSET,   GLA3A_PARAM_PREFIX "band2Offset",   0.0f },
+    { GLA3A_BAND_3_OFFSET,   GLA3A_PARAM_PREFIX "band3Offset",   0.0f },
+    { GLA3A_BAND_4_OFFSET,   GLA3A_PARAM_PREFIX "band4Offset",   0.0f },
+    { GLA3A_STEREO_LINK,     GLA3A_PARAM_PREFIX "stereoLink",    0.0f },
+    { GLA3A_LINK_DETECTOR,   GLA3A_PARAM_PREFIX "linkDetector",  0.0f },
+    { GLA3A_LINK_AMOUNT,     GLA3A_PARAM_PREFIX "linkAmount",    0.5f },
+};
+
+#define GLA3A_NUM_PARAMETERS (sizeof(gla3a_parameters) / sizeof(gla3a_parameters[0]))
+
+// Banco di preset interno: un patch:Set su GLA3A_PRESET_URI (numero, 0 .. GLA3A_NUM_PRESETS-1)
+// richiama un preset al suo timestamp, uno su GLA3A_PRESET_STORE_URI salva nello slot i valori
+// correnti dei parametri. Il numero si arrotonda al più vicino; fuori dal banco non fa nulla. Banco e parametri fanno parte dello stato del plugin (state:interface);
+// nello stato il banco è GLA3A_PRESET_BANK_URI, un atom:Vector di atom:Float con i preset uno dopo
+// l'altro e i parametri nell'ordine di gla3a_parameters[].
+#define GLA3A_NUM_PRESETS 8
+#define GLA3A_PRESET_URI       GLA3A_PARAM_PREFIX "preset"
+#define GLA3A_PRESET_STORE_URI GLA3A_PARAM_PREFIX "presetStore"
+#define GLA3A_PRESET_BANK_URI  GLA3A_PARAM_PREFIX "presetBank"
+
+// Meter per la GUI sulla porta GLA3A_NOTIFY: ogni 1/GLA3A_METER_RATE_HZ secondi un evento
+// atom:Object di tipo GLA3A_METER_FRAME_URI, con in GLA3A_METER_VALUES_URI un atom:Vector di
+// GLA3A_METER_NUM_VALUES atom:Float nell'ordine di GLA3A_MeterValue. Picchi e RMS sono quelli della
+// finestra appena chiusa in dBFS, la GR la massima della finestra in dB positivi.
+#define GLA3A_METER_RATE_HZ 30.0
+#define GLA3A_METER_FRAME_URI  GLA3A_PARAM_PREFIX "meterFrame"
+#define GLA3A_METER_VALUES_URI GLA3A_PARAM_PREFIX "meterValues"
+
+typedef enum {
+    GLA3A_METER_IN_PEAK_L = 0,
+    GLA3A_METER_IN_PEAK_R,
+    GLA3A_METER_IN_RMS_L,
+    GLA3A_METER_IN_RMS_R,
+    GLA3A_METER_OUT_PEAK_L,
+    GLA3A_METER_OUT_PEAK_R,
+    GLA3A_METER_OUT_RMS_L,
+    GLA3A_METER_OUT_RMS_R,
+    GLA3A_METER_GR,
+    GLA3A_METER_NUM_VALUES
+} GLA3A_MeterValue;
+
 // Enum per le modalità di ratio (per chiarezza nel codice C++)
 typedef enum {
     GLA3A_RATIO_3_TO_1 = 0,
@@ -39,4 +136,19 @@ typedef enum {
     GLA3A_RATIO_LIMIT  = 3
 } GLA3A_RatioMode;
 
+// Enum per il collegamento stereo dei detector (valore della porta GLA3A_STEREO_LINK)
+typedef enum {
+    GLA3A_LINK_UNLINKED = 0,   // Un detector e un gain computer per canale
+    GLA3A_LINK_LINKED   = 1,   // Un solo detector e gain computer, stesso guadagno sui due canali
+    GLA3A_LINK_BLEND    = 2    // Detector per canale, mescolati con il livello collegato
+} GLA3A_StereoLink;
+
+// Enum per i fattori di oversampling (valore della porta GLA3A_OVERSAMPLING)
+typedef enum {
+    GLA3A_OS_1X = 0,
+    GLA3A_OS_2X = 1,
+    GLA3A_OS_4X = 2,
+    GLA3A_OS_8X = 3
+} GLA3A_OversamplingFactor;
+
 #endif // GLA3A_H
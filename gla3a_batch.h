@@ -0,0 +1,42 @@
+#ifndef GLA3A_BATCH_H
+#define GLA3A_BATCH_H
+
+// --- API a Blocchi: Più Strisce in una Chiamata ---
+// Per i mixer con una GLA3A su ogni canale: invece di un'istanza LV2 per canale, un solo oggetto
+// elabora num_strips strisce stereo indipendenti per ogni chiamata. Le strisce vanno a gruppi di
+// LANES (gla3a_lanes.h) e il detector di tutto il gruppo (filtri della sidechain, envelope, gain
+// computer, smoothing) avanza con le stesse istruzioni, una corsia SIMD per striscia.
+// Ogni striscia ha gli stessi parametri (indicizzati come le porte, GLA3A_PortIndex) e la stessa
+// uscita, bit per bit, di un'istanza del plugin che riceve gli stessi valori sulle porte e
+// blocchi della stessa lunghezza (bufsz:maxBlockLength = max_block_length).
+// Le strisce in modalità Limit, multibanda o in bypass restano corrette ma si elaborano da sole,
+// come un'istanza del plugin. I meter (output RMS, gain reduction) non si calcolano.
+// Come per il plugin: new/free non sono real-time, set_param e process sì (nessuna allocazione).
+
+#include "gla3a.h"
+#include <stdint.h>
+
+typedef struct Gla3aBatch Gla3aBatch;
+
+// Crea num_strips strisce già attivate, con i parametri ai default di gla3a.ttl.
+// max_block_length: campioni massimi elaborati in un solo passo (le chiamate più lunghe vanno a
+// pezzi). Ritorna NULL con num_strips a 0 o se l'allocazione fallisce.
+Gla3aBatch* gla3a_batch_new(double samplerate, uint32_t num_strips, uint32_t max_block_length);
+void gla3a_batch_free(Gla3aBatch* batch);
+
+// Azzera lo stato di tutte le strisce (come activate() del plugin); i parametri restano
+void gla3a_batch_reset(Gla3aBatch* batch);
+
+// Imposta un parametro di una striscia: vale dalla prossima gla3a_batch_process(). false (e nessun
+// effetto) se la striscia non esiste o la porta non è un parametro (audio, latenza, meter, atom).
+bool gla3a_batch_set_param(Gla3aBatch* batch, uint32_t strip, GLA3A_PortIndex port, float value);
+
+// Latenza della striscia in campioni (la porta GLA3A_LATENCY del plugin)
+uint32_t gla3a_batch_latency(const Gla3aBatch* batch, uint32_t strip);
+
+// Elabora n campioni di tutte le strisce: un puntatore per striscia per ogni canale.
+// Ingresso e uscita della stessa striscia possono coincidere (elaborazione sul posto).
+void gla3a_batch_process(Gla3aBatch* batch, const float* const* in_l, const float* const* in_r,
+                         float* const* out_l, float* const* out_r, uint32_t n);
+
+#endif // GLA3A_BATCH_H
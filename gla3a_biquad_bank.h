@@ -0,0 +1,152 @@
+#ifndef GLA3A_BIQUAD_BANK_H
+#define GLA3A_BIQUAD_BANK_H
+
+// --- Banco di Biquad Stereo Vettoriale ---
+// Cascata di biquad con gli stessi coefficienti su M e S: entrambi gli stati vivono nello stesso
+// registro, quindi ogni istruzione avanza i due canali insieme.
+// Le operazioni sono le stesse (e nello stesso ordine) di biquad_process() in gla3a.cpp,
+// che resta l'implementazione di riferimento. Coefficienti e stati sono FilterReal
+// (gla3a_precision.h): in double il registro tiene solo M e S.
+
+#include "gla3a_denormal.h"
+#include "gla3a_kernels.h"
+#include "gla3a_precision.h"
+#include "gla3a_simd.h"
+#include <stdint.h>
+
+#define BIQUAD_BANK_MAX_STAGES 3
+
+typedef struct {
+    int   num_stages;
+    vreal b0[BIQUAD_BANK_MAX_STAGES];
+    vreal b1[BIQUAD_BANK_MAX_STAGES];
+    vreal b2[BIQUAD_BANK_MAX_STAGES];
+    vreal a1[BIQUAD_BANK_MAX_STAGES];
+    vreal a2[BIQUAD_BANK_MAX_STAGES];
+    vreal z1[BIQUAD_BANK_MAX_STAGES];
+    vreal z2[BIQUAD_BANK_MAX_STAGES];
+} BiquadBank;
+
+static void biquad_bank_reset(BiquadBank* bank) {
+    for (int k = 0; k < BIQUAD_BANK_MAX_STAGES; ++k) {
+        bank->z1[k] = vreal_set1(0);
+        bank->z2[k] = vreal_set1(0);
+    }
+}
+
+static void biquad_bank_init(BiquadBank* bank, int num_stages) {
+    bank->num_stages = num_stages;
+    for (int k = 0; k < BIQUAD_BANK_MAX_STAGES; ++k) {
+        bank->b0[k] = bank->b1[k] = bank->b2[k] = vreal_set1(0);
+        bank->a1[k] = bank->a2[k] = vreal_set1(0);
+    }
+    biquad_bank_reset(bank);
+}
+
+// Azzera gli stati decaduti sotto DENORMAL_FLUSH_THRESHOLD (a fine blocco)
+static inline void biquad_bank_flush_denormals(BiquadBank* bank) {
+    flush_denormals_vreal(bank->z1, bank->num_stages);
+    flush_denormals_vreal(bank->z2, bank->num_stages);
+}
+
+// Vero se la cascata è a riposo: con ingresso nullo l'uscita resta nulla e lo stato non cambia
+static inline bool biquad_bank_is_silent(const BiquadBank* bank) {
+    return vreal_all_zero(bank->z1, bank->num_stages) && vreal_all_zero(bank->z2, bank->num_stages);
+}
+
+// Copia (in broadcast su tutte le corsie) i coefficienti normalizzati di uno stadio
+static void biquad_bank_set_stage(BiquadBank* bank, int stage, FilterReal b0, FilterReal b1, FilterReal b2,
+                                  FilterReal a1, FilterReal a2) {
+    bank->b0[stage] = vreal_set1(b0);
+    bank->b1[stage] = vreal_set1(b1);
+    bank->b2[stage] = vreal_set1(b2);
+    bank->a1[stage] = vreal_set1(a1);
+    bank->a2[stage] = vreal_set1(a2);
+}
+
+// Copia numero di stadi e coefficienti da un altro banco; gli stati restano quelli di 'bank'
+static inline void biquad_bank_copy_coeffs(BiquadBank* bank, const BiquadBank* from) {
+    bank->num_stages = from->num_stages;
+    for (int k = 0; k < BIQUAD_BANK_MAX_STAGES; ++k) {
+        bank->b0[k] = from->b0[k];
+        bank->b1[k] = from->b1[k];
+        bank->b2[k] = from->b2[k];
+        bank->a1[k] = from->a1[k];
+        bank->a2[k] = from->a2[k];
+    }
+}
+
+static inline vreal biquad_bank_tick(BiquadBank* bank, vreal in) {
+    for (int k = 0; k < bank->num_stages; ++k) {
+        vreal out = in * bank->b0[k] + bank->z1[k];
+        bank->z1[k] = in * bank->b1[k] + bank->z2[k] - bank->a1[k] * out;
+        bank->z2[k] = in * bank->b2[k] - bank->a2[k] * out;
+        in = out;
+    }
+    return in;
+}
+
+// Filtra sul posto un blocco di campioni M e S del detector
+static inline void biquad_bank_process(BiquadBank* bank, DetectorReal* buf_M, DetectorReal* buf_S, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        vreal y = biquad_bank_tick(bank, vreal_pack_ms(buf_M[i], buf_S[i]));
+        buf_M[i] = y[LANE_M];
+        buf_S[i] = y[LANE_S];
+    }
+}
+
+// Filtra sul posto un solo canale (corsia M; la corsia S riceve silenzio)
+static inline void biquad_bank_process_mono(BiquadBank* bank, DetectorReal* buf, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        buf[i] = biquad_bank_tick(bank, vreal_pack_ms(buf[i], 0))[LANE_M];
+    }
+}
+
+
+// --- Kernel Specializzati (gla3a_kernels.h) ---
+
+// Come biquad_bank_tick() con il numero di stadi noto a compilazione (loop srotolato)
+template <int STAGES>
+static inline vreal biquad_bank_tick_n(BiquadBank* bank, vreal in) {
+#pragma GCC unroll 4
+    for (int k = 0; k < STAGES; ++k) {
+        vreal out = in * bank->b0[k] + bank->z1[k];
+        bank->z1[k] = in * bank->b1[k] + bank->z2[k] - bank->a1[k] * out;
+        bank->z2[k] = in * bank->b2[k] - bank->a2[k] * out;
+        in = out;
+    }
+    return in;
+}
+
+// Due cascate una dopo l'altra (LowPass e HighPass della sidechain) in un solo passo sul blocco,
+// con gli stadi di ognuna noti a compilazione (0 = cascata spenta); buf_S == NULL per un canale solo.
+// I banchi si copiano in locale: senza aliasing con i buffer coefficienti e stati non si rileggono
+// a ogni campione. Per campione i conti sono quelli di biquad_bank_process() sui due banchi.
+template <int STAGES_A, int STAGES_B>
+static void biquad_bank_process_chain(BiquadBank* a, BiquadBank* b, DetectorReal* buf_M, DetectorReal* buf_S, uint32_t n) {
+    BiquadBank la = *a;
+    BiquadBank lb = *b;
+    if (buf_S) {
+        for (uint32_t i = 0; i < n; ++i) {
+            vreal y = biquad_bank_tick_n<STAGES_A>(&la, vreal_pack_ms(buf_M[i], buf_S[i]));
+            y = biquad_bank_tick_n<STAGES_B>(&lb, y);
+            buf_M[i] = y[LANE_M];
+            buf_S[i] = y[LANE_S];
+        }
+    } else {
+        for (uint32_t i = 0; i < n; ++i) {
+            vreal y = biquad_bank_tick_n<STAGES_A>(&la, vreal_pack_ms(buf_M[i], 0));
+            buf_M[i] = biquad_bank_tick_n<STAGES_B>(&lb, y)[LANE_M];
+        }
+    }
+    for (int k = 0; k < STAGES_A; ++k) {
+        a->z1[k] = la.z1[k];
+        a->z2[k] = la.z2[k];
+    }
+    for (int k = 0; k < STAGES_B; ++k) {
+        b->z1[k] = lb.z1[k];
+        b->z2[k] = lb.z2[k];
+    }
+}
+
+#endif // GLA3A_BIQUAD_BANK_H
@@ -0,0 +1,113 @@
+#ifndef GLA3A_DENORMAL_H
+#define GLA3A_DENORMAL_H
+
+// --- Protezione dai Denormali ---
+// Quando l'audio si ferma gli stati ricorsivi (biquad, celle allpass, envelope, meter) decadono
+// verso zero e finiscono tra i float denormali: su x86 ogni operazione su un denormale costa
+// decine di cicli, e la CPU sale proprio quando la traccia tace.
+// Due difese, indipendenti:
+//  1. DenormalGuard: FTZ/DAZ accesi all'ingresso di run() e ripristinati all'uscita. Il registro
+//     di controllo appartiene al thread dell'host e va lasciato come l'abbiamo trovato.
+//  2. flush espliciti a fine blocco: gli stati sotto DENORMAL_FLUSH_THRESHOLD vanno a zero, così
+//     un filtro a riposo si ferma davvero anche dove FTZ non c'è (ARM32 senza NEON, GLA3A_DENORMAL_GUARD=0).
+// La soglia è ben sopra i denormali (~1.2e-38) e ben sotto qualunque segnale (-600 dB): un
+// azzeramento non cambia l'uscita, e non dipende da dove l'host spezza i blocchi.
+
+#include "gla3a_precision.h"
+#include "gla3a_simd.h"
+#include <math.h>
+#include <stdint.h>
+
+#if defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#endif
+
+// Compilare con -DGLA3A_DENORMAL_GUARD=0 per lasciare il registro di controllo all'host.
+#ifndef GLA3A_DENORMAL_GUARD
+#define GLA3A_DENORMAL_GUARD 1
+#endif
+
+#define DENORMAL_FLUSH_THRESHOLD 1e-30f
+
+#define DENORMAL_MXCSR_FTZ (1u << 15) // Flush-to-zero dei risultati
+#define DENORMAL_MXCSR_DAZ (1u << 6)  // Denormali in ingresso letti come zero
+#define DENORMAL_FPCR_FZ   (1ull << 24) // AArch64: entrambe le cose con un solo bit
+
+
+// --- FTZ/DAZ per la Durata di run() ---
+
+typedef struct {
+    uint64_t saved; // Registro di controllo trovato all'ingresso
+} DenormalGuard;
+
+static inline void denormal_guard_enter(DenormalGuard* guard) {
+    guard->saved = 0;
+#if GLA3A_DENORMAL_GUARD
+#if defined(__SSE__) || defined(__x86_64__)
+    const uint32_t csr = _mm_getcsr();
+    guard->saved = csr;
+    _mm_setcsr(csr | DENORMAL_MXCSR_FTZ | DENORMAL_MXCSR_DAZ);
+#elif defined(__aarch64__)
+    uint64_t fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    guard->saved = fpcr;
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr | DENORMAL_FPCR_FZ));
+#endif
+#endif
+}
+
+static inline void denormal_guard_leave(const DenormalGuard* guard) {
+#if GLA3A_DENORMAL_GUARD
+#if defined(__SSE__) || defined(__x86_64__)
+    _mm_setcsr((uint32_t)guard->saved);
+#elif defined(__aarch64__)
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(guard->saved));
+#endif
+#else
+    (void)guard;
+#endif
+}
+
+
+// --- Azzeramento Esplicito degli Stati ---
+
+static inline float flush_denormal(float x) {
+    return (fabsf(x) < DENORMAL_FLUSH_THRESHOLD) ? 0.0f : x;
+}
+
+static inline double flush_denormal(double x) {
+    return (fabs(x) < DENORMAL_FLUSH_THRESHOLD) ? 0.0 : x;
+}
+
+static inline v4sf flush_denormal_v4(v4sf x) {
+    const v4si abs_mask = { 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF };
+    const v4si keep = (v4sf)((v4si)x & abs_mask) >= v4sf_set1(DENORMAL_FLUSH_THRESHOLD);
+    return (v4sf)((v4si)x & keep);
+}
+
+static inline void flush_denormals_v4(v4sf* state, int count) {
+    for (int k = 0; k < count; ++k) state[k] = flush_denormal_v4(state[k]);
+}
+
+// Stati dei banchi di biquad (gla3a_precision.h): in float è flush_denormals_v4()
+static inline void flush_denormals_vreal(vreal* state, int count) {
+#if GLA3A_PRECISION == GLA3A_PRECISION_FLOAT
+    flush_denormals_v4(state, count);
+#else
+    for (int k = 0; k < count; ++k) {
+        for (int c = 0; c < VREAL_LANES; ++c) state[k][c] = flush_denormal(state[k][c]);
+    }
+#endif
+}
+
+static inline v8sf flush_denormal_v8(v8sf x) {
+    const v8si abs_mask = { 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF };
+    const v8si keep = v8sf_le(v8sf_set1(DENORMAL_FLUSH_THRESHOLD), (v8sf)((v8si)x & abs_mask));
+    return (v8sf)((v8si)x & keep);
+}
+
+static inline void flush_denormals_v8(v8sf* state, int count) {
+    for (int k = 0; k < count; ++k) state[k] = flush_denormal_v8(state[k]);
+}
+
+#endif // GLA3A_DENORMAL_H
@@ -0,0 +1,176 @@
+#ifndef GLA3A_FASTMATH_H
+#define GLA3A_FASTMATH_H
+
+// --- Matematica Veloce per il Gain Computer ---
+// Approssimazioni di log2/exp2 con errore limitato, in forma scalare e vettoriale (v4sf e v8sf).
+// Tutte le forme eseguono le stesse operazioni nello stesso ordine: danno risultati identici bit a bit.
+//  - log2: esponente dai bit del float, mantissa ridotta a [sqrt(1/2), sqrt(2)) e serie
+//          atanh troncata al 7° ordine  -> errore assoluto < 1e-7 su log2.
+//  - exp2: parte intera arrotondata (frazione in [-0.5, 0.5)) e Taylor di 6° ordine
+//          -> errore relativo < 1e-6 (incluso l'arrotondamento dell'argomento).
+// Il limite dichiarato sotto è verificato su tutto il range del detector (-90..+12 dB)
+// da tests/fastmath_accuracy.cpp ("make check").
+
+#include "gla3a_simd.h"
+#include <stdint.h>
+#include <string.h>
+
+// Compilare con -DGLA3A_FAST_MATH=0 per tornare a log10f/powf/expf della libm.
+#ifndef GLA3A_FAST_MATH
+#define GLA3A_FAST_MATH 1
+#endif
+
+#define FASTMATH_MAX_DB_ERROR 1e-4f // Errore massimo garantito (dB) per to_db/db_to_linear
+
+#define FASTMATH_LOG2_10_OVER_20 0.166096404744368f // log2(10) / 20
+#define FASTMATH_20_LOG10_2      6.02059991327962f  // 20 * log10(2)
+#define FASTMATH_LOG2_E          1.44269504088896f  // log2(e)
+#define FASTMATH_SQRT2           1.41421356237310f
+#define FASTMATH_2_OVER_LN2      2.88539008177793f  // 2 / ln(2)
+
+// Range utile di exp2 (resta tra i float normalizzati)
+#define FASTMATH_EXP2_MIN -126.0f
+#define FASTMATH_EXP2_MAX 126.0f
+
+
+// --- Forma Scalare ---
+
+static inline float fast_log2f(float x) {
+    int32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    int32_t exponent = ((bits >> 23) & 0xFF) - 127;
+    int32_t mant_bits = (bits & 0x007FFFFF) | 0x3F800000;
+    float m;
+    memcpy(&m, &mant_bits, sizeof(m));
+
+    // Mantissa in [sqrt(1/2), sqrt(2)): la serie converge molto più in fretta
+    if (m > FASTMATH_SQRT2) {
+        m *= 0.5f;
+        exponent += 1;
+    }
+
+    // log2(m) = 2/ln2 * atanh(s), s = (m-1)/(m+1), |s| < 0.1716
+    float s = (m - 1.0f) / (m + 1.0f);
+    float s2 = s * s;
+    float poly = 1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f)));
+    return (float)exponent + FASTMATH_2_OVER_LN2 * s * poly;
+}
+
+static inline float fast_exp2f(float x) {
+    if (x < FASTMATH_EXP2_MIN) x = FASTMATH_EXP2_MIN;
+    if (x > FASTMATH_EXP2_MAX) x = FASTMATH_EXP2_MAX;
+
+    // Arrotondamento all'intero più vicino via troncamento di un valore sempre positivo
+    int32_t i = (int32_t)(x + 127.5f) - 127;
+    float f = x - (float)i; // [-0.5, 0.5)
+
+    // 2^f = e^(f ln2), Taylor di 6° ordine
+    float t = f * 0.693147180559945f;
+    float poly = 1.0f + t * (1.0f + t * (1.0f / 2.0f + t * (1.0f / 6.0f + t * (1.0f / 24.0f + t * (1.0f / 120.0f + t * (1.0f / 720.0f))))));
+
+    int32_t scale_bits = (i + 127) << 23;
+    float scale;
+    memcpy(&scale, &scale_bits, sizeof(scale));
+    return poly * scale;
+}
+
+static inline float fast_to_db(float linear_val) {
+    return FASTMATH_20_LOG10_2 * fast_log2f(linear_val);
+}
+
+static inline float fast_db_to_linear(float db_val) {
+    return fast_exp2f(db_val * FASTMATH_LOG2_10_OVER_20);
+}
+
+static inline float fast_expf(float x) {
+    return fast_exp2f(x * FASTMATH_LOG2_E);
+}
+
+
+// --- Forma Vettoriale (4 corsie) ---
+
+static inline v4sf fast_log2_v4(v4sf x) {
+    v4si bits = (v4si)x;
+    v4si exponent = ((bits >> 23) & 0xFF) - 127;
+    v4si mant_bits = (bits & 0x007FFFFF) | 0x3F800000;
+    v4sf m = (v4sf)mant_bits;
+
+    v4si big = m > FASTMATH_SQRT2;            // -1 dove vero, 0 altrimenti
+    m = big ? m * 0.5f : m;
+    exponent -= big;
+
+    v4sf s = (m - 1.0f) / (m + 1.0f);
+    v4sf s2 = s * s;
+    v4sf poly = 1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f)));
+    return __builtin_convertvector(exponent, v4sf) + FASTMATH_2_OVER_LN2 * s * poly;
+}
+
+static inline v4sf fast_exp2_v4(v4sf x) {
+    x = (x < FASTMATH_EXP2_MIN) ? v4sf_set1(FASTMATH_EXP2_MIN) : x;
+    x = (x > FASTMATH_EXP2_MAX) ? v4sf_set1(FASTMATH_EXP2_MAX) : x;
+
+    v4si i = __builtin_convertvector(x + 127.5f, v4si) - 127;
+    v4sf f = x - __builtin_convertvector(i, v4sf);
+
+    v4sf t = f * 0.693147180559945f;
+    v4sf poly = 1.0f + t * (1.0f + t * (1.0f / 2.0f + t * (1.0f / 6.0f + t * (1.0f / 24.0f + t * (1.0f / 120.0f + t * (1.0f / 720.0f))))));
+
+    v4sf scale = (v4sf)((i + 127) << 23);
+    return poly * scale;
+}
+
+static inline v4sf fast_to_db_v4(v4sf linear_val) {
+    return FASTMATH_20_LOG10_2 * fast_log2_v4(linear_val);
+}
+
+static inline v4sf fast_db_to_linear_v4(v4sf db_val) {
+    return fast_exp2_v4(db_val * FASTMATH_LOG2_10_OVER_20);
+}
+
+static inline v4sf fast_exp_v4(v4sf x) {
+    return fast_exp2_v4(x * FASTMATH_LOG2_E);
+}
+
+
+
+// --- Forma Vettoriale (8 corsie, una per striscia in gla3a_lanes.h) ---
+
+static inline v8sf fast_log2_v8(v8sf x) {
+    v8si bits = (v8si)x;
+    v8si exponent = ((bits >> 23) & 0xFF) - 127;
+    v8si mant_bits = (bits & 0x007FFFFF) | 0x3F800000;
+    v8sf m = (v8sf)mant_bits;
+
+    v8si big = v8sf_gt(m, v8sf_set1(FASTMATH_SQRT2));
+    m = v8sf_select(big, m * 0.5f, m);
+    exponent -= big;
+
+    v8sf s = (m - 1.0f) / (m + 1.0f);
+    v8sf s2 = s * s;
+    v8sf poly = 1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f)));
+    return __builtin_convertvector(exponent, v8sf) + FASTMATH_2_OVER_LN2 * s * poly;
+}
+
+static inline v8sf fast_exp2_v8(v8sf x) {
+    x = v8sf_select(v8sf_gt(v8sf_set1(FASTMATH_EXP2_MIN), x), v8sf_set1(FASTMATH_EXP2_MIN), x);
+    x = v8sf_select(v8sf_gt(x, v8sf_set1(FASTMATH_EXP2_MAX)), v8sf_set1(FASTMATH_EXP2_MAX), x);
+
+    v8si i = __builtin_convertvector(x + 127.5f, v8si) - 127;
+    v8sf f = x - __builtin_convertvector(i, v8sf);
+
+    v8sf t = f * 0.693147180559945f;
+    v8sf poly = 1.0f + t * (1.0f + t * (1.0f / 2.0f + t * (1.0f / 6.0f + t * (1.0f / 24.0f + t * (1.0f / 120.0f + t * (1.0f / 720.0f))))));
+
+    v8sf scale = (v8sf)((i + 127) << 23);
+    return poly * scale;
+}
+
+static inline v8sf fast_to_db_v8(v8sf linear_val) {
+    return FASTMATH_20_LOG10_2 * fast_log2_v8(linear_val);
+}
+
+static inline v8sf fast_db_to_linear_v8(v8sf db_val) {
+    return fast_exp2_v8(db_val * FASTMATH_LOG2_10_OVER_20);
+}
+
+#endif // GLA3A_FASTMATH_H
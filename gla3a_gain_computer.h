@@ -0,0 +1,94 @@
+#ifndef GLA3A_GAIN_COMPUTER_H
+#define GLA3A_GAIN_COMPUTER_H
+
+// --- Gain Computer a Tabella ---
+// La curva soft-knee dipende solo dalla distanza dalla soglia (x = detector_db - threshold_db):
+//  - x <= 0:          nessuna riduzione
+//  - 0 < x <= knee:   ratio effettiva che sale da 1:1 a ratio (tabella interpolata)
+//  - x > knee:        retta con pendenza (1 - 1/ratio) a partire dalla fine del knee
+// Per questo la tabella copre solo il knee ed è relativa alla soglia: si ricostruisce quando
+// cambia la ratio, mentre un cambio di Peak Reduction sposta solo l'origine (nessun ricalcolo).
+
+#include "gla3a_simd.h"
+#include <stdint.h>
+
+#define GAIN_TABLE_SIZE 512 // Celle sul knee (10 dB -> ~0.02 dB per cella, errore < 0.001 dB)
+
+typedef struct {
+    float ratio;     // Ratio con cui è stata costruita la tabella (< 0 = da costruire)
+    float knee_db;   // Larghezza del knee
+    float slope;     // 1 - 1/ratio, pendenza sopra il knee
+    float scale;     // Celle per dB
+    float table[GAIN_TABLE_SIZE + 2]; // Un elemento di guardia per l'interpolazione all'estremo
+} GainComputer;
+
+// Curva esatta (stessa formula del loop originale), usata per costruire la tabella
+static float gain_computer_curve(float over_threshold_db, float ratio, float knee_db) {
+    float target_gr_db = 0.0f;
+    if (over_threshold_db > knee_db) {
+        target_gr_db = (over_threshold_db - knee_db) * (1.0f - (1.0f / ratio));
+    } else if (over_threshold_db > 0.0f) {
+        float normalized_pos_in_knee = over_threshold_db / knee_db;
+        float effective_ratio_in_knee = 1.0f + (ratio - 1.0f) * normalized_pos_in_knee;
+        target_gr_db = over_threshold_db * (1.0f - (1.0f / effective_ratio_in_knee));
+    }
+    return (target_gr_db > 0.0f) ? target_gr_db : 0.0f;
+}
+
+static void gain_computer_init(GainComputer* gc) {
+    gc->ratio = -1.0f;
+    gc->knee_db = 0.0f;
+    gc->slope = 0.0f;
+    gc->scale = 0.0f;
+}
+
+// Ricostruisce la tabella solo se ratio o knee sono cambiati. Ritorna true se l'ha ricostruita.
+static bool gain_computer_update(GainComputer* gc, float ratio, float knee_db) {
+    if (ratio == gc->ratio && knee_db == gc->knee_db) return false;
+
+    gc->ratio = ratio;
+    gc->knee_db = knee_db;
+    gc->slope = 1.0f - (1.0f / ratio);
+    gc->scale = GAIN_TABLE_SIZE / knee_db;
+    for (int i = 0; i <= GAIN_TABLE_SIZE; ++i) {
+        gc->table[i] = gain_computer_curve(knee_db * i / GAIN_TABLE_SIZE, ratio, knee_db);
+    }
+    gc->table[GAIN_TABLE_SIZE + 1] = gc->table[GAIN_TABLE_SIZE];
+    return true;
+}
+
+// Gain reduction (dB, >= 0) per un livello del detector in dB
+static inline float gain_computer_lookup(const GainComputer* gc, float detector_db, float threshold_db) {
+    float x = detector_db - threshold_db;
+    if (x > gc->knee_db) return (x - gc->knee_db) * gc->slope;
+    if (x <= 0.0f) return 0.0f;
+
+    float pos = x * gc->scale;
+    int32_t i = (int32_t)pos;
+    float frac = pos - (float)i;
+    return gc->table[i] + frac * (gc->table[i + 1] - gc->table[i]);
+}
+
+// Come gain_computer_lookup() su 4 livelli insieme (una banda per corsia): le tre zone si
+// calcolano tutte e si sceglie per corsia; solo la lettura della tabella è per corsia.
+static inline v4sf gain_computer_lookup_v4(const GainComputer* gc, v4sf detector_db, v4sf threshold_db) {
+    v4sf x = detector_db - threshold_db;
+    v4sf above_knee = (x - gc->knee_db) * gc->slope;
+
+    v4sf pos = x * gc->scale;
+    pos = (pos < 0.0f) ? v4sf_set1(0.0f) : pos; // Le corsie fuori dal knee leggono comunque celle valide
+    pos = (pos > (float)GAIN_TABLE_SIZE) ? v4sf_set1((float)GAIN_TABLE_SIZE) : pos;
+    v4si i = __builtin_convertvector(pos, v4si);
+    v4sf frac = pos - __builtin_convertvector(i, v4sf);
+    v4sf t0, t1;
+    for (int k = 0; k < 4; ++k) {
+        t0[k] = gc->table[i[k]];
+        t1[k] = gc->table[i[k] + 1];
+    }
+    v4sf in_knee = t0 + frac * (t1 - t0);
+
+    v4sf gr = (x > gc->knee_db) ? above_knee : in_knee;
+    return (x <= 0.0f) ? v4sf_set1(0.0f) : gr;
+}
+
+#endif // GLA3A_GAIN_COMPUTER_H
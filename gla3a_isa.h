@@ -0,0 +1,74 @@
+#ifndef GLA3A_ISA_H
+#define GLA3A_ISA_H
+
+// --- Varianti ISA dei Kernel ---
+// Il Makefile compila senza -march: il codice è SSE2 su x86-64 (NEON su ARM) e gira ovunque, ma
+// non usa mai AVX2 o FMA dove ci sono. Su x86-64 i kernel caldi e vettoriali (l'ingresso del
+// blocco con l'oversampling, e i meter) esistono in tre varianti:
+//   GLA3A_ISA_BASELINE  le flag di compilazione (SSE2)
+//   GLA3A_ISA_AVX2      AVX2 + FMA (nel target; la contrazione resta spenta, vedi sotto)
+//   GLA3A_ISA_AVX512    AVX-512 (F, VL, BW, DQ), vettori da 512 bit dove il compilatore vettorizza
+// Una variante è lo stesso template del kernel (gla3a.cpp: process_front_kernel e i meter) dentro
+// un wrapper con ISA_TARGET_* e flatten: i filtri dell'oversampling e la saturazione vengono
+// incorporati e ricompilati con quelle istruzioni. Il resto del blocco (detector, gain computer,
+// limiter: ricorsivi campione per campione) è uno solo, nella base. instantiate() sceglie con
+// isa_select() la migliore che la CPU supporta, quindi un solo gla3a.so va bene su ogni macchina.
+// La contrazione di a * b + c in FMA è spenta per tutto il codice (-ffp-contract=off nel Makefile):
+// ogni variante fa le stesse operazioni con gli stessi arrotondamenti della base, e l'uscita è
+// identica bit per bit su ogni CPU (tests/isa.cpp), come chiedono i golden e l'API a blocchi.
+// Il dispatch richiede GCC: clang definisce anche __GNUC__, ma le varianti non sono verificate
+// con il suo inlining dentro target(), e senza la flag nel build sarebbero libere di contrarre.
+// Il detector delle corsie dell'API a blocchi resta quello di base: v8sf_gt() e le altre scelgono
+// il percorso con #ifdef __AVX__, che dentro un wrapper con target() non cambia.
+//
+// GLA3A_ISA=baseline|avx2|avx512 nell'ambiente limita la scelta (confronti e benchmark, vedi
+// "make bench-isa"); compilare con -DGLA3A_ISA_DISPATCH=0 per avere solo la base.
+
+#include <stdlib.h>
+#include <string.h>
+
+#define GLA3A_ISA_BASELINE 0
+#define GLA3A_ISA_AVX2     1
+#define GLA3A_ISA_AVX512   2
+#define GLA3A_NUM_ISAS     3
+
+#ifndef GLA3A_ISA_DISPATCH
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define GLA3A_ISA_DISPATCH 1
+#else
+#define GLA3A_ISA_DISPATCH 0
+#endif
+#endif
+
+#if GLA3A_ISA_DISPATCH
+#define ISA_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define ISA_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma,prefer-vector-width=512")))
+#define ISA_FLATTEN       __attribute__((flatten))
+#endif
+
+static const char* const isa_names[GLA3A_NUM_ISAS] = { "baseline", "avx2", "avx512" };
+
+// Variante migliore che la CPU supporta (sempre la base senza GLA3A_ISA_DISPATCH)
+static inline int isa_detect(void) {
+#if GLA3A_ISA_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+        __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq")) {
+        return GLA3A_ISA_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return GLA3A_ISA_AVX2;
+#endif
+    return GLA3A_ISA_BASELINE;
+}
+
+// isa_detect(), limitata da GLA3A_ISA nell'ambiente se chiede una variante più bassa
+static inline int isa_select(void) {
+    int isa = isa_detect();
+    const char* cap = getenv("GLA3A_ISA");
+    for (int k = 0; cap && k < isa; ++k) {
+        if (!strcmp(cap, isa_names[k])) isa = k;
+    }
+    return isa;
+}
+
+#endif // GLA3A_ISA_H
@@ -0,0 +1,40 @@
+#ifndef GLA3A_KERNELS_H
+#define GLA3A_KERNELS_H
+
+// --- Kernel Specializzati per Configurazione ---
+// process_block() (gla3a.cpp) è un template su M/S, LowPass e HighPass della sidechain, numero di
+// stadi di oversampling e modalità Limit. Ogni parametro è un valore fisso (0/1, o gli stadi) o
+// KERNEL_RUNTIME, che lo legge dallo stato a ogni blocco come faceva il vecchio corpo unico.
+// A ogni blocco il dispatcher sceglie l'istanza con tutti i parametri fissi: i rami sulla
+// configurazione spariscono e le costanti (stadi del banco di biquad, tap di ogni stadio di
+// oversampling) arrivano ai loop interni come numeri, quindi il compilatore li srotola e tiene gli
+// stati nei registri per tutto il blocco.
+// Le operazioni sono le stesse, nello stesso ordine, del kernel generico: l'uscita è identica bit
+// per bit (tests/kernels.cpp). Restano rami per blocco le bande, il collegamento stereo e la
+// modalità dell'oversampling; le ratio diverse da Limit cambiano solo la tabella del gain computer.
+//
+// Compilare con -DGLA3A_KERNEL=GLA3A_KERNEL_GENERIC per usare sempre il kernel generico;
+// "make bench-kernels" misura i due a confronto.
+
+#define GLA3A_KERNEL_SPECIALIZED 0
+#define GLA3A_KERNEL_GENERIC     1
+
+#ifndef GLA3A_KERNEL
+#define GLA3A_KERNEL GLA3A_KERNEL_SPECIALIZED
+#endif
+
+#if GLA3A_KERNEL == GLA3A_KERNEL_SPECIALIZED
+#define GLA3A_KERNEL_NAME "specialized"
+#elif GLA3A_KERNEL == GLA3A_KERNEL_GENERIC
+#define GLA3A_KERNEL_NAME "generic"
+#else
+#error "GLA3A_KERNEL: valori ammessi GLA3A_KERNEL_SPECIALIZED, GLA3A_KERNEL_GENERIC"
+#endif
+
+#define KERNEL_RUNTIME -1 // Parametro di un kernel letto dallo stato a ogni blocco
+
+// Valore di un parametro del kernel: la costante del template o, con KERNEL_RUNTIME, quello corrente
+#define KERNEL_PARAM(param, runtime) (((param) == KERNEL_RUNTIME) ? (runtime) : (param))
+#define KERNEL_FLAG(param, runtime)  (((param) == KERNEL_RUNTIME) ? (bool)(runtime) : (param) != 0)
+
+#endif // GLA3A_KERNELS_H
@@ -0,0 +1,336 @@
+#ifndef GLA3A_LANES_H
+#define GLA3A_LANES_H
+
+// --- Detector su Più Strisce (Corsie SoA) ---
+// Con l'API a blocchi (gla3a_batch.h) le strisce si elaborano a gruppi di LANES: la corsia k di ogni
+// v8sf è la striscia k del gruppo, quindi ogni istruzione avanza tutte le strisce insieme anche negli
+// stadi ricorsivi (filtri della sidechain, envelope, smoothing del guadagno), che da soli non hanno
+// parallelismo da dare alla SIMD.
+// Ogni corsia esegue le stesse operazioni (e nello stesso ordine) dello stadio scalare corrispondente
+// (gla3a_stages.h, gla3a_svf.h o gla3a_biquad_bank.h, gla3a_gain_computer.h): l'uscita di una striscia è identica
+// bit per bit a quella di un'istanza elaborata da sola.
+// I parametri sono per corsia. Dove una striscia farebbe un percorso diverso (filtro spento,
+// detector collegati o misti) si calcolano tutte le corsie e si sceglie con una maschera
+// (v8si, -1 = vero, v8sf_select()): lo stato di una corsia esclusa non si muove.
+
+#include "gla3a_denormal.h"
+#include "gla3a_gain_computer.h"
+#include "gla3a_simd.h"
+#include "gla3a_stages.h"
+#include "gla3a_svf.h"
+#include <stdint.h>
+
+#define LANES 8
+#define LANES_MAX_BIQUADS 3
+
+static inline v8si v8si_set1(int32_t x) {
+    v8si v = { x, x, x, x, x, x, x, x };
+    return v;
+}
+
+static inline v8sf v8sf_abs(v8sf x) {
+    return (v8sf)((v8si)x & v8si_set1(0x7fffffff));
+}
+
+
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+
+// --- Cascata di SVF per Corsia ---
+// M e S di ogni striscia nella stessa struttura: taglio e Q (e il glide) sono comuni ai due canali,
+// quindi lo smoothing si calcola una volta per campione. Il glide avanza solo nelle corsie che ce
+// l'hanno, con le operazioni di svf_bank_glide(); finito in tutte, il resto del blocco gira a
+// coefficienti fissi come svf_bank_process_chain().
+
+typedef struct {
+    v8sf w, k;                  // Come SvfBank, una striscia per corsia
+    v8sf w_target, k_target;
+    v8sf glide_alpha;
+    v8sf a1, a2, a3;
+    v8si gliding;
+    v8sf ic1_M[LANES_MAX_BIQUADS], ic2_M[LANES_MAX_BIQUADS];
+    v8sf ic1_S[LANES_MAX_BIQUADS], ic2_S[LANES_MAX_BIQUADS];
+    v8si on;    // Corsie in cui la cascata filtra (-1); nelle altre passa l'ingresso
+} LaneSvfBank;
+
+static inline bool v8si_any(v8si mask) {
+    int32_t any = 0;
+    for (int k = 0; k < LANES; ++k) any |= mask[k];
+    return any != 0;
+}
+
+static void lane_svf_bank_init(LaneSvfBank* bank) {
+    bank->w = bank->k = bank->w_target = bank->k_target = bank->glide_alpha = v8sf_set1(0.0f);
+    bank->a1 = bank->a2 = bank->a3 = v8sf_set1(0.0f);
+    bank->gliding = bank->on = v8si_set1(0);
+    for (int s = 0; s < LANES_MAX_BIQUADS; ++s) {
+        bank->ic1_M[s] = bank->ic2_M[s] = bank->ic1_S[s] = bank->ic2_S[s] = v8sf_set1(0.0f);
+    }
+}
+
+// Taglio, Q, glide e coefficienti di una corsia dal SvfBank della striscia (get: indietro)
+static void lane_svf_bank_set(LaneSvfBank* bank, int lane, const SvfBank* from) {
+    bank->w[lane] = from->w;
+    bank->k[lane] = from->k;
+    bank->w_target[lane] = from->w_target;
+    bank->k_target[lane] = from->k_target;
+    bank->glide_alpha[lane] = from->glide_alpha;
+    bank->a1[lane] = from->a1[LANE_M];
+    bank->a2[lane] = from->a2[LANE_M];
+    bank->a3[lane] = from->a3[LANE_M];
+    bank->gliding[lane] = from->gliding ? -1 : 0;
+}
+
+static void lane_svf_bank_get(const LaneSvfBank* bank, int lane, SvfBank* to) {
+    to->w = bank->w[lane];
+    to->k = bank->k[lane];
+    to->a1 = vreal_set1(bank->a1[lane]);
+    to->a2 = vreal_set1(bank->a2[lane]);
+    to->a3 = vreal_set1(bank->a3[lane]);
+    to->hp_k = vreal_set1(to->k);
+    to->gliding = bank->gliding[lane] != 0;
+}
+
+// svf_tan() su tutte le corsie
+static inline v8sf lane_svf_tan(v8sf x) {
+    const v8sf x2 = x * x;
+    const v8sf num = x * (v8sf_set1(135135.0f) - x2 * (v8sf_set1(17325.0f) - x2 * (v8sf_set1(378.0f) - x2)));
+    const v8sf den = v8sf_set1(135135.0f) - x2 * (v8sf_set1(62370.0f) - x2 * (v8sf_set1(3150.0f) - x2 * v8sf_set1(28.0f)));
+    return num / den;
+}
+
+// svf_bank_glide() nelle corsie in glide; le altre tengono taglio, Q e coefficienti
+static inline void lane_svf_bank_glide(LaneSvfBank* bank) {
+    const v8si moving = bank->gliding;
+    const v8sf tolerance = v8sf_set1((float)SVF_SETTLE_TOLERANCE);
+    const v8sf w = bank->w + (bank->w_target - bank->w) * bank->glide_alpha;
+    const v8sf k = bank->k + (bank->k_target - bank->k) * bank->glide_alpha;
+    const v8si stalled = v8sf_eq(w, bank->w) & v8sf_eq(k, bank->k);
+    const v8si settled = stalled | (v8sf_le(v8sf_abs(bank->w_target - w), bank->w_target * tolerance) &
+                                    v8sf_le(v8sf_abs(bank->k_target - k), bank->k_target * tolerance));
+    bank->w = v8sf_select(moving, v8sf_select(settled, bank->w_target, w), bank->w);
+    bank->k = v8sf_select(moving, v8sf_select(settled, bank->k_target, k), bank->k);
+    bank->gliding = moving & ~settled;
+
+    const v8sf one = v8sf_set1(1.0f);
+    const v8sf g = lane_svf_tan(bank->w);
+    const v8sf a1 = one / (one + g * (g + bank->k));
+    const v8sf a2 = g * a1;
+    bank->a1 = v8sf_select(moving, a1, bank->a1);
+    bank->a2 = v8sf_select(moving, a2, bank->a2);
+    bank->a3 = v8sf_select(moving, g * a2, bank->a3);
+}
+
+// Gli stadi di svf_bank_tick() su un canale; le corsie spente passano l'ingresso e lasciano fermo lo stato
+template <int TYPE>
+static inline v8sf lane_svf_bank_tick(const LaneSvfBank* bank, v8sf* ic1, v8sf* ic2, v8sf in) {
+    const v8si on = bank->on;
+    const v8sf x = in;
+    for (int s = 0; s < LANES_MAX_BIQUADS; ++s) {
+        const v8sf v3 = in - ic2[s];
+        const v8sf v1 = bank->a1 * ic1[s] + bank->a2 * v3;
+        const v8sf v2 = ic2[s] + bank->a2 * ic1[s] + bank->a3 * v3;
+        ic1[s] = v8sf_select(on, v1 + v1 - ic1[s], ic1[s]);
+        ic2[s] = v8sf_select(on, v2 + v2 - ic2[s], ic2[s]);
+        in = (TYPE == SVF_LOWPASS) ? v2 : in - bank->k * v1 - v2;
+    }
+    return v8sf_select(on, in, x);
+}
+
+// Filtra sul posto M e S del gruppo
+template <int TYPE>
+static void lane_svf_bank_process(LaneSvfBank* bank, v8sf* buf_M, v8sf* buf_S, uint32_t n) {
+    uint32_t i = 0;
+    for (; i < n && v8si_any(bank->gliding); ++i) {
+        lane_svf_bank_glide(bank);
+        buf_M[i] = lane_svf_bank_tick<TYPE>(bank, bank->ic1_M, bank->ic2_M, buf_M[i]);
+        buf_S[i] = lane_svf_bank_tick<TYPE>(bank, bank->ic1_S, bank->ic2_S, buf_S[i]);
+    }
+    for (; i < n; ++i) {
+        buf_M[i] = lane_svf_bank_tick<TYPE>(bank, bank->ic1_M, bank->ic2_M, buf_M[i]);
+        buf_S[i] = lane_svf_bank_tick<TYPE>(bank, bank->ic1_S, bank->ic2_S, buf_S[i]);
+    }
+}
+
+static void lane_svf_bank_flush_denormals(LaneSvfBank* bank) {
+    flush_denormals_v8(bank->ic1_M, LANES_MAX_BIQUADS);
+    flush_denormals_v8(bank->ic2_M, LANES_MAX_BIQUADS);
+    flush_denormals_v8(bank->ic1_S, LANES_MAX_BIQUADS);
+    flush_denormals_v8(bank->ic2_S, LANES_MAX_BIQUADS);
+}
+
+#else
+
+// --- Cascata di Biquad per Corsia ---
+
+typedef struct {
+    v8sf b0[LANES_MAX_BIQUADS];
+    v8sf b1[LANES_MAX_BIQUADS];
+    v8sf b2[LANES_MAX_BIQUADS];
+    v8sf a1[LANES_MAX_BIQUADS];
+    v8sf a2[LANES_MAX_BIQUADS];
+    v8sf z1[LANES_MAX_BIQUADS];
+    v8sf z2[LANES_MAX_BIQUADS];
+    v8si on;    // Corsie in cui la cascata filtra (-1); nelle altre passa l'ingresso
+} LaneBiquadBank;
+
+static void lane_biquad_bank_init(LaneBiquadBank* bank) {
+    for (int k = 0; k < LANES_MAX_BIQUADS; ++k) {
+        bank->b0[k] = bank->b1[k] = bank->b2[k] = v8sf_set1(0.0f);
+        bank->a1[k] = bank->a2[k] = v8sf_set1(0.0f);
+        bank->z1[k] = bank->z2[k] = v8sf_set1(0.0f);
+    }
+    bank->on = v8si_set1(0);
+}
+
+// Coefficienti normalizzati di uno stadio per una sola corsia
+static void lane_biquad_bank_set_stage(LaneBiquadBank* bank, int lane, int stage,
+                                       float b0, float b1, float b2, float a1, float a2) {
+    bank->b0[stage][lane] = b0;
+    bank->b1[stage][lane] = b1;
+    bank->b2[stage][lane] = b2;
+    bank->a1[stage][lane] = a1;
+    bank->a2[stage][lane] = a2;
+}
+
+// Filtra sul posto; le corsie spente passano l'ingresso e lasciano fermo il loro stato
+static void lane_biquad_bank_process(LaneBiquadBank* bank, v8sf* buf, uint32_t n) {
+    const v8si on = bank->on;
+    for (uint32_t i = 0; i < n; ++i) {
+        v8sf in = buf[i];
+        for (int k = 0; k < LANES_MAX_BIQUADS; ++k) {
+            v8sf out = in * bank->b0[k] + bank->z1[k];
+            v8sf z1 = in * bank->b1[k] + bank->z2[k] - bank->a1[k] * out;
+            v8sf z2 = in * bank->b2[k] - bank->a2[k] * out;
+            bank->z1[k] = v8sf_select(on, z1, bank->z1[k]);
+            bank->z2[k] = v8sf_select(on, z2, bank->z2[k]);
+            in = out;
+        }
+        buf[i] = v8sf_select(on, in, buf[i]);
+    }
+}
+
+static void lane_biquad_bank_flush_denormals(LaneBiquadBank* bank) {
+    flush_denormals_v8(bank->z1, LANES_MAX_BIQUADS);
+    flush_denormals_v8(bank->z2, LANES_MAX_BIQUADS);
+}
+
+#endif // GLA3A_SIDECHAIN
+
+
+// --- Parametri del Detector per Corsia ---
+
+typedef struct {
+    v8sf attack_alpha;
+    v8sf release_alpha;
+    v8sf gain_smooth_alpha;
+    v8sf threshold_db;
+    v8sf make_up_gain_linear;
+    v8sf link_amount;
+    v8si linked;    // Detector collegato: un solo envelope e lo stesso guadagno sui due canali
+    v8si blend;     // Collegamento misto degli envelope
+    v8si link_sum;  // Livello collegato come somma normalizzata invece del massimo
+    const GainComputer* gain_computer[LANES];
+} LaneDetector;
+
+
+// --- Stadi del Blocco ---
+
+// Ingresso del detector: trasposizione dai buffer di ogni striscia alle corsie, con rettifica.
+// Le corsie collegate ricevono il livello collegato su M e silenzio su S.
+static void stage_rectify_lanes(const float* const in_M[LANES], const float* const in_S[LANES],
+                                v8sf* out_M, v8sf* out_S, uint32_t n, const LaneDetector* det) {
+    for (uint32_t i = 0; i < n; ++i) {
+        v8sf m, s;
+        for (int k = 0; k < LANES; ++k) {
+            m[k] = fabsf(in_M[k][i]);
+            s[k] = fabsf(in_S[k][i]);
+        }
+        const v8sf linked = v8sf_select(det->link_sum, (m + s) * 0.5f, v8sf_select(v8sf_gt(m, s), m, s)); // link_level()
+        out_M[i] = v8sf_select(det->linked, linked, m);
+        out_S[i] = v8sf_select(det->linked, v8sf_set1(0.0f), s);
+    }
+}
+
+// Detector di envelope sul posto (vedi stage_envelope())
+static void stage_envelope_lanes(v8sf* buf, uint32_t n, v8sf* env, const LaneDetector* det) {
+    const v8sf attack = det->attack_alpha;
+    const v8sf release = det->release_alpha;
+    v8sf e = *env;
+    for (uint32_t i = 0; i < n; ++i) {
+        const v8sf in = buf[i];
+        const v8sf up = (e * (1.0f - attack)) + (in * attack);
+        const v8sf down = (e * (1.0f - release)) + (in * release);
+        e = v8sf_select(v8sf_gt(in, e), up, down);
+        buf[i] = e;
+    }
+    *env = e;
+}
+
+// Collegamento misto sul posto, solo sulle corsie in modalità mista (vedi stage_link_blend())
+static void stage_link_blend_lanes(v8sf* env_M, v8sf* env_S, uint32_t n, const LaneDetector* det) {
+    const v8sf amount = det->link_amount;
+    for (uint32_t i = 0; i < n; ++i) {
+        const v8sf m = env_M[i];
+        const v8sf s = env_S[i];
+        const v8sf linked = v8sf_select(det->link_sum, (m + s) * 0.5f, v8sf_select(v8sf_gt(m, s), m, s));
+        env_M[i] = v8sf_select(det->blend, m + (linked - m) * amount, m);
+        env_S[i] = v8sf_select(det->blend, s + (linked - s) * amount, s);
+    }
+}
+
+// Gain computer sul posto, ogni corsia con la sua curva (vedi gain_computer_lookup_v4())
+static void stage_gain_computer_lanes(v8sf* buf, uint32_t n, const LaneDetector* det) {
+    v8sf knee, slope, scale;
+    for (int k = 0; k < LANES; ++k) {
+        knee[k] = det->gain_computer[k]->knee_db;
+        slope[k] = det->gain_computer[k]->slope;
+        scale[k] = det->gain_computer[k]->scale;
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        v8sf x = to_db_v8(buf[i]) - det->threshold_db;
+        v8sf above_knee = (x - knee) * slope;
+
+        v8sf pos = x * scale;
+        pos = v8sf_select(v8sf_gt(v8sf_set1(0.0f), pos), v8sf_set1(0.0f), pos);
+        pos = v8sf_select(v8sf_gt(pos, v8sf_set1((float)GAIN_TABLE_SIZE)), v8sf_set1((float)GAIN_TABLE_SIZE), pos);
+        v8si cell = __builtin_convertvector(pos, v8si);
+        v8sf frac = pos - __builtin_convertvector(cell, v8sf);
+        v8sf t0, t1;
+        for (int k = 0; k < LANES; ++k) {
+            t0[k] = det->gain_computer[k]->table[cell[k]];
+            t1[k] = det->gain_computer[k]->table[cell[k] + 1];
+        }
+        v8sf in_knee = t0 + frac * (t1 - t0);
+
+        v8sf gr = v8sf_select(v8sf_gt(x, knee), above_knee, in_knee);
+        gr = v8sf_select(v8sf_le(x, v8sf_set1(0.0f)), v8sf_set1(0.0f), gr);
+        buf[i] = db_to_linear_v8(-gr) * det->make_up_gain_linear;
+    }
+}
+
+// Smoothing del guadagno sul posto (vedi stage_gain_smooth())
+static void stage_gain_smooth_lanes(v8sf* buf, uint32_t n, v8sf* gain, const LaneDetector* det) {
+    const v8sf alpha = det->gain_smooth_alpha;
+    v8sf g = *gain;
+    for (uint32_t i = 0; i < n; ++i) {
+        g = (g * (1.0f - alpha)) + (buf[i] * alpha);
+        buf[i] = g;
+    }
+    *gain = g;
+}
+
+// Applica il guadagno ai buffer di ogni striscia (trasposizione inversa); le corsie collegate
+// usano il guadagno M su entrambi i canali
+static void stage_apply_lanes(float* const audio_M[LANES], float* const audio_S[LANES],
+                              const v8sf* gain_M, const v8sf* gain_S, uint32_t n, const LaneDetector* det) {
+    for (uint32_t i = 0; i < n; ++i) {
+        const v8sf g_M = gain_M[i];
+        const v8sf g_S = v8sf_select(det->linked, gain_M[i], gain_S[i]);
+        for (int k = 0; k < LANES; ++k) {
+            audio_M[k][i] *= g_M[k];
+            audio_S[k][i] *= g_S[k];
+        }
+    }
+}
+
+#endif // GLA3A_LANES_H
@@ -0,0 +1,158 @@
+#ifndef GLA3A_LIMITER_H
+#define GLA3A_LIMITER_H
+
+// --- Limiter Lookahead (modalità Limit) ---
+// Con una finestra di L campioni:
+//  1. g[n] = guadagno che porta il picco stereo max(|L|, |R|) del campione n alla soglia (<= 1)
+//  2. h[n] = minimo di g sulla finestra [n-L+1, n]       (deque monotona, O(1) ammortizzato)
+//  3. b[n] = media di h sulla stessa finestra             (somma scorrevole, O(1))
+//  4. il segnale esce ritardato di L-1 campioni, moltiplicato per b[n]
+// Ogni h della media "vede" il campione in uscita, quindi b[n] <= g[n-L+1]: il guadagno arriva
+// al valore giusto esattamente sul picco, senza overshoot, e la media rende la discesa morbida.
+// Il rilascio (salita del guadagno) è un filtro a un polo sopra la media.
+// Tutta la memoria (linee di ritardo, finestra, deque) è data dal chiamante: niente allocazioni.
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LIMITER_MIN_LOOKAHEAD_MS 0.1f
+#define LIMITER_MAX_LOOKAHEAD_MS 10.0f
+#define LIMITER_BUFFERS 5 // delay_l, delay_r, box, deque_value, deque_index
+
+typedef struct {
+    uint32_t capacity;     // Finestra massima (campioni) per cui c'è memoria
+    uint32_t length;       // Finestra attiva L (1 = nessun lookahead)
+
+    float* delay_l;        // Linee di ritardo del segnale (anello di L campioni)
+    float* delay_r;
+    float* box;            // Ultimi L valori di h per la media
+    double box_sum;        // Somma di box[] (double: la somma scorrevole non deriva)
+
+    float* deque_value;    // Deque monotona (anello di capacity): valori crescenti dal fronte
+    uint32_t* deque_index; // Indice assoluto del campione di ogni valore
+    uint32_t deque_head;
+    uint32_t deque_size;
+
+    uint32_t pos;          // Posizione corrente negli anelli di L campioni
+    uint32_t counter;      // Indice assoluto del campione (il wrap è gestito dalle differenze)
+    float gain;            // Guadagno applicato (dopo il rilascio)
+} LookaheadLimiter;
+
+// Campioni di finestra per un lookahead in ms (almeno 1)
+static uint32_t limiter_length_from_ms(float lookahead_ms, double samplerate) {
+    if (lookahead_ms < LIMITER_MIN_LOOKAHEAD_MS) lookahead_ms = LIMITER_MIN_LOOKAHEAD_MS;
+    if (lookahead_ms > LIMITER_MAX_LOOKAHEAD_MS) lookahead_ms = LIMITER_MAX_LOOKAHEAD_MS;
+    uint32_t length = (uint32_t)(lookahead_ms * 0.001 * samplerate + 0.5);
+    return (length < 1) ? 1 : length;
+}
+
+// Float di memoria necessari per una finestra massima di 'capacity' campioni
+static inline size_t limiter_memory_floats(uint32_t capacity) {
+    return (size_t)LIMITER_BUFFERS * capacity;
+}
+
+static void limiter_reset(LookaheadLimiter* lim) {
+    memset(lim->delay_l, 0, sizeof(float) * lim->length);
+    memset(lim->delay_r, 0, sizeof(float) * lim->length);
+    for (uint32_t i = 0; i < lim->length; ++i) lim->box[i] = 1.0f;
+    lim->box_sum = lim->length;
+    lim->deque_head = 0;
+    lim->deque_size = 0;
+    lim->pos = 0;
+    lim->counter = 0;
+    lim->gain = 1.0f;
+}
+
+// 'memory' deve contenere limiter_memory_floats(capacity) float
+static void limiter_init(LookaheadLimiter* lim, float* memory, uint32_t capacity) {
+    lim->capacity = capacity;
+    lim->length = 1;
+    lim->delay_l = memory;
+    lim->delay_r = memory + capacity;
+    lim->box = memory + 2 * capacity;
+    lim->deque_value = memory + 3 * capacity;
+    lim->deque_index = (uint32_t*)(memory + 4 * capacity);
+    limiter_reset(lim);
+}
+
+// Cambia la finestra (e quindi la latenza): lo stato riparte da zero
+static void limiter_set_length(LookaheadLimiter* lim, uint32_t length) {
+    if (length < 1) length = 1;
+    if (length > lim->capacity) length = lim->capacity;
+    lim->length = length;
+    limiter_reset(lim);
+}
+
+// Latenza introdotta (campioni)
+static inline uint32_t limiter_latency(const LookaheadLimiter* lim) {
+    return lim->length - 1;
+}
+
+// Vero se le linee di ritardo sono vuote e la finestra vede solo guadagno unitario: il silenzio
+// in ingresso dà silenzio in uscita. Il resto dello stato (posizioni, deque) avanza, ma con
+// contenuti uniformi non cambia l'uscita: al ritorno del segnale il campione più vecchio della
+// deque scade subito o viene scartato dal nuovo minimo.
+static inline bool limiter_is_silent(const LookaheadLimiter* lim) {
+    for (uint32_t i = 0; i < lim->length; ++i) {
+        if (lim->delay_l[i] != 0.0f || lim->delay_r[i] != 0.0f || lim->box[i] != 1.0f) return false;
+    }
+    return true;
+}
+
+// Limita sul posto un blocco stereo: picco <= threshold_linear, poi applica il make-up
+static void limiter_process(LookaheadLimiter* lim, float* left, float* right, uint32_t n,
+                            float threshold_linear, float make_up_gain_linear, float release_alpha) {
+    const uint32_t length = lim->length;
+    const float inv_length = 1.0f / (float)length;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const float xl = left[i];
+        const float xr = right[i];
+
+        // 1. Guadagno necessario per questo campione
+        const float peak = fmaxf(fabsf(xl), fabsf(xr));
+        const float g = (peak > threshold_linear) ? threshold_linear / peak : 1.0f;
+
+        // 2. Minimo sulla finestra: dal fronte esce il valore scaduto, dal fondo quelli >= g
+        if (lim->deque_size > 0 && lim->counter - lim->deque_index[lim->deque_head] >= length) {
+            lim->deque_head = (lim->deque_head + 1) % lim->capacity;
+            --lim->deque_size;
+        }
+        while (lim->deque_size > 0) {
+            uint32_t back = (lim->deque_head + lim->deque_size - 1) % lim->capacity;
+            if (lim->deque_value[back] < g) break;
+            --lim->deque_size;
+        }
+        uint32_t tail = (lim->deque_head + lim->deque_size) % lim->capacity;
+        lim->deque_value[tail] = g;
+        lim->deque_index[tail] = lim->counter;
+        ++lim->deque_size;
+        const float held = lim->deque_value[lim->deque_head];
+
+        // 3. Media scorrevole del minimo
+        lim->box_sum += (double)held - (double)lim->box[lim->pos];
+        lim->box[lim->pos] = held;
+        const float smoothed = (float)lim->box_sum * inv_length;
+
+        // Attacco immediato (il lookahead l'ha già reso morbido), rilascio a un polo
+        if (smoothed < lim->gain) {
+            lim->gain = smoothed;
+        } else {
+            lim->gain += (smoothed - lim->gain) * release_alpha;
+        }
+
+        // 4. Ritardo di L-1 campioni: si scrive in pos e si legge il più vecchio
+        lim->delay_l[lim->pos] = xl;
+        lim->delay_r[lim->pos] = xr;
+        const uint32_t oldest = (lim->pos + 1 == length) ? 0 : lim->pos + 1;
+        const float total_gain = lim->gain * make_up_gain_linear;
+        left[i] = lim->delay_l[oldest] * total_gain;
+        right[i] = lim->delay_r[oldest] * total_gain;
+
+        lim->pos = oldest;
+        ++lim->counter;
+    }
+}
+
+#endif // GLA3A_LIMITER_H
@@ -0,0 +1,287 @@
+#ifndef GLA3A_MULTIBAND_H
+#define GLA3A_MULTIBAND_H
+
+// --- Modalità Multibanda (2-4 bande) ---
+// Un banco di crossover Linkwitz-Riley (LR4 = due Butterworth di 2° ordine in cascata) divide
+// il segnale decimato prima del detector; ogni banda ha il suo envelope, il suo guadagno e il
+// suo offset di soglia, poi le bande si sommano di nuovo.
+// Topologia ad albero, con le frequenze in ordine crescente:
+//   x -> LP1 = banda 1,  HP1 -> LP2 = banda 2,  HP2 -> LP3 = banda 3,  HP3 = banda 4
+// LP + HP di un LR4 è un passa-tutto di 2° ordine (Q = 1/sqrt(2)): le bande basse passano per
+// i passa-tutto dei crossover più alti che non hanno attraversato, così tutte le bande hanno
+// la stessa fase e la somma è piatta in ampiezza.
+// Il filtraggio avanza M e S nelle corsie dei BiquadBank (in FilterReal, gla3a_precision.h);
+// envelope e guadagno invece sono struttura-di-array sulle bande, sempre in float: le 4 bande di
+// un campione stanno in un v4sf e un solo passo vettoriale fa detector, gain computer e smoothing
+// per tutte. Le corsie delle bande non attive ricevono segnale nullo e non contribuiscono alla somma.
+
+#include "gla3a_simd.h"
+#include "gla3a_biquad_bank.h"
+#include "gla3a_gain_computer.h"
+#include "gla3a_stages.h"
+#include <math.h>
+#include <stdint.h>
+
+#define MULTIBAND_MAX_BANDS 4
+#define MULTIBAND_MAX_CROSSOVERS (MULTIBAND_MAX_BANDS - 1)
+#define MULTIBAND_MIN_FREQ 20.0f
+#define MULTIBAND_MIN_SPACING 1.1f   // Rapporto minimo tra due crossover consecutivi
+#define MULTIBAND_MAX_FREQ_RATIO 0.45f // Crossover massimo, relativo alla frequenza di campionamento
+
+typedef struct {
+    int num_bands;                                  // 1 = modalità a banda singola (crossover spento)
+    float freq[MULTIBAND_MAX_CROSSOVERS];           // Frequenze effettive (ordinate e limitate)
+    BiquadBank lowpass[MULTIBAND_MAX_CROSSOVERS];   // LR4: 2 stadi Butterworth uguali
+    BiquadBank highpass[MULTIBAND_MAX_CROSSOVERS];
+    BiquadBank allpass[MULTIBAND_MAX_CROSSOVERS];   // Compensazione della banda k (crossover k+1..)
+} Crossover;
+
+// Stato del detector per un canale (M o S): una corsia per banda
+typedef struct {
+    v4sf envelope;
+    v4sf gain;
+} BandDynamics;
+
+
+// --- Progetto dei Filtri ---
+
+// Coefficienti RBJ di 2° ordine con Q Butterworth, in double (0 = LP, 1 = HP, 2 = passa-tutto)
+static void crossover_stage(BiquadBank* bank, int stage, double samplerate, float freq_hz, int type) {
+    const double omega = 2.0 * M_PI * freq_hz / samplerate;
+    const double cos_omega = cos(omega);
+    const double alpha = sin(omega) * M_SQRT1_2; // sin / (2 Q) con Q = 1/sqrt(2)
+    const double a0 = 1.0 + alpha;
+    double b0, b1, b2;
+    if (type == 0) {
+        b0 = b2 = (1.0 - cos_omega) / 2.0;
+        b1 = 1.0 - cos_omega;
+    } else if (type == 1) {
+        b0 = b2 = (1.0 + cos_omega) / 2.0;
+        b1 = -(1.0 + cos_omega);
+    } else {
+        b0 = 1.0 - alpha;
+        b1 = -2.0 * cos_omega;
+        b2 = 1.0 + alpha;
+    }
+    biquad_bank_set_stage(bank, stage, (FilterReal)(b0 / a0), (FilterReal)(b1 / a0), (FilterReal)(b2 / a0),
+                          (FilterReal)(-2.0 * cos_omega / a0), (FilterReal)((1.0 - alpha) / a0));
+}
+
+static void crossover_init(Crossover* xo) {
+    xo->num_bands = 1;
+    for (int k = 0; k < MULTIBAND_MAX_CROSSOVERS; ++k) {
+        xo->freq[k] = 0.0f;
+        biquad_bank_init(&xo->lowpass[k], 2);
+        biquad_bank_init(&xo->highpass[k], 2);
+        biquad_bank_init(&xo->allpass[k], 0);
+    }
+}
+
+static void crossover_reset(Crossover* xo) {
+    for (int k = 0; k < MULTIBAND_MAX_CROSSOVERS; ++k) {
+        biquad_bank_reset(&xo->lowpass[k]);
+        biquad_bank_reset(&xo->highpass[k]);
+        biquad_bank_reset(&xo->allpass[k]);
+    }
+}
+
+// Azzera gli stati dei filtri decaduti verso i denormali (a fine blocco)
+static inline void crossover_flush_denormals(Crossover* xo) {
+    for (int k = 0; k < xo->num_bands - 1; ++k) {
+        biquad_bank_flush_denormals(&xo->lowpass[k]);
+        biquad_bank_flush_denormals(&xo->highpass[k]);
+        biquad_bank_flush_denormals(&xo->allpass[k]);
+    }
+}
+
+// Vero se tutti i filtri del crossover sono a riposo
+static inline bool crossover_is_silent(const Crossover* xo) {
+    for (int k = 0; k < xo->num_bands - 1; ++k) {
+        if (!biquad_bank_is_silent(&xo->lowpass[k]) || !biquad_bank_is_silent(&xo->highpass[k]) ||
+            !biquad_bank_is_silent(&xo->allpass[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Imposta numero di bande e frequenze. Le frequenze si ordinano a forza (ognuna almeno
+// MULTIBAND_MIN_SPACING volte la precedente) e restano sotto MULTIBAND_MAX_FREQ_RATIO * fs.
+// Solo un cambio del numero di bande azzera gli stati; un cambio di frequenza tocca i coefficienti.
+static void crossover_configure(Crossover* xo, int num_bands, const float* freq_hz, double samplerate) {
+    if (num_bands < 1) num_bands = 1;
+    if (num_bands > MULTIBAND_MAX_BANDS) num_bands = MULTIBAND_MAX_BANDS;
+
+    const float max_freq = (float)(samplerate * MULTIBAND_MAX_FREQ_RATIO);
+    float previous = MULTIBAND_MIN_FREQ / MULTIBAND_MIN_SPACING;
+    for (int k = 0; k < MULTIBAND_MAX_CROSSOVERS; ++k) {
+        float f = freq_hz[k];
+        if (f < previous * MULTIBAND_MIN_SPACING) f = previous * MULTIBAND_MIN_SPACING;
+        if (f > max_freq) f = max_freq;
+        xo->freq[k] = previous = f;
+
+        crossover_stage(&xo->lowpass[k], 0, samplerate, f, 0);
+        crossover_stage(&xo->lowpass[k], 1, samplerate, f, 0);
+        crossover_stage(&xo->highpass[k], 0, samplerate, f, 1);
+        crossover_stage(&xo->highpass[k], 1, samplerate, f, 1);
+    }
+
+    // La banda k passa per i passa-tutto dei crossover k+1 .. num_bands-2
+    for (int k = 0; k < MULTIBAND_MAX_CROSSOVERS; ++k) {
+        int stages = 0;
+        for (int j = k + 1; j < num_bands - 1; ++j) {
+            crossover_stage(&xo->allpass[k], stages++, samplerate, xo->freq[j], 2);
+        }
+        xo->allpass[k].num_stages = stages;
+    }
+
+    if (num_bands != xo->num_bands) {
+        xo->num_bands = num_bands;
+        crossover_reset(xo);
+    }
+}
+
+
+// Prende frequenze e coefficienti da un crossover progettato altrove (nel worker, vedi gla3a.cpp)
+// con le stesse regole di crossover_configure(): gli stati si azzerano solo se cambia il numero di bande
+static inline void crossover_copy_coeffs(Crossover* xo, const Crossover* from) {
+    for (int k = 0; k < MULTIBAND_MAX_CROSSOVERS; ++k) {
+        xo->freq[k] = from->freq[k];
+        biquad_bank_copy_coeffs(&xo->lowpass[k], &from->lowpass[k]);
+        biquad_bank_copy_coeffs(&xo->highpass[k], &from->highpass[k]);
+        biquad_bank_copy_coeffs(&xo->allpass[k], &from->allpass[k]);
+    }
+    if (from->num_bands != xo->num_bands) {
+        xo->num_bands = from->num_bands;
+        crossover_reset(xo);
+    }
+}
+
+// --- Stadi del Blocco ---
+
+// Divide M e S in bande: bands_M[i][k] è il campione i della banda k (corsie oltre num_bands a zero)
+static void stage_crossover(Crossover* xo, const float* in_M, const float* in_S, v4sf* bands_M, v4sf* bands_S, uint32_t n) {
+    const int last = xo->num_bands - 1;
+    for (uint32_t i = 0; i < n; ++i) {
+        vreal rest = vreal_pack_ms(in_M[i], in_S[i]);
+        v4sf band_M = v4sf_set1(0.0f);
+        v4sf band_S = v4sf_set1(0.0f);
+        for (int k = 0; k < last; ++k) {
+            vreal low = biquad_bank_tick(&xo->lowpass[k], rest);
+            rest = biquad_bank_tick(&xo->highpass[k], rest);
+            low = biquad_bank_tick(&xo->allpass[k], low);
+            band_M[k] = low[LANE_M];
+            band_S[k] = low[LANE_S];
+        }
+        band_M[last] = rest[LANE_M];
+        band_S[last] = rest[LANE_S];
+        bands_M[i] = band_M;
+        bands_S[i] = band_S;
+    }
+}
+
+// Costanti del detector per banda, comuni ai due canali
+typedef struct {
+    const GainComputer* gain_computer;
+    v4sf threshold_db;          // Soglia di ogni banda (offset compreso)
+    float make_up_gain_linear;
+    float attack_alpha;
+    float release_alpha;
+    float smooth_alpha;
+} BandDetector;
+
+static inline v4sf band_abs(v4sf x) {
+    const v4si abs_mask = { 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF };
+    return (v4sf)((v4si)x & abs_mask);
+}
+
+// Stesso livello collegato di link_level(), per corsia
+static inline v4sf band_link_level(v4sf a, v4sf b, bool sum) {
+    return sum ? (a + b) * 0.5f : ((a > b) ? a : b);
+}
+
+// Stesse operazioni di envelope_tick(), con attacco/rilascio scelti per corsia
+static inline v4sf band_envelope_tick(const BandDetector* det, v4sf env, v4sf rectified) {
+    v4sf attack = (env * (1.0f - det->attack_alpha)) + (rectified * det->attack_alpha);
+    v4sf release = (env * (1.0f - det->release_alpha)) + (rectified * det->release_alpha);
+    return (rectified > env) ? attack : release;
+}
+
+// Gain computer e smoothing: nuovo guadagno applicato a partire dall'envelope
+static inline v4sf band_gain_tick(const BandDetector* det, v4sf gain, v4sf env) {
+    v4sf target_gr_db = gain_computer_lookup_v4(det->gain_computer, to_db_v4(env), det->threshold_db);
+    v4sf target = db_to_linear_v4(-target_gr_db) * det->make_up_gain_linear;
+    return (gain * (1.0f - det->smooth_alpha)) + (target * det->smooth_alpha);
+}
+
+static inline float band_sum(v4sf y) {
+    return (y[0] + y[1]) + (y[2] + y[3]);
+}
+
+// Detector, gain computer, smoothing e somma delle bande di un canale, in un solo passo
+// vettoriale per campione
+static void stage_band_dynamics(BandDynamics* d, const v4sf* bands, float* out, uint32_t n, const BandDetector* det) {
+    v4sf env = d->envelope;
+    v4sf gain = d->gain;
+    for (uint32_t i = 0; i < n; ++i) {
+        const v4sf x = bands[i];
+        env = band_envelope_tick(det, env, band_abs(x));
+        gain = band_gain_tick(det, gain, env);
+        out[i] = band_sum(x * gain);
+    }
+    d->envelope = env;
+    d->gain = gain;
+}
+
+// Detector collegati: un solo envelope e guadagno per banda, applicato a entrambi i canali
+static inline void stage_band_dynamics_linked(BandDynamics* d, const v4sf* bands_M, const v4sf* bands_S,
+                                       float* out_M, float* out_S, uint32_t n, const BandDetector* det, bool sum) {
+    v4sf env = d->envelope;
+    v4sf gain = d->gain;
+    for (uint32_t i = 0; i < n; ++i) {
+        const v4sf x_M = bands_M[i];
+        const v4sf x_S = bands_S[i];
+        env = band_envelope_tick(det, env, band_link_level(band_abs(x_M), band_abs(x_S), sum));
+        gain = band_gain_tick(det, gain, env);
+        out_M[i] = band_sum(x_M * gain);
+        out_S[i] = band_sum(x_S * gain);
+    }
+    d->envelope = env;
+    d->gain = gain;
+}
+
+// Collegamento misto: envelope per canale, spostati di 'amount' verso il livello collegato
+// prima del gain computer (come stage_link_blend())
+static inline void stage_band_dynamics_blend(BandDynamics* d_M, BandDynamics* d_S, const v4sf* bands_M, const v4sf* bands_S,
+                                      float* out_M, float* out_S, uint32_t n, const BandDetector* det,
+                                      float amount, bool sum) {
+    v4sf env_M = d_M->envelope, env_S = d_S->envelope;
+    v4sf gain_M = d_M->gain, gain_S = d_S->gain;
+    for (uint32_t i = 0; i < n; ++i) {
+        const v4sf x_M = bands_M[i];
+        const v4sf x_S = bands_S[i];
+        env_M = band_envelope_tick(det, env_M, band_abs(x_M));
+        env_S = band_envelope_tick(det, env_S, band_abs(x_S));
+        const v4sf linked = band_link_level(env_M, env_S, sum);
+        gain_M = band_gain_tick(det, gain_M, env_M + (linked - env_M) * amount);
+        gain_S = band_gain_tick(det, gain_S, env_S + (linked - env_S) * amount);
+        out_M[i] = band_sum(x_M * gain_M);
+        out_S[i] = band_sum(x_S * gain_S);
+    }
+    d_M->envelope = env_M;
+    d_S->envelope = env_S;
+    d_M->gain = gain_M;
+    d_S->gain = gain_S;
+}
+
+static void band_dynamics_reset(BandDynamics* d) {
+    d->envelope = v4sf_set1(0.0f);
+    d->gain = v4sf_set1(1.0f);
+}
+
+// Il guadagno resta vicino al make-up: solo l'envelope decade verso i denormali
+static inline void band_dynamics_flush_denormals(BandDynamics* d) {
+    d->envelope = flush_denormal_v4(d->envelope);
+}
+
+#endif // GLA3A_MULTIBAND_H
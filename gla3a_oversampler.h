@@ -0,0 +1,502 @@
+#ifndef GLA3A_OVERSAMPLER_H
+#define GLA3A_OVERSAMPLER_H
+
+// --- Motore di Oversampling Polifase ---
+// Cascata di stadi 2x (fino a 3 stadi = 8x). Ogni stadio è un filtro half-band in forma polifase,
+// quindi sia l'interpolazione che la decimazione lavorano alla frequenza più bassa dello stadio
+// e non calcolano mai i campioni che verrebbero scartati.
+//  - OS_MODE_LINEAR_PHASE: FIR half-band simmetrico (finestra di Kaiser), latenza intera e costante.
+//  - OS_MODE_LOW_LATENCY:  IIR half-band a due rami allpass (Valenzuela/Constantinides), fase non lineare.
+// M e S condividono i coefficienti: gli stati sono vettori v4sf con un canale per corsia,
+// così ogni tap/cella elabora entrambi i canali con una sola istruzione.
+
+#include "gla3a_denormal.h"
+#include "gla3a_kernels.h"
+#include "gla3a_simd.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#define OS_MAX_STAGES 3
+#define OS_MAX_FACTOR (1 << OS_MAX_STAGES)
+
+// FIR half-band: N = 4K - 1 tap, la fase "pari" contiene 2K coefficienti, la fase "dispari" solo il centro.
+#define OS_FIR_MAX_HALF_LEN 12
+#define OS_FIR_KAISER_BETA 7.0
+
+// IIR half-band: numero massimo di celle allpass del primo ordine (divise sui due rami).
+#define OS_IIR_MAX_COEFS 8
+
+// K e celle di ogni stadio (s = 0 è quello alla frequenza più bassa), costanti anche per i kernel
+// specializzati: gli stadi successivi lavorano più in alto e bastano filtri più corti
+#define OS_FIR_HALF_LEN(s) ((s) == 0 ? 12 : (s) == 1 ? 4 : 3)
+#define OS_IIR_COEFS(s)    ((s) == 0 ? 8 : (s) == 1 ? 4 : 3)
+
+typedef enum {
+    OS_MODE_LINEAR_PHASE = 0,
+    OS_MODE_LOW_LATENCY  = 1
+} OversamplerMode;
+
+// Stadio FIR 2x. Le storie usano un buffer "raddoppiato" (ogni campione scritto in pos e pos+len)
+// così la convoluzione legge sempre un blocco contiguo senza modulo.
+typedef struct {
+    int   half_len;                          // K
+    float taps[2 * OS_FIR_MAX_HALF_LEN];     // h[2k], k = 0..2K-1 (simmetrici)
+
+    v4sf  up_hist[4 * OS_FIR_MAX_HALF_LEN];  // ultimi 2K campioni in ingresso all'interpolatore
+    int   up_pos;
+    v4sf  dn_even_hist[4 * OS_FIR_MAX_HALF_LEN];    // campioni pari in ingresso al decimatore
+    int   dn_even_pos;
+    v4sf  dn_odd_hist[2 * (OS_FIR_MAX_HALF_LEN + 1)]; // campioni dispari (solo ritardo di K)
+    int   dn_odd_pos;
+} HalfbandFirStage;
+
+// Stadio IIR 2x: coefficienti pari sul ramo A0, dispari sul ramo A1.
+// Ogni cella è (a + z^-1) / (1 + a z^-1) alla frequenza bassa dello stadio.
+typedef struct {
+    int   num_coefs;
+    float coefs[OS_IIR_MAX_COEFS];
+
+    v4sf  up_x1[OS_IIR_MAX_COEFS], up_y1[OS_IIR_MAX_COEFS];
+    v4sf  dn_x1[OS_IIR_MAX_COEFS], dn_y1[OS_IIR_MAX_COEFS];
+    v4sf  dn_odd_delay; // campione dispari del passo precedente (z^-1 del ramo A1)
+} HalfbandIirStage;
+
+typedef struct {
+    int mode;       // OversamplerMode
+    int factor;     // 1, 2, 4, 8
+    int num_stages; // log2(factor)
+
+    HalfbandFirStage fir[OS_MAX_STAGES];
+    HalfbandIirStage iir[OS_MAX_STAGES];
+
+    // Ritardo di allineamento alla frequenza più alta: rende intera la latenza in modalità lineare.
+    v4sf  pad_hist[2 * OS_MAX_FACTOR];
+    int   pad_len;
+    int   pad_pos;
+
+    float latency; // In campioni alla frequenza originale
+} Oversampler;
+
+
+// --- Progettazione dei Filtri (solo fuori dal loop audio) ---
+
+static double os_bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 64; ++k) {
+        double h = x / (2.0 * k);
+        term *= h * h;
+        sum += term;
+        if (term < 1e-20 * sum) break;
+    }
+    return sum;
+}
+
+static void os_design_fir_stage(HalfbandFirStage* st, int half_len) {
+    const int center = 2 * half_len - 1;
+    double taps[2 * OS_FIR_MAX_HALF_LEN];
+    double sum = 0.0;
+
+    // Sinc half-band finestrato: solo gli offset dispari dal centro sono non nulli.
+    for (int k = 0; k < 2 * half_len; ++k) {
+        int m = 2 * k - center;
+        double r = (double)m / center;
+        double sinc = sin(M_PI * m / 2.0) / (M_PI * m);
+        taps[k] = sinc * os_bessel_i0(OS_FIR_KAISER_BETA * sqrt(1.0 - r * r)) / os_bessel_i0(OS_FIR_KAISER_BETA);
+        sum += taps[k];
+    }
+    // Guadagno DC unitario: il centro vale 0.5, la fase pari deve sommare a 0.5.
+    st->half_len = half_len;
+    for (int k = 0; k < 2 * half_len; ++k) {
+        st->taps[k] = (float)(taps[k] * 0.5 / sum);
+    }
+}
+
+// Parametri ellittici per la transizione richiesta (banda di transizione normalizzata alla fs alta).
+static void os_iir_transition_param(double* k, double* q, double transition) {
+    *k = tan((1.0 - transition * 2.0) * M_PI / 4.0);
+    *k *= *k;
+    double kksqrt = pow(1.0 - *k * *k, 0.25);
+    double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+    double e2 = e * e;
+    double e4 = e2 * e2;
+    *q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+}
+
+static double os_iir_acc_num(double q, int order, int c) {
+    double acc = 0.0, term;
+    int i = 0, sign = 1;
+    do {
+        term = pow(q, i * (i + 1)) * sin((i * 2 + 1) * c * M_PI / order) * sign;
+        acc += term;
+        sign = -sign;
+        ++i;
+    } while (fabs(term) > 1e-100);
+    return acc;
+}
+
+static double os_iir_acc_den(double q, int order, int c) {
+    double acc = 0.0, term;
+    int i = 1, sign = -1;
+    do {
+        term = pow(q, i * i) * cos(i * 2 * c * M_PI / order) * sign;
+        acc += term;
+        sign = -sign;
+        ++i;
+    } while (fabs(term) > 1e-100);
+    return acc;
+}
+
+static void os_design_iir_stage(HalfbandIirStage* st, int num_coefs, double transition) {
+    double k, q;
+    os_iir_transition_param(&k, &q, transition);
+    const int order = num_coefs * 2 + 1;
+
+    st->num_coefs = num_coefs;
+    for (int i = 0; i < num_coefs; ++i) {
+        double num = os_iir_acc_num(q, order, i + 1) * pow(q, 0.25);
+        double den = os_iir_acc_den(q, order, i + 1) + 0.5;
+        double ww = num / den;
+        double wwsq = ww * ww;
+        double x = sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+        st->coefs[i] = (float)((1.0 - x) / (1.0 + x));
+    }
+}
+
+// Ritardo di gruppo a DC dello stadio IIR, in campioni alla fs alta dello stadio.
+static double os_iir_stage_dc_delay(const HalfbandIirStage* st) {
+    double d0 = 0.0, d1 = 0.0;
+    for (int i = 0; i < st->num_coefs; ++i) {
+        double a = st->coefs[i];
+        double d = 2.0 * (1.0 - a) / (1.0 + a); // Cella in z^-2
+        if (i % 2 == 0) d0 += d; else d1 += d;
+    }
+    return (d0 + d1 + 1.0) * 0.5;
+}
+
+
+// --- Gestione dello Stato ---
+
+static void oversampler_reset(Oversampler* os) {
+    for (int s = 0; s < OS_MAX_STAGES; ++s) {
+        HalfbandFirStage* f = &os->fir[s];
+        memset(f->up_hist, 0, sizeof(f->up_hist));
+        memset(f->dn_even_hist, 0, sizeof(f->dn_even_hist));
+        memset(f->dn_odd_hist, 0, sizeof(f->dn_odd_hist));
+        f->up_pos = f->dn_even_pos = f->dn_odd_pos = 0;
+
+        HalfbandIirStage* r = &os->iir[s];
+        memset(r->up_x1, 0, sizeof(r->up_x1));
+        memset(r->up_y1, 0, sizeof(r->up_y1));
+        memset(r->dn_x1, 0, sizeof(r->dn_x1));
+        memset(r->dn_y1, 0, sizeof(r->dn_y1));
+        r->dn_odd_delay = v4sf_set1(0.0f);
+    }
+    memset(os->pad_hist, 0, sizeof(os->pad_hist));
+    os->pad_pos = 0;
+}
+
+// Azzera gli stati delle celle allpass decaduti verso i denormali (a fine blocco).
+// Le storie FIR non sono ricorsive: un ingresso nullo le svuota da sole.
+static inline void oversampler_flush_denormals(Oversampler* os) {
+    if (os->mode != OS_MODE_LOW_LATENCY) return;
+    for (int s = 0; s < os->num_stages; ++s) {
+        HalfbandIirStage* r = &os->iir[s];
+        flush_denormals_v4(r->up_x1, r->num_coefs);
+        flush_denormals_v4(r->up_y1, r->num_coefs);
+        flush_denormals_v4(r->dn_x1, r->num_coefs);
+        flush_denormals_v4(r->dn_y1, r->num_coefs);
+        r->dn_odd_delay = flush_denormal_v4(r->dn_odd_delay);
+    }
+}
+
+// Vero se tutte le storie e gli stati sono nulli: il silenzio in ingresso resta silenzio in uscita
+static inline bool oversampler_is_silent(const Oversampler* os) {
+    for (int s = 0; s < OS_MAX_STAGES; ++s) {
+        const HalfbandFirStage* f = &os->fir[s];
+        const HalfbandIirStage* r = &os->iir[s];
+        if (!v4sf_all_zero(f->up_hist, 4 * OS_FIR_MAX_HALF_LEN) ||
+            !v4sf_all_zero(f->dn_even_hist, 4 * OS_FIR_MAX_HALF_LEN) ||
+            !v4sf_all_zero(f->dn_odd_hist, 2 * (OS_FIR_MAX_HALF_LEN + 1)) ||
+            !v4sf_all_zero(r->up_x1, OS_IIR_MAX_COEFS) || !v4sf_all_zero(r->up_y1, OS_IIR_MAX_COEFS) ||
+            !v4sf_all_zero(r->dn_x1, OS_IIR_MAX_COEFS) || !v4sf_all_zero(r->dn_y1, OS_IIR_MAX_COEFS) ||
+            !v4sf_all_zero(&r->dn_odd_delay, 1)) {
+            return false;
+        }
+    }
+    return v4sf_all_zero(os->pad_hist, 2 * OS_MAX_FACTOR);
+}
+
+// Ritardo dello stadio s (andata e ritorno) in campioni alla frequenza originale
+static inline double os_stage_latency(const Oversampler* os, int s, int mode) {
+    const double rate = (double)(2 << s); // fs alta dello stadio, in multipli della fs originale
+    if (mode == OS_MODE_LINEAR_PHASE) return 2.0 * (2 * os->fir[s].half_len - 1) / rate;
+    return 2.0 * os_iir_stage_dc_delay(&os->iir[s]) / rate;
+}
+
+// Latenza più alta su tutti i fattori e le modalità (campioni interi, per eccesso)
+static inline uint32_t oversampler_max_latency(const Oversampler* os) {
+    double worst = 0.0;
+    for (int mode = OS_MODE_LINEAR_PHASE; mode <= OS_MODE_LOW_LATENCY; ++mode) {
+        double latency = 0.0;
+        for (int s = 0; s < OS_MAX_STAGES; ++s) latency += os_stage_latency(os, s, mode);
+        if (latency > worst) worst = latency;
+    }
+    return (uint32_t)ceil(worst);
+}
+
+// Imposta fattore e modalità, ricalcola la latenza e azzera gli stati. Non alloca, non usa trascendenti.
+static void oversampler_configure(Oversampler* os, int factor, int mode) {
+    int stages = 0;
+    while ((1 << stages) < factor && stages < OS_MAX_STAGES) ++stages;
+
+    os->factor = 1 << stages;
+    os->num_stages = stages;
+    os->mode = mode;
+
+    double latency = 0.0;
+    for (int s = 0; s < stages; ++s) latency += os_stage_latency(os, s, mode);
+
+    os->pad_len = 0;
+    if (mode == OS_MODE_LINEAR_PHASE && stages > 0) {
+        double whole = ceil(latency - 1e-9);
+        os->pad_len = (int)((whole - latency) * os->factor + 0.5);
+        latency = whole;
+    }
+    os->latency = (float)latency;
+
+    oversampler_reset(os);
+}
+
+// Progetta tutti i kernel (chiamata una volta in instantiate).
+static void oversampler_init(Oversampler* os) {
+    static const double iir_transition[OS_MAX_STAGES] = { 0.04, 0.12, 0.2 };
+
+    memset(os, 0, sizeof(*os));
+    for (int s = 0; s < OS_MAX_STAGES; ++s) {
+        os_design_fir_stage(&os->fir[s], OS_FIR_HALF_LEN(s));
+        os_design_iir_stage(&os->iir[s], OS_IIR_COEFS(s), iir_transition[s]);
+    }
+    oversampler_configure(os, 1, OS_MODE_LINEAR_PHASE);
+}
+
+
+// --- Elaborazione ---
+
+static inline v4sf os_allpass_tick(float a, v4sf x, v4sf* x1, v4sf* y1) {
+    v4sf y = a * (x - *y1) + *x1;
+    *x1 = x;
+    *y1 = y;
+    return y;
+}
+
+// Fase pari del FIR simmetrico ripiegato sui 2K campioni x[0..2K-1]. Con K noto a compilazione
+// (HALF) il loop si srotola: i tap diventano una catena di moltiplicazioni senza contatore.
+template <int HALF>
+static inline v4sf os_fir_fold(const float* taps, const v4sf* x, int half) {
+    v4sf acc = v4sf_set1(0.0f);
+    if (HALF == KERNEL_RUNTIME) {
+        for (int k = 0; k < half; ++k) {
+            acc += taps[k] * (x[k] + x[2 * half - 1 - k]);
+        }
+    } else {
+#pragma GCC unroll 16
+        for (int k = 0; k < HALF; ++k) {
+            acc += taps[k] * (x[k] + x[2 * HALF - 1 - k]);
+        }
+    }
+    return acc;
+}
+
+// Un ramo allpass dell'IIR: le celle first, first + 2, ... (stesso srotolamento con NC noto)
+template <int NC>
+static inline v4sf os_allpass_branch(const float* coefs, int first, v4sf a, v4sf* x1, v4sf* y1, int nc) {
+    if (NC == KERNEL_RUNTIME) {
+        for (int c = first; c < nc; c += 2) {
+            a = os_allpass_tick(coefs[c], a, &x1[c], &y1[c]);
+        }
+    } else {
+#pragma GCC unroll 8
+        for (int c = first; c < NC; c += 2) {
+            a = os_allpass_tick(coefs[c], a, &x1[c], &y1[c]);
+        }
+    }
+    return a;
+}
+
+// HALF (e NC per gli IIR): K dello stadio noto a compilazione, o KERNEL_RUNTIME per leggerlo dallo stadio
+template <int HALF>
+static void os_fir_upsample(HalfbandFirStage* st, const float* in_M, const float* in_S,
+                            float* out_M, float* out_S, uint32_t n) {
+    const int half = KERNEL_PARAM(HALF, st->half_len);
+    const int len = 2 * half;
+    for (uint32_t i = 0; i < n; ++i) {
+        st->up_pos = (st->up_pos == 0) ? len - 1 : st->up_pos - 1;
+        st->up_hist[st->up_pos] = st->up_hist[st->up_pos + len] = v4sf_pack_ms(in_M[i], in_S[i]);
+        const v4sf* x = &st->up_hist[st->up_pos]; // x[k] = ingresso di k campioni fa
+
+        // Fase pari: FIR simmetrico ripiegato. Fase dispari: solo il tap centrale (ritardo puro).
+        v4sf acc = os_fir_fold<HALF>(st->taps, x, half);
+        acc *= 2.0f;
+        out_M[2 * i] = acc[LANE_M];
+        out_S[2 * i] = acc[LANE_S];
+        out_M[2 * i + 1] = x[half - 1][LANE_M];
+        out_S[2 * i + 1] = x[half - 1][LANE_S];
+    }
+}
+
+// 'in' contiene 2n campioni, 'out' ne riceve n. Può lavorare in-place (out == in).
+template <int HALF>
+static void os_fir_downsample(HalfbandFirStage* st, const float* in_M, const float* in_S,
+                              float* out_M, float* out_S, uint32_t n) {
+    const int half = KERNEL_PARAM(HALF, st->half_len);
+    const int len = 2 * half;
+    const int odd_len = half + 1;
+    for (uint32_t i = 0; i < n; ++i) {
+        v4sf even = v4sf_pack_ms(in_M[2 * i], in_S[2 * i]);
+        v4sf odd = v4sf_pack_ms(in_M[2 * i + 1], in_S[2 * i + 1]);
+
+        st->dn_even_pos = (st->dn_even_pos == 0) ? len - 1 : st->dn_even_pos - 1;
+        st->dn_even_hist[st->dn_even_pos] = st->dn_even_hist[st->dn_even_pos + len] = even;
+        st->dn_odd_pos = (st->dn_odd_pos == 0) ? odd_len - 1 : st->dn_odd_pos - 1;
+        st->dn_odd_hist[st->dn_odd_pos] = st->dn_odd_hist[st->dn_odd_pos + odd_len] = odd;
+
+        const v4sf* x = &st->dn_even_hist[st->dn_even_pos];
+        v4sf acc = os_fir_fold<HALF>(st->taps, x, half);
+        acc += 0.5f * st->dn_odd_hist[st->dn_odd_pos + half];
+        out_M[i] = acc[LANE_M];
+        out_S[i] = acc[LANE_S];
+    }
+}
+
+template <int NC>
+static void os_iir_upsample(HalfbandIirStage* st, const float* in_M, const float* in_S,
+                            float* out_M, float* out_S, uint32_t n) {
+    const int nc = KERNEL_PARAM(NC, st->num_coefs);
+    for (uint32_t i = 0; i < n; ++i) {
+        v4sf a0 = v4sf_pack_ms(in_M[i], in_S[i]);
+        v4sf a1 = a0;
+        a0 = os_allpass_branch<NC>(st->coefs, 0, a0, st->up_x1, st->up_y1, nc);
+        a1 = os_allpass_branch<NC>(st->coefs, 1, a1, st->up_x1, st->up_y1, nc);
+        out_M[2 * i] = a0[LANE_M];
+        out_S[2 * i] = a0[LANE_S];
+        out_M[2 * i + 1] = a1[LANE_M];
+        out_S[2 * i + 1] = a1[LANE_S];
+    }
+}
+
+template <int NC>
+static void os_iir_downsample(HalfbandIirStage* st, const float* in_M, const float* in_S,
+                              float* out_M, float* out_S, uint32_t n) {
+    const int nc = KERNEL_PARAM(NC, st->num_coefs);
+    for (uint32_t i = 0; i < n; ++i) {
+        v4sf a0 = v4sf_pack_ms(in_M[2 * i], in_S[2 * i]);
+        v4sf a1 = st->dn_odd_delay;
+        st->dn_odd_delay = v4sf_pack_ms(in_M[2 * i + 1], in_S[2 * i + 1]);
+        a0 = os_allpass_branch<NC>(st->coefs, 0, a0, st->dn_x1, st->dn_y1, nc);
+        a1 = os_allpass_branch<NC>(st->coefs, 1, a1, st->dn_x1, st->dn_y1, nc);
+        v4sf y = 0.5f * (a0 + a1);
+        out_M[i] = y[LANE_M];
+        out_S[i] = y[LANE_S];
+    }
+}
+
+// Uno stadio 2x. Con KNOWN i tap sono le costanti OS_FIR_HALF_LEN/OS_IIR_COEFS dello stadio 's'
+// (kernel specializzati), altrimenti si leggono dallo stadio
+template <bool KNOWN>
+static void os_upsample_stage(Oversampler* os, int s, const float* in_M, const float* in_S,
+                              float* out_M, float* out_S, uint32_t n) {
+    if (os->mode == OS_MODE_LINEAR_PHASE) {
+        HalfbandFirStage* st = &os->fir[s];
+        if (!KNOWN)      os_fir_upsample<KERNEL_RUNTIME>(st, in_M, in_S, out_M, out_S, n);
+        else if (s == 0) os_fir_upsample<OS_FIR_HALF_LEN(0)>(st, in_M, in_S, out_M, out_S, n);
+        else if (s == 1) os_fir_upsample<OS_FIR_HALF_LEN(1)>(st, in_M, in_S, out_M, out_S, n);
+        else             os_fir_upsample<OS_FIR_HALF_LEN(2)>(st, in_M, in_S, out_M, out_S, n);
+    } else {
+        HalfbandIirStage* st = &os->iir[s];
+        if (!KNOWN)      os_iir_upsample<KERNEL_RUNTIME>(st, in_M, in_S, out_M, out_S, n);
+        else if (s == 0) os_iir_upsample<OS_IIR_COEFS(0)>(st, in_M, in_S, out_M, out_S, n);
+        else if (s == 1) os_iir_upsample<OS_IIR_COEFS(1)>(st, in_M, in_S, out_M, out_S, n);
+        else             os_iir_upsample<OS_IIR_COEFS(2)>(st, in_M, in_S, out_M, out_S, n);
+    }
+}
+
+template <bool KNOWN>
+static void os_downsample_stage(Oversampler* os, int s, const float* in_M, const float* in_S,
+                                float* out_M, float* out_S, uint32_t n) {
+    if (os->mode == OS_MODE_LINEAR_PHASE) {
+        HalfbandFirStage* st = &os->fir[s];
+        if (!KNOWN)      os_fir_downsample<KERNEL_RUNTIME>(st, in_M, in_S, out_M, out_S, n);
+        else if (s == 0) os_fir_downsample<OS_FIR_HALF_LEN(0)>(st, in_M, in_S, out_M, out_S, n);
+        else if (s == 1) os_fir_downsample<OS_FIR_HALF_LEN(1)>(st, in_M, in_S, out_M, out_S, n);
+        else             os_fir_downsample<OS_FIR_HALF_LEN(2)>(st, in_M, in_S, out_M, out_S, n);
+    } else {
+        HalfbandIirStage* st = &os->iir[s];
+        if (!KNOWN)      os_iir_downsample<KERNEL_RUNTIME>(st, in_M, in_S, out_M, out_S, n);
+        else if (s == 0) os_iir_downsample<OS_IIR_COEFS(0)>(st, in_M, in_S, out_M, out_S, n);
+        else if (s == 1) os_iir_downsample<OS_IIR_COEFS(1)>(st, in_M, in_S, out_M, out_S, n);
+        else             os_iir_downsample<OS_IIR_COEFS(2)>(st, in_M, in_S, out_M, out_S, n);
+    }
+}
+
+// Interpola n campioni (M e S) in n * factor campioni.
+// Ogni 'scratch' deve contenere almeno n * OS_MAX_FACTOR / 2 campioni.
+// STAGES: numero di stadi noto a compilazione (gla3a_kernels.h, uguale a quello configurato)
+// o KERNEL_RUNTIME per leggerlo dall'oversampler.
+template <int STAGES = KERNEL_RUNTIME>
+static void oversampler_upsample(Oversampler* os, const float* in_M, const float* in_S,
+                                 float* out_M, float* out_S, float* scratch_M, float* scratch_S, uint32_t n) {
+    const int num_stages = KERNEL_PARAM(STAGES, os->num_stages);
+    if (num_stages == 0) {
+        if (out_M != in_M) memcpy(out_M, in_M, sizeof(float) * n);
+        if (out_S != in_S) memcpy(out_S, in_S, sizeof(float) * n);
+        return;
+    }
+
+    // Alterna out/scratch in modo che l'ultimo stadio scriva sempre in 'out'.
+    const float* src_M = in_M;
+    const float* src_S = in_S;
+    uint32_t len = n;
+    for (int s = 0; s < num_stages; ++s) {
+        bool to_out = ((num_stages - 1 - s) % 2 == 0);
+        float* dst_M = to_out ? out_M : scratch_M;
+        float* dst_S = to_out ? out_S : scratch_S;
+        os_upsample_stage<STAGES != KERNEL_RUNTIME>(os, s, src_M, src_S, dst_M, dst_S, len);
+        src_M = dst_M;
+        src_S = dst_S;
+        len *= 2;
+    }
+}
+
+// Decima n * factor campioni (modificati sul posto) in n campioni scritti in 'out'.
+template <int STAGES = KERNEL_RUNTIME>
+static void oversampler_downsample(Oversampler* os, float* buf_M, float* buf_S,
+                                   float* out_M, float* out_S, uint32_t n) {
+    const int num_stages = KERNEL_PARAM(STAGES, os->num_stages);
+    if (num_stages == 0) {
+        if (out_M != buf_M) memcpy(out_M, buf_M, sizeof(float) * n);
+        if (out_S != buf_S) memcpy(out_S, buf_S, sizeof(float) * n);
+        return;
+    }
+
+    uint32_t len = n << num_stages;
+    if (os->pad_len > 0) {
+        const int plen = os->pad_len + 1;
+        for (uint32_t i = 0; i < len; ++i) {
+            os->pad_pos = (os->pad_pos == 0) ? plen - 1 : os->pad_pos - 1;
+            os->pad_hist[os->pad_pos] = os->pad_hist[os->pad_pos + plen] = v4sf_pack_ms(buf_M[i], buf_S[i]);
+            v4sf delayed = os->pad_hist[os->pad_pos + os->pad_len];
+            buf_M[i] = delayed[LANE_M];
+            buf_S[i] = delayed[LANE_S];
+        }
+    }
+
+    for (int s = num_stages - 1; s >= 0; --s) {
+        len /= 2;
+        float* dst_M = (s == 0) ? out_M : buf_M;
+        float* dst_S = (s == 0) ? out_S : buf_S;
+        os_downsample_stage<STAGES != KERNEL_RUNTIME>(os, s, buf_M, buf_S, dst_M, dst_S, len);
+    }
+}
+
+#endif // GLA3A_OVERSAMPLER_H
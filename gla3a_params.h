@@ -0,0 +1,105 @@
+#ifndef GLA3A_PARAMS_H
+#define GLA3A_PARAMS_H
+
+// --- Stato dei Parametri di Controllo ---
+// Per ogni porta di controllo in ingresso si tiene l'ultimo valore letto e un bit "dirty"
+// (indicizzato come GLA3A_PortIndex). run() legge le porte una volta per blocco con params_read();
+// ogni grandezza derivata (alpha, coefficienti, tabelle) si ricalcola solo se uno dei suoi
+// ingressi ha il bit acceso, poi params_clear() azzera la maschera.
+// Un parametro può arrivare anche come patch:Set (params_set()): quel valore resta valido
+// finché l'host non muove la porta, perché params_read() confronta ogni porta con l'ultimo
+// valore letto dalla porta stessa e non con il valore corrente. Lo stesso vale per un valore
+// ripristinato dallo stato (params_restore()).
+
+#include <stdint.h>
+#include <string.h>
+
+#define PARAMS_MAX_PORTS 64 // Un bit per porta in ParamMask
+
+typedef uint64_t ParamMask;
+
+#define PARAM_BIT(port) ((ParamMask)1 << (port))
+#define PARAMS_ALL      (~(ParamMask)0)
+
+typedef struct {
+    const float* ports[PARAMS_MAX_PORTS]; // Buffer delle porte di controllo in ingresso
+    float        value[PARAMS_MAX_PORTS]; // Valore corrente (dalla porta o da patch:Set)
+    float        port_value[PARAMS_MAX_PORTS]; // Ultimo valore letto dalla porta
+    ParamMask    connected;               // Porte con un buffer collegato
+    ParamMask    dirty;                   // Porte cambiate dall'ultimo params_clear()
+    ParamMask    stale;                   // Porte da rileggere comunque (collegate o invalidate)
+} ParamState;
+
+static void params_init(ParamState* ps) {
+    memset(ps, 0, sizeof(ParamState));
+    ps->dirty = PARAMS_ALL;
+    ps->stale = PARAMS_ALL;
+}
+
+// Ricollegare lo stesso buffer (alcuni host lo fanno a ogni ciclo) non scavalca un patch:Set
+static void params_connect(ParamState* ps, uint32_t port, const float* data) {
+    if (data == ps->ports[port]) return;
+    ps->ports[port] = data;
+    if (data) ps->connected |= PARAM_BIT(port);
+    else      ps->connected &= ~PARAM_BIT(port);
+    ps->dirty |= PARAM_BIT(port);
+    ps->stale |= PARAM_BIT(port);
+}
+
+// Forza il ricalcolo di tutto ciò che dipende dai parametri (activate). Le porte non si rileggono
+// per forza: quelle già lette hanno il loro riferimento, e un restore fatto prima resta valido.
+static void params_invalidate(ParamState* ps) {
+    ps->dirty = PARAMS_ALL;
+}
+
+// Legge tutte le porte collegate e accende il bit di quelle il cui valore è cambiato.
+// Le porte appena collegate o invalidate si prendono comunque (anche sopra un patch:Set).
+static inline void params_read(ParamState* ps) {
+    ParamMask pending = ps->connected;
+    while (pending) {
+        const int port = __builtin_ctzll(pending);
+        pending &= pending - 1;
+        const float v = *ps->ports[port];
+        if (v != ps->port_value[port] || (ps->stale & PARAM_BIT(port))) {
+            ps->port_value[port] = v;
+            if (v != ps->value[port]) {
+                ps->value[port] = v;
+                ps->dirty |= PARAM_BIT(port);
+            }
+        }
+    }
+    ps->stale = 0;
+}
+
+// Imposta un parametro da un evento (patch:Set), fino al prossimo movimento della porta
+static inline void params_set(ParamState* ps, uint32_t port, float v) {
+    if (v != ps->value[port]) {
+        ps->value[port] = v;
+        ps->dirty |= PARAM_BIT(port);
+    }
+}
+
+// Imposta un parametro dallo stato salvato (restore): come params_set(), e il valore attuale della
+// porta collegata diventa il suo riferimento, così il valore ripristinato resta finché l'host non
+// muove la porta (anche se il restore arriva prima della prima run)
+static inline void params_restore(ParamState* ps, uint32_t port, float v) {
+    params_set(ps, port, v);
+    if (ps->connected & PARAM_BIT(port)) {
+        ps->port_value[port] = *ps->ports[port];
+        ps->stale &= ~PARAM_BIT(port);
+    }
+}
+
+static inline float params_get(const ParamState* ps, uint32_t port) {
+    return ps->value[port];
+}
+
+static inline bool params_changed(const ParamState* ps, ParamMask mask) {
+    return (ps->dirty & mask) != 0;
+}
+
+static inline void params_clear(ParamState* ps) {
+    ps->dirty = 0;
+}
+
+#endif // GLA3A_PARAMS_H
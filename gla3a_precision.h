@@ -0,0 +1,100 @@
+#ifndef GLA3A_PRECISION_H
+#define GLA3A_PRECISION_H
+
+// --- Precisione di Filtri e Detector ---
+// GLA3A_PRECISION sceglie a compilazione il tipo dei filtri (sidechain e crossover: coefficienti e
+// stati) e del detector (envelope, smoothing del guadagno e relativi alpha):
+//   GLA3A_PRECISION_FLOAT   (default) tutto float, il percorso veloce
+//   GLA3A_PRECISION_MIXED   coefficienti e stati double, segnale tra gli stadi float
+//   GLA3A_PRECISION_DOUBLE  anche il segnale del detector (sidechain_buffer, dal rettificato al
+//                           guadagno) in double
+// Con un taglio basso rispetto alla frequenza di campionamento (HP della sidechain a 20 Hz a 192 kHz)
+// i poli stanno a un passo da 1: in float l'arrotondamento di a1/a2 li sposta (al taglio ~0.05 dB
+// per stadio, tests/precision.cpp) e lo stato accumula l'errore. Lo stesso per gli alpha dei
+// rilasci lunghi, dove 1 - alpha si arrotonda.
+// Restano float l'audio, l'oversampling, il limiter, la tabella del gain computer (in dB, dove
+// l'interpolazione sbaglia già di più) e le corsie dell'API a blocchi (gla3a_lanes.h): con una
+// precisione diversa da float le strisce passano tutte dal percorso di una Gla3a singola.
+// Il costo di ogni scelta si misura con "make bench-precision".
+//
+// Compilare con -DGLA3A_PRECISION=GLA3A_PRECISION_MIXED (o _DOUBLE) per cambiarla.
+
+#include "gla3a_simd.h"
+#include <math.h>
+#include <stdint.h>
+
+#define GLA3A_PRECISION_FLOAT  0
+#define GLA3A_PRECISION_MIXED  1
+#define GLA3A_PRECISION_DOUBLE 2
+
+#ifndef GLA3A_PRECISION
+#define GLA3A_PRECISION GLA3A_PRECISION_FLOAT
+#endif
+
+#if GLA3A_PRECISION == GLA3A_PRECISION_FLOAT
+typedef float FilterReal;       // Coefficienti e stati di filtri, envelope e guadagni
+typedef float DetectorReal;     // Segnale del detector tra uno stadio e l'altro
+#define GLA3A_PRECISION_NAME "float"
+#elif GLA3A_PRECISION == GLA3A_PRECISION_MIXED
+typedef double FilterReal;
+typedef float DetectorReal;
+#define GLA3A_PRECISION_NAME "mixed"
+#elif GLA3A_PRECISION == GLA3A_PRECISION_DOUBLE
+typedef double FilterReal;
+typedef double DetectorReal;
+#define GLA3A_PRECISION_NAME "double"
+#else
+#error "GLA3A_PRECISION: valori ammessi GLA3A_PRECISION_FLOAT, _MIXED, _DOUBLE"
+#endif
+
+#define FILTER_PI ((FilterReal)3.14159265358979323846)
+
+// Funzioni della libm nella precisione dell'argomento: in float sono esattamente quelle di prima
+static inline float real_sin(float x) { return sinf(x); }
+static inline double real_sin(double x) { return sin(x); }
+static inline float real_cos(float x) { return cosf(x); }
+static inline double real_cos(double x) { return cos(x); }
+static inline float real_exp(float x) { return expf(x); }
+static inline double real_exp(double x) { return exp(x); }
+static inline float real_max(float a, float b) { return fmaxf(a, b); }
+static inline double real_max(double a, double b) { return fmax(a, b); }
+static inline float real_abs(float x) { return fabsf(x); }
+static inline double real_abs(double x) { return fabs(x); }
+
+
+// --- Registro di FilterReal ---
+// Un registro da 128 bit: 4 corsie float (è v4sf) o 2 double. Le corsie stereo di gla3a_simd.h
+// (LANE_M, LANE_S) ci stanno in entrambi i casi, quindi i banchi di biquad non cambiano forma.
+
+#define VREAL_LANES (16 / (int)sizeof(FilterReal))
+
+typedef FilterReal vreal __attribute__((vector_size(16)));
+#if GLA3A_PRECISION == GLA3A_PRECISION_FLOAT
+typedef int32_t vreal_mask __attribute__((vector_size(16)));
+#else
+typedef int64_t vreal_mask __attribute__((vector_size(16)));
+#endif
+
+static inline vreal vreal_set1(FilterReal x) {
+    vreal v;
+    for (int k = 0; k < VREAL_LANES; ++k) v[k] = x;
+    return v;
+}
+
+// M e S nelle prime due corsie (le altre, se ci sono, a zero)
+static inline vreal vreal_pack_ms(FilterReal m, FilterReal s) {
+    vreal v = vreal_set1(0);
+    v[LANE_M] = m;
+    v[LANE_S] = s;
+    return v;
+}
+
+// Vero se tutte le corsie di tutti i vettori valgono zero (come v4sf_all_zero())
+static inline bool vreal_all_zero(const vreal* v, int count) {
+    vreal_mask any = (vreal_mask)vreal_set1(0);
+    for (int k = 0; k < count; ++k) any |= (v[k] != vreal_set1(0));
+    for (int k = 1; k < VREAL_LANES; ++k) any[0] |= any[k];
+    return !any[0];
+}
+
+#endif // GLA3A_PRECISION_H
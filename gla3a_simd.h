@@ -0,0 +1,96 @@
+#ifndef GLA3A_SIMD_H
+#define GLA3A_SIMD_H
+
+// --- Tipi Vettoriali ---
+// Usiamo le estensioni vettoriali di GCC/Clang invece degli intrinsics: lo stesso codice diventa
+// SSE su x86 e NEON su ARM (MOD Duo/Dwarf), senza #ifdef per architettura.
+// Un registro da 128 bit contiene le corsie stereo del plugin: [0] = M/Left, [1] = S/Right.
+// I vettori da 256 bit (v8sf) servono all'elaborazione di più strisce (gla3a_lanes.h): una corsia per
+// striscia. Con -mavx sono un registro AVX, altrimenti il compilatore li divide in due registri SSE/NEON.
+// Aritmetica e operazioni sui bit si dividono bene da sole, confronti e '?:' no (GCC li fa corsia per
+// corsia, con un salto ciascuna): sui v8sf passano sempre da v8sf_gt()/v8sf_le()/v8sf_select().
+
+#include <stdint.h>
+
+typedef float v4sf __attribute__((vector_size(16)));
+typedef int32_t v4si __attribute__((vector_size(16)));
+typedef float v8sf __attribute__((vector_size(32)));
+typedef int32_t v8si __attribute__((vector_size(32)));
+
+#define LANE_M 0
+#define LANE_S 1
+
+static inline v4sf v4sf_set1(float x) {
+    v4sf v = { x, x, x, x };
+    return v;
+}
+
+// Impacchetta i campioni M e S nelle prime due corsie (le altre restano a zero)
+static inline v4sf v4sf_pack_ms(float m, float s) {
+    v4sf v = { m, s, 0.0f, 0.0f };
+    return v;
+}
+
+// Vero se tutte le corsie di tutti i vettori valgono zero (stati di un filtro a riposo)
+static inline bool v4sf_all_zero(const v4sf* v, int count) {
+    v4si any = { 0, 0, 0, 0 };
+    for (int k = 0; k < count; ++k) any |= (v[k] != v4sf_set1(0.0f));
+    return !(any[0] | any[1] | any[2] | any[3]);
+}
+
+static inline v8sf v8sf_set1(float x) {
+    v8sf v = { x, x, x, x, x, x, x, x };
+    return v;
+}
+
+#ifndef __AVX__
+// Le due metà da 128 bit di un vettore da 256
+typedef union { v8sf v; v4sf half[2]; } V8sfHalves;
+typedef union { v8si v; v4si half[2]; } V8siHalves;
+#endif
+
+// Maschera (-1 = vero) delle corsie con a > b
+static inline v8si v8sf_gt(v8sf a, v8sf b) {
+#ifdef __AVX__
+    return a > b;
+#else
+    const V8sfHalves x = { a }, y = { b };
+    V8siHalves r;
+    r.half[0] = x.half[0] > y.half[0];
+    r.half[1] = x.half[1] > y.half[1];
+    return r.v;
+#endif
+}
+
+// Maschera (-1 = vero) delle corsie con a <= b
+static inline v8si v8sf_le(v8sf a, v8sf b) {
+#ifdef __AVX__
+    return a <= b;
+#else
+    const V8sfHalves x = { a }, y = { b };
+    V8siHalves r;
+    r.half[0] = x.half[0] <= y.half[0];
+    r.half[1] = x.half[1] <= y.half[1];
+    return r.v;
+#endif
+}
+
+// Maschera (-1 = vero) delle corsie con a == b
+static inline v8si v8sf_eq(v8sf a, v8sf b) {
+#ifdef __AVX__
+    return a == b;
+#else
+    const V8sfHalves x = { a }, y = { b };
+    V8siHalves r;
+    r.half[0] = x.half[0] == y.half[0];
+    r.half[1] = x.half[1] == y.half[1];
+    return r.v;
+#endif
+}
+
+// a dove mask è vero, b altrove (mask ? a : b, corsia per corsia)
+static inline v8sf v8sf_select(v8si mask, v8sf a, v8sf b) {
+    return (v8sf)(((v8si)a & mask) | ((v8si)b & ~mask));
+}
+
+#endif // GLA3A_SIMD_H
@@ -0,0 +1,255 @@
+#ifndef GLA3A_STAGES_H
+#define GLA3A_STAGES_H
+
+// --- Pipeline a Stadi del Blocco ---
+// run() elabora ogni blocco come una sequenza di stadi, ognuno su buffer contigui:
+//   encode -> oversample -> saturate -> decimate -> rectify -> sidechain filter ->
+//   envelope -> gain computer -> gain smooth -> apply -> decode -> clip
+// Con i detector collegati (L/R) rectify produce un solo livello per i due canali e gli stadi fino
+// a gain smooth girano una volta sola; in modalità mista gli envelope si mescolano prima del gain computer.
+// Con più bande, da rectify ad apply si passa invece per crossover -> band dynamics (gla3a_multiband.h).
+// Oversample/decimate sono in gla3a_oversampler.h e il filtro sidechain in gla3a_biquad_bank.h;
+// qui ci sono gli altri stadi e le primitive per campione che usano.
+// Gli stadi senza stato (encode, saturate, rectify, apply, decode, clip) non hanno dipendenze
+// tra campioni e il compilatore li può vettorizzare; quelli con stato ricevono lo stato
+// esplicitamente, quindi ognuno si può provare e misurare da solo.
+// Le operazioni sono le stesse (e nello stesso ordine) del vecchio loop per campione.
+// Dal rettificato al guadagno il segnale è DetectorReal e gli stati FilterReal (gla3a_precision.h);
+// il gain computer lavora in dB e resta float.
+
+#include "gla3a_fastmath.h"
+#include "gla3a_gain_computer.h"
+#include "gla3a_precision.h"
+#include <math.h>
+#include <stdint.h>
+
+#define STAGES_SILENCE_DB -90.0f // Livello restituito da to_db() per ingressi nulli
+
+
+// --- Primitive per Campione ---
+
+// Con GLA3A_FAST_MATH (default) le conversioni usano le approssimazioni di gla3a_fastmath.h
+static inline float to_db(float linear_val) {
+    if (linear_val <= 0.00000000001f) return STAGES_SILENCE_DB;
+#if GLA3A_FAST_MATH
+    return fast_to_db(linear_val);
+#else
+    return 20.0f * log10f(linear_val);
+#endif
+}
+
+static inline float db_to_linear(float db_val) {
+#if GLA3A_FAST_MATH
+    return fast_db_to_linear(db_val);
+#else
+    return powf(10.0f, db_val / 20.0f);
+#endif
+}
+
+// Forme vettoriali (una corsia per banda in modalità multibanda), stesse regole delle scalari
+static inline v4sf to_db_v4(v4sf linear_val) {
+#if GLA3A_FAST_MATH
+    v4sf db = fast_to_db_v4(linear_val);
+#else
+    v4sf db;
+    for (int k = 0; k < 4; ++k) db[k] = 20.0f * log10f(linear_val[k]);
+#endif
+    return (linear_val <= 0.00000000001f) ? v4sf_set1(STAGES_SILENCE_DB) : db;
+}
+
+static inline v4sf db_to_linear_v4(v4sf db_val) {
+#if GLA3A_FAST_MATH
+    return fast_db_to_linear_v4(db_val);
+#else
+    v4sf linear;
+    for (int k = 0; k < 4; ++k) linear[k] = powf(10.0f, db_val[k] / 20.0f);
+    return linear;
+#endif
+}
+
+// Forme a 8 corsie (una per striscia in gla3a_lanes.h), stesse regole delle scalari
+static inline v8sf to_db_v8(v8sf linear_val) {
+#if GLA3A_FAST_MATH
+    v8sf db = fast_to_db_v8(linear_val);
+#else
+    v8sf db;
+    for (int k = 0; k < 8; ++k) db[k] = 20.0f * log10f(linear_val[k]);
+#endif
+    return v8sf_select(v8sf_le(linear_val, v8sf_set1(0.00000000001f)), v8sf_set1(STAGES_SILENCE_DB), db);
+}
+
+static inline v8sf db_to_linear_v8(v8sf db_val) {
+#if GLA3A_FAST_MATH
+    return fast_db_to_linear_v8(db_val);
+#else
+    v8sf linear;
+    for (int k = 0; k < 8; ++k) linear[k] = powf(10.0f, db_val[k] / 20.0f);
+    return linear;
+#endif
+}
+
+// Funzione per applicare il soft-clipping finale
+static inline float apply_final_soft_clip(float sample, float threshold_linear, float amount) {
+    float sign = (sample >= 0) ? 1.0f : -1.0f;
+    float abs_sample = fabsf(sample);
+
+    if (abs_sample <= threshold_linear) {
+        return sample;
+    } else {
+        float normalized_over_threshold = (abs_sample - threshold_linear) / (1.0f - threshold_linear);
+#if GLA3A_FAST_MATH
+        float decay = fast_expf(-amount * normalized_over_threshold);
+#else
+        float decay = expf(-amount * normalized_over_threshold);
+#endif
+        float clipped_val = threshold_linear + (1.0f - threshold_linear) * (1.0f - decay);
+        return sign * fminf(clipped_val, 1.0f);
+    }
+}
+
+// Funzione per la distorsione J-FET (approssimazione sigmoide)
+static inline float apply_jfet_distortion(float sample, float k_factor, float threshold_jfet, float dry_wet_mix) {
+    float distorted_sample;
+    float abs_sample = fabsf(sample);
+
+    if (abs_sample <= threshold_jfet) {
+        distorted_sample = sample; // Nessuna distorsione significativa sotto la soglia
+    } else {
+        // Normalizza il sample oltre la soglia
+        float x_norm = (abs_sample - threshold_jfet) / (1.0f - threshold_jfet);
+        // Applica la funzione di shaping basata su arctan o tanh (più comune per J-FET)
+        // Usiamo una curva sigmoide più generale che include k_factor per variabilità
+        float shaped_x = x_norm / (1.0f + k_factor * x_norm);
+        distorted_sample = threshold_jfet + (1.0f - threshold_jfet) * shaped_x;
+
+        // Ri-applica il segno originale
+        distorted_sample = (sample >= 0) ? distorted_sample : -distorted_sample;
+    }
+
+    // Mix dry/wet
+    return sample * (1.0f - dry_wet_mix) + distorted_sample * dry_wet_mix;
+}
+
+// Livello collegato di due canali: il massimo, o la somma normalizzata (media dei livelli,
+// così un segnale identico sui due canali dà lo stesso livello dei detector scollegati)
+static inline DetectorReal link_level(DetectorReal a, DetectorReal b, bool sum) {
+    return sum ? (a + b) * 0.5f : real_max(a, b);
+}
+
+// Un passo del detector: attacco se l'ingresso sale, rilascio altrimenti
+static inline FilterReal envelope_tick(FilterReal env, FilterReal in, FilterReal attack_alpha, FilterReal release_alpha) {
+    if (in > env) { // Attacco
+        return (env * (1.0f - attack_alpha)) + (in * attack_alpha);
+    } else { // Rilascio
+        return (env * (1.0f - release_alpha)) + (in * release_alpha);
+    }
+}
+
+
+// --- Stadi del Blocco ---
+
+// L/R -> M/S (o copia L/R se ms_active è falso)
+static inline void stage_encode(const float* in_l, const float* in_r, float* out_M, float* out_S, uint32_t n, bool ms_active) {
+    if (ms_active) {
+        for (uint32_t i = 0; i < n; ++i) {
+            out_M[i] = (in_l[i] + in_r[i]) * 0.5f;
+            out_S[i] = (in_l[i] - in_r[i]) * 0.5f;
+        }
+    } else {
+        for (uint32_t i = 0; i < n; ++i) {
+            out_M[i] = in_l[i];
+            out_S[i] = in_r[i];
+        }
+    }
+}
+
+// Saturazione J-FET sul posto (alla frequenza sovracampionata)
+static inline void stage_saturate(float* buf, uint32_t n, float k_factor, float threshold_jfet, float dry_wet_mix) {
+    for (uint32_t i = 0; i < n; ++i) {
+        buf[i] = apply_jfet_distortion(buf[i], k_factor, threshold_jfet, dry_wet_mix);
+    }
+}
+
+// Ingresso del detector: ampiezza del segnale decimato
+static inline void stage_rectify(const float* in, DetectorReal* out, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        out[i] = fabsf(in[i]);
+    }
+}
+
+// Ingresso del detector collegato: un solo livello dai due canali
+static inline void stage_rectify_linked(const float* in_M, const float* in_S, DetectorReal* out, uint32_t n, bool sum) {
+    for (uint32_t i = 0; i < n; ++i) {
+        out[i] = link_level(fabsf(in_M[i]), fabsf(in_S[i]), sum);
+    }
+}
+
+// Detector di envelope, sul posto: il buffer rettificato diventa l'envelope campione per campione.
+// *env contiene lo stato tra un blocco e l'altro.
+static inline void stage_envelope(DetectorReal* buf, uint32_t n, FilterReal* env, FilterReal attack_alpha, FilterReal release_alpha) {
+    FilterReal e = *env;
+    for (uint32_t i = 0; i < n; ++i) {
+        e = envelope_tick(e, buf[i], attack_alpha, release_alpha);
+        buf[i] = e;
+    }
+    *env = e;
+}
+
+// Collegamento misto, sul posto: ogni envelope si sposta verso il livello collegato di 'amount'
+// (0 = scollegati, 1 = stesso livello sui due canali)
+static inline void stage_link_blend(DetectorReal* env_M, DetectorReal* env_S, uint32_t n, float amount, bool sum) {
+    for (uint32_t i = 0; i < n; ++i) {
+        const DetectorReal linked = link_level(env_M[i], env_S[i], sum);
+        env_M[i] += (linked - env_M[i]) * amount;
+        env_S[i] += (linked - env_S[i]) * amount;
+    }
+}
+
+// Gain computer, sul posto: envelope lineare -> guadagno lineare target (riduzione + make-up)
+static inline void stage_gain_computer(DetectorReal* buf, uint32_t n, const GainComputer* gc, float threshold_db, float make_up_gain_linear) {
+    for (uint32_t i = 0; i < n; ++i) {
+        float target_gr_db = gain_computer_lookup(gc, to_db((float)buf[i]), threshold_db);
+        buf[i] = db_to_linear(-target_gr_db) * make_up_gain_linear;
+    }
+}
+
+// Smoothing del guadagno, sul posto. *gain contiene lo stato tra un blocco e l'altro.
+static inline void stage_gain_smooth(DetectorReal* buf, uint32_t n, FilterReal* gain, FilterReal alpha) {
+    FilterReal g = *gain;
+    for (uint32_t i = 0; i < n; ++i) {
+        g = (g * (1.0f - alpha)) + (buf[i] * alpha);
+        buf[i] = g;
+    }
+    *gain = g;
+}
+
+// Applica il guadagno al segnale, sul posto
+static inline void stage_apply(float* audio, const DetectorReal* gain, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        audio[i] *= gain[i];
+    }
+}
+
+// M/S -> L/R (o copia L/R se ms_active è falso)
+static inline void stage_decode(const float* in_M, const float* in_S, float* out_l, float* out_r, uint32_t n, bool ms_active) {
+    if (ms_active) {
+        for (uint32_t i = 0; i < n; ++i) {
+            out_l[i] = in_M[i] + in_S[i];
+            out_r[i] = in_M[i] - in_S[i];
+        }
+    } else {
+        for (uint32_t i = 0; i < n; ++i) {
+            out_l[i] = in_M[i];
+            out_r[i] = in_S[i];
+        }
+    }
+}
+
+// Soft-clip finale sul posto
+static inline void stage_clip(float* buf, uint32_t n, float threshold_linear, float amount) {
+    for (uint32_t i = 0; i < n; ++i) {
+        buf[i] = apply_final_soft_clip(buf[i], threshold_linear, amount);
+    }
+}
+
+#endif // GLA3A_STAGES_H
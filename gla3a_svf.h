@@ -0,0 +1,249 @@
+#ifndef GLA3A_SVF_H
+#define GLA3A_SVF_H
+
+// --- Filtri State-Variable TPT per la Sidechain ---
+// Cascata di SVF a trasformata che preserva la topologia (TPT, trapezoidale) con gli stessi
+// coefficienti su M e S, nello stesso registro come il banco di biquad (gla3a_biquad_bank.h).
+// Con g = tan(pi * fc / fs) e k = 1 / Q la risposta è quella del biquad RBJ con lo stesso taglio e
+// la stessa Q (bilineare con prewarp), ma i coefficienti sono tre prodotti di g e k: cambiarli a ogni
+// campione costa una tan() approssimata e una divisione, e gli stati (le correnti dei due
+// integratori) restano validi con qualunque g > 0, k > 0, quindi il filtro resta stabile anche
+// mentre taglio e Q si muovono.
+// Un cambio di frequenza o di Q non salta: svf_bank_set_target() fissa il target e il blocco ci
+// arriva con uno smoothing a un polo (SVF_GLIDE_SECONDS) campione per campione, niente zipper né
+// click sugli sweep automatizzati, e niente progetto nel worker. Arrivato al target (entro
+// SVF_SETTLE_TOLERANCE) il filtro si ferma sul valore esatto e il resto del blocco gira con i
+// coefficienti fissi.
+//
+// GLA3A_SIDECHAIN sceglie a compilazione i filtri della sidechain:
+//   GLA3A_SIDECHAIN_SVF     (default) questo banco
+//   GLA3A_SIDECHAIN_BIQUAD  i biquad RBJ progettati nel worker, con i coefficienti che saltano
+//                           (anche il default con GLA3A_SCALAR_BIQUADS, che ne è il riferimento)
+// "make bench-sidechain" misura le due scelte.
+
+#include "gla3a_denormal.h"
+#include "gla3a_kernels.h"
+#include "gla3a_precision.h"
+#include "gla3a_simd.h"
+#include <stdint.h>
+
+#define GLA3A_SIDECHAIN_SVF    0
+#define GLA3A_SIDECHAIN_BIQUAD 1
+
+#ifndef GLA3A_SIDECHAIN
+#ifdef GLA3A_SCALAR_BIQUADS
+#define GLA3A_SIDECHAIN GLA3A_SIDECHAIN_BIQUAD
+#else
+#define GLA3A_SIDECHAIN GLA3A_SIDECHAIN_SVF
+#endif
+#endif
+
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+#define GLA3A_SIDECHAIN_NAME "svf"
+#ifdef GLA3A_SCALAR_BIQUADS
+#error "GLA3A_SCALAR_BIQUADS vale solo con GLA3A_SIDECHAIN_BIQUAD"
+#endif
+#elif GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_BIQUAD
+#define GLA3A_SIDECHAIN_NAME "biquad"
+#else
+#error "GLA3A_SIDECHAIN: valori ammessi GLA3A_SIDECHAIN_SVF, GLA3A_SIDECHAIN_BIQUAD"
+#endif
+
+#define SVF_MAX_STAGES 3
+#define SVF_LOWPASS  0
+#define SVF_HIGHPASS 1
+
+#define SVF_GLIDE_SECONDS 0.01     // Costante di tempo dello smoothing di taglio e Q
+#define SVF_SETTLE_TOLERANCE 1e-4  // Scarto relativo dal target sotto cui il glide si ferma
+#define SVF_MAX_CUTOFF 0.49        // Taglio massimo in frazioni di fs (tan() resta lontana dal polo)
+
+typedef struct {
+    int   num_stages;
+    bool  primed;               // Falso dopo init/reset: il prossimo target vale subito
+    bool  gliding;              // Taglio o Q ancora in movimento verso il target
+    FilterReal w, k;            // Correnti: pi * fc / fs e 1 / Q
+    FilterReal w_target, k_target;
+    FilterReal glide_alpha;     // Coefficiente per campione dello smoothing
+    vreal a1, a2, a3, hp_k;     // Coefficienti da w e k (e k per l'uscita HighPass), comuni a stadi e
+                                // canali: già vettori, così il loop li legge e non li ricostruisce
+    vreal ic1[SVF_MAX_STAGES];  // Stati dei due integratori, M e S nelle corsie
+    vreal ic2[SVF_MAX_STAGES];
+} SvfBank;
+
+// tan(x) con l'approssimante di Padé [7/6]: errore relativo sotto 1e-7 fino a x = 1.54
+// (pi * SVF_MAX_CUTOFF), una divisione invece di sin/cos della libm
+static inline FilterReal svf_tan(FilterReal x) {
+    const FilterReal x2 = x * x;
+    const FilterReal num = x * (135135 - x2 * (17325 - x2 * (378 - x2)));
+    const FilterReal den = 135135 - x2 * (62370 - x2 * (3150 - x2 * 28));
+    return num / den;
+}
+
+static inline void svf_bank_update_coeffs(SvfBank* bank) {
+    const FilterReal g = svf_tan(bank->w);
+    const FilterReal a1 = 1 / (1 + g * (g + bank->k));
+    const FilterReal a2 = g * a1;
+    bank->a1 = vreal_set1(a1);
+    bank->a2 = vreal_set1(a2);
+    bank->a3 = vreal_set1(g * a2);
+    bank->hp_k = vreal_set1(bank->k);
+}
+
+static inline void svf_bank_reset(SvfBank* bank) {
+    for (int k = 0; k < SVF_MAX_STAGES; ++k) {
+        bank->ic1[k] = vreal_set1(0);
+        bank->ic2[k] = vreal_set1(0);
+    }
+    bank->primed = false;
+}
+
+static inline void svf_bank_init(SvfBank* bank, int num_stages, double samplerate) {
+    bank->num_stages = num_stages;
+    bank->gliding = false;
+    bank->w = bank->w_target = 0;
+    bank->k = bank->k_target = 1;
+    bank->glide_alpha = (FilterReal)(1.0 - exp(-1.0 / (SVF_GLIDE_SECONDS * samplerate)));
+    svf_bank_update_coeffs(bank);
+    svf_bank_reset(bank);
+}
+
+// Porta taglio e Q al target senza glide (filtro spento, o primo target dopo init/reset)
+static inline void svf_bank_snap(SvfBank* bank) {
+    bank->w = bank->w_target;
+    bank->k = bank->k_target;
+    bank->gliding = false;
+    bank->primed = true;
+    svf_bank_update_coeffs(bank);
+}
+
+// Nuovo taglio e Q: il blocco ci arriva con il glide (subito se il banco non è ancora partito)
+static inline void svf_bank_set_target(SvfBank* bank, float freq_hz, float q_val, double samplerate) {
+    if (freq_hz <= 0.0f) freq_hz = 1.0f; // Stesse protezioni di calculate_biquad_coeffs()
+    if (q_val <= 0.0f) q_val = 0.1f;
+    double w = M_PI * freq_hz / samplerate;
+    if (w > M_PI * SVF_MAX_CUTOFF) w = M_PI * SVF_MAX_CUTOFF;
+
+    bank->w_target = (FilterReal)w;
+    bank->k_target = 1 / (FilterReal)q_val;
+    if (!bank->primed) svf_bank_snap(bank);
+    else bank->gliding = (bank->w != bank->w_target || bank->k != bank->k_target);
+}
+
+// Un passo dello smoothing (prima di filtrare il campione); al target si ferma sul valore esatto.
+// Si ferma anche dove il passo si perde nell'arrotondamento: in float, con alpha piccolo (fs alte)
+// succede prima della tolleranza, e il glide non finirebbe mai.
+static inline void svf_bank_glide(SvfBank* bank) {
+    const FilterReal w = bank->w + (bank->w_target - bank->w) * bank->glide_alpha;
+    const FilterReal k = bank->k + (bank->k_target - bank->k) * bank->glide_alpha;
+    const bool stalled = (w == bank->w && k == bank->k);
+    bank->w = w;
+    bank->k = k;
+    if (stalled || (real_abs(bank->w_target - w) <= bank->w_target * (FilterReal)SVF_SETTLE_TOLERANCE &&
+                    real_abs(bank->k_target - k) <= bank->k_target * (FilterReal)SVF_SETTLE_TOLERANCE)) {
+        bank->w = bank->w_target;
+        bank->k = bank->k_target;
+        bank->gliding = false;
+    }
+    svf_bank_update_coeffs(bank);
+}
+
+// Azzera gli stati decaduti sotto DENORMAL_FLUSH_THRESHOLD (a fine blocco)
+static inline void svf_bank_flush_denormals(SvfBank* bank) {
+    flush_denormals_vreal(bank->ic1, bank->num_stages);
+    flush_denormals_vreal(bank->ic2, bank->num_stages);
+}
+
+// Vero se la cascata è a riposo: con ingresso nullo l'uscita resta nulla e lo stato non cambia.
+// Un glide in corso conta come movimento: saltare il blocco lo fermerebbe.
+static inline bool svf_bank_is_silent(const SvfBank* bank) {
+    return !bank->gliding && vreal_all_zero(bank->ic1, bank->num_stages) && vreal_all_zero(bank->ic2, bank->num_stages);
+}
+
+// Un campione attraverso la cascata; STAGES noto a compilazione o KERNEL_RUNTIME (da num_stages)
+template <int TYPE, int STAGES>
+static inline vreal svf_bank_tick(SvfBank* bank, vreal in) {
+    const vreal a1 = bank->a1;
+    const vreal a2 = bank->a2;
+    const vreal a3 = bank->a3;
+    const vreal k = bank->hp_k;
+    const int stages = KERNEL_PARAM(STAGES, bank->num_stages);
+#pragma GCC unroll 4
+    for (int s = 0; s < stages; ++s) {
+        const vreal v3 = in - bank->ic2[s];
+        const vreal v1 = a1 * bank->ic1[s] + a2 * v3;
+        const vreal v2 = bank->ic2[s] + a2 * bank->ic1[s] + a3 * v3;
+        bank->ic1[s] = v1 + v1 - bank->ic1[s];
+        bank->ic2[s] = v2 + v2 - bank->ic2[s];
+        in = (TYPE == SVF_LOWPASS) ? v2 : in - k * v1 - v2;
+    }
+    return in;
+}
+
+// Filtra sul posto un blocco M/S del detector (buf_S == NULL: un canale solo, la corsia S riceve
+// silenzio), con gli stadi letti dal banco: il percorso del kernel generico
+template <int TYPE>
+static void svf_bank_process(SvfBank* bank, DetectorReal* buf_M, DetectorReal* buf_S, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        if (bank->gliding) svf_bank_glide(bank);
+        vreal y = svf_bank_tick<TYPE, KERNEL_RUNTIME>(bank, vreal_pack_ms(buf_M[i], buf_S ? buf_S[i] : 0));
+        buf_M[i] = y[LANE_M];
+        if (buf_S) buf_S[i] = y[LANE_S];
+    }
+}
+
+
+// --- Kernel Specializzati (gla3a_kernels.h) ---
+
+// Il segnale tra le due cascate arrotondato a DetectorReal, come passando dal buffer del detector
+// (solo in precisione mista). Con una conversione vettoriale: quella scalare, campione per campione,
+// il vettorizzatore SLP di GCC la toglie.
+static inline vreal svf_round_detector(vreal y) {
+#if GLA3A_PRECISION == GLA3A_PRECISION_MIXED
+    typedef DetectorReal vdetector __attribute__((vector_size(sizeof(vreal) / 2)));
+    return __builtin_convertvector(__builtin_convertvector(y, vdetector), vreal);
+#else
+    return y;
+#endif
+}
+
+// Un campione di LowPass e HighPass uno dopo l'altro
+template <int STAGES_LP, int STAGES_HP, bool STEREO>
+static inline void svf_chain_tick(SvfBank* lp, SvfBank* hp, DetectorReal* buf_M, DetectorReal* buf_S, uint32_t i) {
+    vreal y = vreal_pack_ms(buf_M[i], STEREO ? buf_S[i] : 0);
+    y = svf_bank_tick<SVF_LOWPASS, STAGES_LP>(lp, y);
+    if (STAGES_LP && STAGES_HP) y = svf_round_detector(y);
+    y = svf_bank_tick<SVF_HIGHPASS, STAGES_HP>(hp, y);
+    buf_M[i] = y[LANE_M];
+    if (STEREO) buf_S[i] = y[LANE_S];
+}
+
+// Il blocco su banchi locali, come biquad_bank_process_chain(): finché una cascata accesa è in glide
+// i coefficienti si aggiornano a ogni campione, poi il resto gira con quelli fissi
+template <int STAGES_LP, int STAGES_HP, bool STEREO>
+static inline void svf_chain_run(SvfBank* lp, SvfBank* hp, DetectorReal* buf_M, DetectorReal* buf_S, uint32_t n) {
+    SvfBank la = *lp;
+    SvfBank lb = *hp;
+    uint32_t i = 0;
+    for (; i < n; ++i) {
+        const bool lp_glides = STAGES_LP && la.gliding;
+        const bool hp_glides = STAGES_HP && lb.gliding;
+        if (!lp_glides && !hp_glides) break;
+        if (lp_glides) svf_bank_glide(&la);
+        if (hp_glides) svf_bank_glide(&lb);
+        svf_chain_tick<STAGES_LP, STAGES_HP, STEREO>(&la, &lb, buf_M, buf_S, i);
+    }
+    for (; i < n; ++i) svf_chain_tick<STAGES_LP, STAGES_HP, STEREO>(&la, &lb, buf_M, buf_S, i);
+    *lp = la;
+    *hp = lb;
+}
+
+// LowPass e HighPass della sidechain in un solo passo sul blocco, con gli stadi di ognuna noti a
+// compilazione (0 = cascata spenta); buf_S == NULL per un canale solo. Per campione i conti sono
+// quelli di svf_bank_process().
+template <int STAGES_LP, int STAGES_HP>
+static void svf_bank_process_chain(SvfBank* lp, SvfBank* hp, DetectorReal* buf_M, DetectorReal* buf_S, uint32_t n) {
+    if (buf_S) svf_chain_run<STAGES_LP, STAGES_HP, true>(lp, hp, buf_M, buf_S, n);
+    else       svf_chain_run<STAGES_LP, STAGES_HP, false>(lp, hp, buf_M, NULL, n);
+}
+
+#endif // GLA3A_SVF_H
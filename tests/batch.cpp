@@ -0,0 +1,178 @@
+// Verifica dell'API a blocchi (gla3a_batch.h)
+// Ogni striscia deve dare la stessa uscita, bit per bit, di un'istanza del plugin con gli stessi
+// parametri e la stessa lunghezza massima dei blocchi:
+//  - strisce con configurazioni diverse nello stesso gruppo di corsie (ratio, M/S, collegamento,
+//    filtri della sidechain, oversampling) e un gruppo incompleto
+//  - strisce che entrano ed escono dalle corsie (Limit, multibanda, bypass) a metà elaborazione
+//  - taglio dei filtri della sidechain in glide nelle corsie, anche quando la striscia ne esce
+//  - chiamate più lunghe del blocco massimo e reset
+//  - set_param rifiuta le porte che non sono parametri e le strisce che non esistono
+
+#include "../gla3a_batch.h"
+#include "../tools/gla3a_host.h"
+#include "../tools/gla3a_signals.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define BLOCK 256
+#define NUM_STRIPS 11 // Un gruppo pieno e uno incompleto
+#define FRAMES 24000
+#define MAX_OVERRIDES 6
+
+typedef struct {
+    GLA3A_PortIndex port;
+    float value;
+} Setting;
+
+typedef struct {
+    SignalType signal;
+    Setting settings[MAX_OVERRIDES]; // Sopra i default di gla3a.ttl; port 0 con value 0 chiude la lista
+} StripConfig;
+
+static const StripConfig strips[NUM_STRIPS] = {
+    { SIGNAL_DRUMS, { { GLA3A_PEAK_REDUCTION, 0.6f }, { GLA3A_GAIN, 0.25f } } },
+    { SIGNAL_PINK,  { { GLA3A_RATIO_MODE, GLA3A_RATIO_6_TO_1 }, { GLA3A_OVERSAMPLING, GLA3A_OS_1X }, { GLA3A_SC_LP_ON, 1.0f } } },
+    { SIGNAL_SINE,  { { GLA3A_RATIO_MODE, GLA3A_RATIO_9_TO_1 }, { GLA3A_OVERSAMPLING, GLA3A_OS_2X }, { GLA3A_OS_MODE, 1.0f },
+                      { GLA3A_SC_HP_ON, 1.0f }, { GLA3A_MS_MODE_ACTIVE, 1.0f } } },
+    { SIGNAL_DRUMS, { { GLA3A_STEREO_LINK, GLA3A_LINK_LINKED }, { GLA3A_LINK_DETECTOR, 1.0f }, { GLA3A_SC_LP_ON, 1.0f },
+                      { GLA3A_SC_HP_ON, 1.0f }, { GLA3A_PEAK_REDUCTION, 0.4f } } },
+    { SIGNAL_PINK,  { { GLA3A_STEREO_LINK, GLA3A_LINK_BLEND }, { GLA3A_LINK_AMOUNT, 0.3f }, { GLA3A_OVERSAMPLING, GLA3A_OS_8X } } },
+    { SIGNAL_DRUMS, { { GLA3A_BANDS, 3.0f }, { GLA3A_PEAK_REDUCTION, 0.5f } } },
+    { SIGNAL_SINE,  { { GLA3A_RATIO_MODE, GLA3A_RATIO_LIMIT }, { GLA3A_PEAK_REDUCTION, 0.8f } } },
+    { SIGNAL_PINK,  { { GLA3A_GAIN, 0.5f }, { GLA3A_SC_HP_ON, 1.0f }, { GLA3A_SC_HP_FREQ, 300.0f } } },
+    { SIGNAL_DRUMS, { { GLA3A_STEREO_LINK, GLA3A_LINK_LINKED }, { GLA3A_OVERSAMPLING, GLA3A_OS_1X } } },
+    { SIGNAL_SINE,  { { GLA3A_STEREO_LINK, GLA3A_LINK_BLEND }, { GLA3A_LINK_DETECTOR, 1.0f }, { GLA3A_PEAK_REDUCTION, 0.9f } } },
+    { SIGNAL_PINK,  { { GLA3A_OVERSAMPLING, GLA3A_OS_1X }, { GLA3A_SC_LP_ON, 1.0f }, { GLA3A_SC_LP_FREQ, 800.0f } } },
+};
+
+// Cambi durante l'elaborazione: prima della chiamata che comincia al campione 'frame'
+typedef struct {
+    uint32_t frame;
+    uint32_t strip;
+    Setting setting;
+} Change;
+
+static const Change changes[] = {
+    { 5000,  2, { GLA3A_SC_HP_FREQ, 400.0f } },             // Glide della sidechain a metà quando esce
+    { 5120,  2, { GLA3A_RATIO_MODE, GLA3A_RATIO_LIMIT } },  // Esce dalle corsie...
+    { 5120,  5, { GLA3A_BANDS, 1.0f } },                    // ...entra nelle corsie
+    { 5120,  3, { GLA3A_STEREO_LINK, GLA3A_LINK_UNLINKED } },
+    { 5120,  7, { GLA3A_BYPASS, 1.0f } },
+    { 10240, 2, { GLA3A_RATIO_MODE, GLA3A_RATIO_3_TO_1 } }, // ...e ci torna con il suo stato
+    { 10240, 7, { GLA3A_BYPASS, 0.0f } },
+    { 10240, 1, { GLA3A_SC_LP_FREQ, 800.0f } },
+    { 10240, 8, { GLA3A_STEREO_LINK, GLA3A_LINK_BLEND } },
+    { 15360, 3, { GLA3A_SC_HP_FREQ, 250.0f } },
+};
+
+// Lunghezze delle chiamate, anche sopra il blocco massimo (l'istanza e il batch vanno a pezzi)
+static const uint32_t call_lengths[] = { BLOCK, BLOCK, 100, BLOCK * 3 + 17, BLOCK, 1, BLOCK - 1 };
+
+static float in_l[NUM_STRIPS][FRAMES], in_r[NUM_STRIPS][FRAMES];
+static float ref_l[NUM_STRIPS][FRAMES], ref_r[NUM_STRIPS][FRAMES];
+static float out_l[NUM_STRIPS][FRAMES], out_r[NUM_STRIPS][FRAMES];
+static MiniHost hosts[NUM_STRIPS];
+
+static bool check(const char* name, bool ok) {
+    printf("  %-36s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+static void open_strip(uint32_t s, Gla3aBatch* batch) {
+    MiniHost* h = &hosts[s];
+    host_open(h, SAMPLERATE, BLOCK);
+    for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+        h->controls[gla3a_parameters[i].port] = gla3a_parameters[i].default_value;
+    }
+    for (int i = 0; i < MAX_OVERRIDES && strips[s].settings[i].port; ++i) {
+        h->controls[strips[s].settings[i].port] = strips[s].settings[i].value;
+        gla3a_batch_set_param(batch, s, strips[s].settings[i].port, strips[s].settings[i].value);
+    }
+    host_activate(h);
+}
+
+// Elabora [start, end) con le istanze singole e con il batch, alternando le lunghezze delle chiamate
+static void render(Gla3aBatch* batch, uint32_t start, uint32_t end) {
+    const float* batch_in_l[NUM_STRIPS];
+    const float* batch_in_r[NUM_STRIPS];
+    float* batch_out_l[NUM_STRIPS];
+    float* batch_out_r[NUM_STRIPS];
+    size_t call = 0;
+    for (uint32_t offset = start; offset < end; ) {
+        for (size_t c = 0; c < sizeof(changes) / sizeof(changes[0]); ++c) {
+            if (changes[c].frame != offset) continue;
+            hosts[changes[c].strip].controls[changes[c].setting.port] = changes[c].setting.value;
+            gla3a_batch_set_param(batch, changes[c].strip, changes[c].setting.port, changes[c].setting.value);
+        }
+        uint32_t n = call_lengths[call++ % (sizeof(call_lengths) / sizeof(call_lengths[0]))];
+        if (n > end - offset) n = end - offset;
+        // I cambi cadono sempre all'inizio di una chiamata
+        for (size_t c = 0; c < sizeof(changes) / sizeof(changes[0]); ++c) {
+            if (changes[c].frame > offset && changes[c].frame < offset + n) n = changes[c].frame - offset;
+        }
+
+        for (uint32_t s = 0; s < NUM_STRIPS; ++s) {
+            host_connect_audio(&hosts[s], in_l[s] + offset, in_r[s] + offset, ref_l[s] + offset, ref_r[s] + offset);
+            host_run(&hosts[s], n);
+            batch_in_l[s] = in_l[s] + offset;
+            batch_in_r[s] = in_r[s] + offset;
+            batch_out_l[s] = out_l[s] + offset;
+            batch_out_r[s] = out_r[s] + offset;
+        }
+        gla3a_batch_process(batch, batch_in_l, batch_in_r, batch_out_l, batch_out_r, n);
+        offset += n;
+    }
+}
+
+static bool same_output(uint32_t s, uint32_t start, uint32_t end) {
+    const size_t bytes = (end - start) * sizeof(float);
+    return !memcmp(ref_l[s] + start, out_l[s] + start, bytes) && !memcmp(ref_r[s] + start, out_r[s] + start, bytes);
+}
+
+int main() {
+    bool ok = true;
+    printf("batch: %d strisce, %d campioni a %.0f Hz, blocchi da %d\n", NUM_STRIPS, FRAMES, SAMPLERATE, BLOCK);
+
+    Gla3aBatch* batch = gla3a_batch_new(SAMPLERATE, NUM_STRIPS, BLOCK);
+    ok &= check("creazione", batch != NULL);
+    if (!batch) return 1;
+    ok &= check("nessuna striscia: NULL", gla3a_batch_new(SAMPLERATE, 0, BLOCK) == NULL);
+    ok &= check("set_param: porte non parametri",
+                !gla3a_batch_set_param(batch, 0, GLA3A_AUDIO_IN_L, 1.0f) && !gla3a_batch_set_param(batch, 0, GLA3A_LATENCY, 1.0f) &&
+                !gla3a_batch_set_param(batch, 0, GLA3A_OUTPUT_RMS, 1.0f) && !gla3a_batch_set_param(batch, 0, GLA3A_CONTROL, 1.0f) &&
+                !gla3a_batch_set_param(batch, 0, (GLA3A_PortIndex)GLA3A_NUM_PORTS, 1.0f));
+    ok &= check("set_param: striscia inesistente", !gla3a_batch_set_param(batch, NUM_STRIPS, GLA3A_GAIN, 0.5f));
+
+    for (uint32_t s = 0; s < NUM_STRIPS; ++s) {
+        generate_signal(strips[s].signal, SAMPLERATE, in_l[s], in_r[s], FRAMES);
+        open_strip(s, batch);
+    }
+
+    // --- Configurazioni miste e strisce che cambiano percorso ---
+    const uint32_t reset_at = FRAMES - 4096;
+    render(batch, 0, reset_at);
+    for (uint32_t s = 0; s < NUM_STRIPS; ++s) {
+        char name[64];
+        snprintf(name, sizeof(name), "striscia %u", s);
+        ok &= check(name, same_output(s, 0, reset_at));
+    }
+
+    bool latency = true;
+    for (uint32_t s = 0; s < NUM_STRIPS; ++s) latency &= gla3a_batch_latency(batch, s) == (uint32_t)hosts[s].controls[GLA3A_LATENCY];
+    ok &= check("latenza", latency);
+
+    // --- Reset: come activate() su ogni istanza ---
+    gla3a_batch_reset(batch);
+    for (uint32_t s = 0; s < NUM_STRIPS; ++s) host_activate(&hosts[s]);
+    render(batch, reset_at, FRAMES);
+    bool after_reset = true;
+    for (uint32_t s = 0; s < NUM_STRIPS; ++s) after_reset &= same_output(s, reset_at, FRAMES);
+    ok &= check("dopo il reset", after_reset);
+
+    for (uint32_t s = 0; s < NUM_STRIPS; ++s) host_close(&hosts[s]);
+    gla3a_batch_free(batch);
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
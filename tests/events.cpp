@@ -0,0 +1,147 @@
+// Verifica dei parametri via patch:Set sulla porta GLA3A_CONTROL
+//  - un evento a metà blocco dà la stessa uscita (bit per bit) di un cambio della porta
+//    con il blocco spezzato in quel punto
+//  - più eventi nello stesso blocco e sullo stesso campione
+//  - il valore di un patch:Set resta finché l'host non muove la porta
+
+#include "../tools/gla3a_host.h"
+#include "../tools/gla3a_signals.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define FRAMES 4096
+#define BLOCK 512
+
+static float in_l[FRAMES], in_r[FRAMES];
+static float ref_l[FRAMES], ref_r[FRAMES];
+static float out_l[FRAMES], out_r[FRAMES];
+
+// Un cambio di parametro al campione 'frame' del blocco 'block'
+typedef struct {
+    uint32_t block;
+    uint32_t frame;
+    GLA3A_PortIndex port;
+    float value;
+} ParamChange;
+
+static MiniHost ref_host, ev_host;
+
+static bool check(const char* name, bool ok) {
+    printf("  %-36s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+static void open_host(MiniHost* h, float* l, float* r, float bands) {
+    host_open(h, SAMPLERATE, BLOCK);
+    h->controls[GLA3A_BANDS] = bands;
+    host_connect_audio(h, in_l, in_r, l, r);
+    host_activate(h);
+}
+
+// Riferimento: la porta cambia tra due run, con il blocco spezzato al campione dell'evento
+static void render_ports(const ParamChange* changes, size_t num_changes, float bands) {
+    MiniHost* h = &ref_host;
+    open_host(h, ref_l, ref_r, bands);
+    for (uint32_t b = 0; b < FRAMES / BLOCK; ++b) {
+        uint32_t offset = 0;
+        for (size_t c = 0; c < num_changes; ++c) {
+            if (changes[c].block != b) continue;
+            if (changes[c].frame > offset) {
+                host_connect_audio(h, in_l + b * BLOCK + offset, in_r + b * BLOCK + offset,
+                                   ref_l + b * BLOCK + offset, ref_r + b * BLOCK + offset);
+                host_run(h, changes[c].frame - offset);
+                offset = changes[c].frame;
+            }
+            h->controls[changes[c].port] = changes[c].value;
+        }
+        host_connect_audio(h, in_l + b * BLOCK + offset, in_r + b * BLOCK + offset,
+                           ref_l + b * BLOCK + offset, ref_r + b * BLOCK + offset);
+        host_run(h, BLOCK - offset);
+    }
+    host_close(h);
+}
+
+// Stessi cambi come patch:Set, blocchi interi
+static void render_events(const ParamChange* changes, size_t num_changes, float bands) {
+    MiniHost* h = &ev_host;
+    open_host(h, out_l, out_r, bands);
+    for (uint32_t b = 0; b < FRAMES / BLOCK; ++b) {
+        for (size_t c = 0; c < num_changes; ++c) {
+            if (changes[c].block == b) host_set_param(h, changes[c].frame, changes[c].port, changes[c].value);
+        }
+        host_connect_audio(h, in_l + b * BLOCK, in_r + b * BLOCK, out_l + b * BLOCK, out_r + b * BLOCK);
+        host_run(h, BLOCK);
+    }
+    host_close(h);
+}
+
+static bool same_output() {
+    return !memcmp(ref_l, out_l, sizeof(ref_l)) && !memcmp(ref_r, out_r, sizeof(ref_r));
+}
+
+static bool run_case(const char* name, const ParamChange* changes, size_t num_changes, float bands) {
+    render_ports(changes, num_changes, bands);
+    render_events(changes, num_changes, bands);
+    return check(name, same_output());
+}
+
+int main() {
+    bool ok = true;
+    printf("events: %d campioni a %.0f Hz, blocchi da %d\n", FRAMES, SAMPLERATE, BLOCK);
+    generate_signal(SIGNAL_DRUMS, SAMPLERATE, in_l, in_r, FRAMES);
+
+    // --- Un evento a metà blocco ---
+    static const ParamChange single[] = {
+        { 1, 100, GLA3A_PEAK_REDUCTION, 0.9f },
+    };
+    ok &= run_case("patch:Set a metà blocco", single, 1, 1.0f);
+
+    // --- Più eventi per blocco, alcuni sullo stesso campione ---
+    static const ParamChange several[] = {
+        { 0, 17,  GLA3A_PEAK_REDUCTION, 0.8f },
+        { 0, 300, GLA3A_GAIN,           0.5f },
+        { 0, 300, GLA3A_RATIO_MODE,     GLA3A_RATIO_9_TO_1 },
+        { 2, 0,   GLA3A_SC_HP_ON,       1.0f },
+        { 2, 511, GLA3A_PEAK_REDUCTION, 0.4f },
+        { 5, 200, GLA3A_BYPASS,         1.0f },
+        { 5, 400, GLA3A_BYPASS,         0.0f },
+    };
+    ok &= run_case("più eventi per blocco", several, sizeof(several) / sizeof(several[0]), 1.0f);
+
+    // --- Multibanda: crossover e offset a campione preciso ---
+    static const ParamChange multiband[] = {
+        { 1, 64,  GLA3A_CROSSOVER_1,    400.0f },
+        { 1, 64,  GLA3A_BAND_1_OFFSET,  -6.0f },
+        { 3, 250, GLA3A_BANDS,          2.0f },
+    };
+    ok &= run_case("multibanda", multiband, sizeof(multiband) / sizeof(multiband[0]), 3.0f);
+
+    // --- Il patch:Set resta finché la porta non si muove ---
+    MiniHost* h = &ev_host;
+    open_host(h, out_l, out_r, 1.0f);
+    host_connect_audio(h, in_l, in_r, out_l, out_r);
+    host_set_param(h, 0, GLA3A_PEAK_REDUCTION, 0.9f);
+    host_run(h, BLOCK);
+    host_run(h, BLOCK); // La porta resta al default 0.6: il parametro resta 0.9
+    // Riferimento: la stessa soglia impostata dalla porta
+    MiniHost* r = &ref_host;
+    open_host(r, ref_l, ref_r, 1.0f);
+    host_connect_audio(r, in_l, in_r, ref_l, ref_r);
+    r->controls[GLA3A_PEAK_REDUCTION] = 0.9f;
+    host_run(r, BLOCK);
+    host_run(r, BLOCK);
+    ok &= check("patch:Set persistente", !memcmp(ref_l, out_l, BLOCK * sizeof(float)));
+
+    // La porta si muove: vince il nuovo valore della porta
+    h->controls[GLA3A_PEAK_REDUCTION] = 0.3f;
+    r->controls[GLA3A_PEAK_REDUCTION] = 0.3f;
+    host_run(h, BLOCK);
+    host_run(r, BLOCK);
+    ok &= check("la porta scavalca il patch:Set", !memcmp(ref_l, out_l, BLOCK * sizeof(float)));
+    host_close(h);
+    host_close(r);
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
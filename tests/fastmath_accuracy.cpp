@@ -0,0 +1,72 @@
+// Verifica di accuratezza per gla3a_fastmath.h
+// Percorre tutto il range del detector (-90..+12 dB) e controlla che l'errore peggiore
+// di to_db/db_to_linear resti sotto FASTMATH_MAX_DB_ERROR, e che le forme vettoriali
+// (4 e 8 corsie) diano gli stessi bit di quella scalare.
+
+#include "../gla3a_fastmath.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DETECTOR_MIN_DB -90.0
+#define DETECTOR_MAX_DB 12.0
+#define SWEEP_STEP_DB 0.0001
+
+static bool same_bits(float a, float b) {
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+int main() {
+    double max_to_db_err = 0.0, max_to_db_at = 0.0;
+    double max_to_lin_err = 0.0, max_to_lin_at = 0.0;
+    double max_exp_rel_err = 0.0;
+    long simd_mismatches = 0;
+    long points = 0;
+
+    for (double db = DETECTOR_MIN_DB; db <= DETECTOR_MAX_DB; db += SWEEP_STEP_DB, ++points) {
+        // to_db: il riferimento è calcolato in double sul float effettivamente visto dal detector
+        float lin = (float)pow(10.0, db / 20.0);
+        double ref_db = 20.0 * log10((double)lin);
+        float fast_db = fast_to_db(lin);
+        double err = fabs(fast_db - ref_db);
+        if (err > max_to_db_err) { max_to_db_err = err; max_to_db_at = db; }
+
+        // db_to_linear: errore espresso in dB sul valore lineare prodotto
+        float db_f = (float)db;
+        float fast_lin = fast_db_to_linear(db_f);
+        err = fabs(20.0 * log10((double)fast_lin) - (double)db_f);
+        if (err > max_to_lin_err) { max_to_lin_err = err; max_to_lin_at = db; }
+
+        // Forma vettoriale: deve coincidere bit a bit con la scalare
+        v4sf v_db = fast_to_db_v4(v4sf_set1(lin));
+        v4sf v_lin = fast_db_to_linear_v4(v4sf_set1(db_f));
+        if (!same_bits(v_db[0], fast_db) || !same_bits(v_lin[0], fast_lin)) ++simd_mismatches;
+        v8sf w_db = fast_to_db_v8(v8sf_set1(lin));
+        v8sf w_lin = fast_db_to_linear_v8(v8sf_set1(db_f));
+        if (!same_bits(w_db[7], fast_db) || !same_bits(w_lin[7], fast_lin)) ++simd_mismatches;
+    }
+
+    // expf del soft-clip finale: argomento in [-20, 0]
+    for (double x = -20.0; x <= 0.0; x += 0.0001) {
+        float xf = (float)x;
+        float fast = fast_expf(xf);
+        double ref = exp((double)xf);
+        double rel = fabs(fast - ref) / ref;
+        if (rel > max_exp_rel_err) max_exp_rel_err = rel;
+        v4sf v = fast_exp_v4(v4sf_set1(xf));
+        if (!same_bits(v[0], fast)) ++simd_mismatches;
+    }
+
+    printf("fastmath: %ld punti tra %.0f e %+.0f dB\n", points, DETECTOR_MIN_DB, DETECTOR_MAX_DB);
+    printf("  to_db        errore max %.3e dB (a %.4f dB)\n", max_to_db_err, max_to_db_at);
+    printf("  db_to_linear errore max %.3e dB (a %.4f dB)\n", max_to_lin_err, max_to_lin_at);
+    printf("  expf         errore relativo max %.3e\n", max_exp_rel_err);
+    printf("  limite dichiarato %.1e dB, differenze SIMD/scalare: %ld\n", (double)FASTMATH_MAX_DB_ERROR, simd_mismatches);
+
+    bool ok = max_to_db_err < FASTMATH_MAX_DB_ERROR &&
+              max_to_lin_err < FASTMATH_MAX_DB_ERROR &&
+              max_exp_rel_err < 1e-5 &&
+              simd_mismatches == 0;
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+// Regressione sull'uscita del plugin rispetto a file "golden" e budget di CPU
+// Ogni configurazione (segnale + porte + blocco) viene elaborata da run() e confrontata con
+// tests/golden/<nome>.f32 (float32 little-endian, stereo interlacciato):
+//  - profondità del null: 20*log10(rms(golden) / rms(uscita - golden)) >= min_null_db
+//  - errore massimo assoluto per campione <= max_abs_error
+//  - tempo di run() (il migliore di GOLDEN_TIMING_RUNS passate) <= max_ns_per_sample
+// GOLDEN_BUDGET_SCALE nell'ambiente moltiplica i budget (macchine lente, valgrind, ...).
+// Le configurazioni con i filtri della sidechain accesi dipendono da GLA3A_SIDECHAIN: con i filtri
+// di default (SVF) usano <nome>.f32, con gli altri <nome>_<GLA3A_SIDECHAIN_NAME>.f32 (es. _biquad).
+//
+// Uso: golden_regression [--update] <directory dei golden>
+//   --update riscrive i golden con l'uscita attuale ("make golden"): solo quando un cambio
+//   del suono è voluto, e va motivato nel commit.
+
+#include "../gla3a_svf.h"
+#include "../tools/gla3a_host.h"
+#include "../tools/gla3a_signals.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define GOLDEN_SAMPLERATE 48000.0
+#define GOLDEN_FRAMES 4096        // ~85 ms a 48 kHz: attacco, knee e primo rilascio
+#define GOLDEN_TIMING_RUNS 5
+#define GOLDEN_MAX_PATH 512
+
+typedef struct {
+    const char* name;
+    SignalType signal;
+    uint32_t block_size;
+    uint32_t max_block_length;   // Opzione bufsz:maxBlockLength (0 = non passata)
+
+    // Porte di controllo
+    float peak_reduction;
+    float gain;
+    float ratio_mode;
+    float ms;
+    float sc_lp;
+    float sc_hp;
+    float oversampling;
+    float os_mode;
+    float bypass;
+    float bands;
+    float stereo_link;
+    float link_detector;
+
+    // Tolleranze e budget
+    double min_null_db;
+    double max_abs_error;
+    double max_ns_per_sample;
+} GoldenConfig;
+
+static const GoldenConfig configs[] = {
+    // name                  signal          block maxb  peak  gain  ratio ms   lp   hp   os   mode byp  bands link lsum null   err    ns/sample
+    { "pink_3to1_4x",        SIGNAL_PINK,    256,  0,    0.6f, 0.25f, 0,   0,   0,   0,   2,   0,   0,   1,   0,   0,    100.0, 1e-5,  1500.0 },
+    { "sine_6to1_ms",        SIGNAL_SINE,    128,  0,    0.6f, 0.25f, 1,   1,   0,   0,   2,   0,   0,   1,   0,   0,    100.0, 1e-5,  1500.0 },
+    { "drums_9to1_sc",       SIGNAL_DRUMS,   64,   0,    0.7f, 0.25f, 2,   0,   1,   1,   2,   0,   0,   1,   0,   0,    100.0, 1e-5,  1500.0 },
+    { "drums_limit",         SIGNAL_DRUMS,   256,  0,    0.8f, 0.5f,  3,   0,   0,   0,   2,   0,   0,   1,   0,   0,    100.0, 1e-5,  1500.0 },
+    { "pink_1x",             SIGNAL_PINK,    512,  0,    0.6f, 0.25f, 0,   0,   0,   0,   0,   0,   0,   1,   0,   0,    100.0, 1e-5,  500.0  },
+    { "drums_2x_lowlat",     SIGNAL_DRUMS,   32,   0,    0.6f, 0.25f, 1,   0,   0,   0,   1,   1,   0,   1,   0,   0,    100.0, 1e-5,  1000.0 },
+    { "sine_8x_linear",      SIGNAL_SINE,    256,  0,    0.6f, 0.25f, 0,   0,   0,   0,   3,   0,   0,   1,   0,   0,    100.0, 1e-5,  3000.0 },
+    { "pink_ms_hp_chunked",  SIGNAL_PINK,    1000, 96,   0.5f, 0.25f, 2,   1,   0,   1,   2,   0,   0,   1,   0,   0,    100.0, 1e-5,  1500.0 },
+    { "sine_bypass_ms",      SIGNAL_SINE,    256,  0,    0.6f, 0.25f, 0,   1,   0,   0,   2,   0,   1,   1,   0,   0,    140.0, 0.0,   200.0  },
+    { "silence_8x_lowlat",   SIGNAL_SILENCE, 16,   0,    0.6f, 0.25f, 3,   0,   1,   1,   3,   1,   0,   1,   0,   0,    100.0, 1e-6,  3000.0 },
+    { "drums_3band",         SIGNAL_DRUMS,   128,  0,    0.7f, 0.25f, 1,   0,   0,   0,   2,   0,   0,   3,   0,   0,    100.0, 1e-5,  1500.0 },
+    { "pink_4band_ms",       SIGNAL_PINK,    1000, 96,   0.6f, 0.25f, 0,   1,   1,   1,   2,   0,   0,   4,   0,   0,    100.0, 1e-5,  1500.0 },
+    { "pink_linked_max",     SIGNAL_PINK,    256,  0,    0.6f, 0.25f, 0,   0,   0,   0,   2,   0,   0,   1,   1,   0,    100.0, 1e-5,  1500.0 },
+    { "drums_linked_sum_sc", SIGNAL_DRUMS,   64,   0,    0.7f, 0.25f, 2,   0,   1,   1,   2,   0,   0,   1,   1,   1,    100.0, 1e-5,  1500.0 },
+    { "pink_blend_max",      SIGNAL_PINK,    128,  0,    0.6f, 0.25f, 1,   0,   0,   1,   2,   0,   0,   1,   2,   0,    100.0, 1e-5,  1500.0 },
+    { "drums_3band_linked",  SIGNAL_DRUMS,   128,  0,    0.7f, 0.25f, 1,   0,   0,   0,   2,   0,   0,   3,   1,   0,    100.0, 1e-5,  1500.0 },
+    { "pink_4band_blend",    SIGNAL_PINK,    256,  0,    0.6f, 0.25f, 0,   0,   0,   0,   2,   0,   0,   4,   2,   1,    100.0, 1e-5,  1500.0 },
+};
+
+#define NUM_CONFIGS (sizeof(configs) / sizeof(configs[0]))
+
+// Percorso del golden di una configurazione per i filtri della sidechain di questa build
+static void golden_path(char* path, size_t size, const char* dir, const GoldenConfig* c) {
+    if (GLA3A_SIDECHAIN != GLA3A_SIDECHAIN_SVF && (c->sc_lp || c->sc_hp)) {
+        snprintf(path, size, "%s/%s_%s.f32", dir, c->name, GLA3A_SIDECHAIN_NAME);
+    } else {
+        snprintf(path, size, "%s/%s.f32", dir, c->name);
+    }
+}
+
+static double now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Elabora GOLDEN_FRAMES campioni e scrive l'uscita interlacciata in 'out' (2 * GOLDEN_FRAMES).
+// Ritorna il tempo speso dentro run() in ns, o < 0 se il plugin non si istanzia.
+static double render(const GoldenConfig* c, const float* in_l, const float* in_r, float* out) {
+    static MiniHost host;
+    static float out_l[GOLDEN_FRAMES], out_r[GOLDEN_FRAMES];
+    if (!host_open(&host, GOLDEN_SAMPLERATE, c->max_block_length)) return -1.0;
+
+    host.controls[GLA3A_PEAK_REDUCTION] = c->peak_reduction;
+    host.controls[GLA3A_GAIN] = c->gain;
+    host.controls[GLA3A_RATIO_MODE] = c->ratio_mode;
+    host.controls[GLA3A_MS_MODE_ACTIVE] = c->ms;
+    host.controls[GLA3A_SC_LP_ON] = c->sc_lp;
+    host.controls[GLA3A_SC_HP_ON] = c->sc_hp;
+    host.controls[GLA3A_OVERSAMPLING] = c->oversampling;
+    host.controls[GLA3A_OS_MODE] = c->os_mode;
+    host.controls[GLA3A_BYPASS] = c->bypass;
+    host.controls[GLA3A_BANDS] = c->bands;
+    host.controls[GLA3A_STEREO_LINK] = c->stereo_link;
+    host.controls[GLA3A_LINK_DETECTOR] = c->link_detector;
+    host_activate(&host);
+
+    double elapsed = 0.0;
+    for (uint32_t offset = 0; offset < GOLDEN_FRAMES; offset += c->block_size) {
+        const uint32_t n = (GOLDEN_FRAMES - offset < c->block_size) ? GOLDEN_FRAMES - offset : c->block_size;
+        host_connect_audio(&host, in_l + offset, in_r + offset, out_l + offset, out_r + offset);
+        const double start = now_ns();
+        host_run(&host, n);
+        elapsed += now_ns() - start;
+    }
+    host_close(&host);
+
+    for (uint32_t i = 0; i < GOLDEN_FRAMES; ++i) {
+        out[2 * i] = out_l[i];
+        out[2 * i + 1] = out_r[i];
+    }
+    return elapsed;
+}
+
+static bool read_golden(const char* path, float* data) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    size_t n = fread(data, sizeof(float), 2 * GOLDEN_FRAMES, f);
+    int extra = fgetc(f);
+    fclose(f);
+    return n == 2 * GOLDEN_FRAMES && extra == EOF;
+}
+
+static bool write_golden(const char* path, const float* data) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    size_t n = fwrite(data, sizeof(float), 2 * GOLDEN_FRAMES, f);
+    return fclose(f) == 0 && n == 2 * GOLDEN_FRAMES;
+}
+
+int main(int argc, char** argv) {
+    bool update = false;
+    const char* dir = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--update")) update = true;
+        else dir = argv[i];
+    }
+    if (!dir) {
+        fprintf(stderr, "Uso: %s [--update] <directory dei golden>\n", argv[0]);
+        return 2;
+    }
+
+    double budget_scale = 1.0;
+    if (getenv("GOLDEN_BUDGET_SCALE")) budget_scale = atof(getenv("GOLDEN_BUDGET_SCALE"));
+    if (budget_scale <= 0.0) budget_scale = 1.0;
+
+    static float in_l[GOLDEN_FRAMES], in_r[GOLDEN_FRAMES];
+    static float output[2 * GOLDEN_FRAMES], golden[2 * GOLDEN_FRAMES];
+    int failures = 0;
+
+    printf("golden: %u configurazioni, %d campioni a %.0f Hz, sidechain %s\n", (unsigned)NUM_CONFIGS, GOLDEN_FRAMES,
+           GOLDEN_SAMPLERATE, GLA3A_SIDECHAIN_NAME);
+    for (size_t k = 0; k < NUM_CONFIGS; ++k) {
+        const GoldenConfig* c = &configs[k];
+        char path[GOLDEN_MAX_PATH];
+        golden_path(path, sizeof(path), dir, c);
+        generate_signal(c->signal, GOLDEN_SAMPLERATE, in_l, in_r, GOLDEN_FRAMES);
+
+        // Il tempo migliore tra più passate: il rumore dello scheduler pesa meno sul budget
+        double best_ns = -1.0;
+        for (int run = 0; run < GOLDEN_TIMING_RUNS; ++run) {
+            double ns = render(c, in_l, in_r, output);
+            if (ns < 0.0) break;
+            if (best_ns < 0.0 || ns < best_ns) best_ns = ns;
+        }
+        if (best_ns < 0.0) {
+            printf("  %-20s FALLITO (istanziazione, segnale %s)\n", c->name, signal_name(c->signal));
+            ++failures;
+            continue;
+        }
+
+        if (update) {
+            bool ok = write_golden(path, output);
+            printf("  %-20s %s\n", c->name, ok ? "aggiornato" : "FALLITO (scrittura)");
+            if (!ok) ++failures;
+            continue;
+        }
+
+        if (!read_golden(path, golden)) {
+            printf("  %-20s FALLITO (%s mancante o di lunghezza errata, \"make golden\" per crearlo)\n", c->name, path);
+            ++failures;
+            continue;
+        }
+
+        double sum_ref = 0.0, sum_diff = 0.0, max_err = 0.0;
+        for (uint32_t i = 0; i < 2 * GOLDEN_FRAMES; ++i) {
+            double diff = (double)output[i] - (double)golden[i];
+            sum_ref += (double)golden[i] * golden[i];
+            sum_diff += diff * diff;
+            if (fabs(diff) > max_err) max_err = fabs(diff);
+        }
+        // Per i golden silenziosi il null è relativo al fondo scala
+        const double ref_rms = (sum_ref > 0.0) ? sqrt(sum_ref / (2 * GOLDEN_FRAMES)) : 1.0;
+        const double diff_rms = sqrt(sum_diff / (2 * GOLDEN_FRAMES));
+        const double null_db = (diff_rms > 0.0) ? 20.0 * log10(ref_rms / diff_rms) : INFINITY;
+        const double ns_per_sample = best_ns / GOLDEN_FRAMES;
+        const double budget = c->max_ns_per_sample * budget_scale;
+
+        const bool sound_ok = null_db >= c->min_null_db && max_err <= c->max_abs_error;
+        const bool cpu_ok = ns_per_sample <= budget;
+        printf("  %-20s null %7.1f dB (min %5.1f)  err %.2e (max %.0e)  %7.1f ns/sample (budget %6.0f)  %s\n",
+               c->name, isinf(null_db) ? 999.9 : null_db, c->min_null_db, max_err, c->max_abs_error,
+               ns_per_sample, budget, (sound_ok && cpu_ok) ? "ok" : (sound_ok ? "FALLITO (CPU)" : "FALLITO (suono)"));
+        if (!sound_ok || !cpu_ok) ++failures;
+    }
+
+    printf("%s\n", failures ? "FALLITO" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,110 @@
+// Verifica del riposo (blocchi di silenzio saltati a stato fermo, gla3a.cpp)
+// Segnale, lungo silenzio, di nuovo segnale: l'istanza che va a riposo deve dare la stessa
+// uscita di una che elabora ogni blocco. Il riferimento cambia la porta Meter (che non tocca
+// l'audio) a ogni blocco: un parametro cambiato fa uscire dal riposo, quindi non ci entra mai.
+//  - uscita identica per valore (lo zero scritto a riposo non ha segno) su tutta la sequenza
+//  - a riposo la coda di silenzio costa molto meno dell'elaborazione completa
+
+#include "../tools/gla3a_host.h"
+#include "../tools/gla3a_signals.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SAMPLERATE 48000.0
+#define BLOCK 256
+#define BURST_FRAMES 24576      // ~0.5 s di segnale prima e dopo il silenzio (multipli di BLOCK)
+#define SILENCE_FRAMES 1440000  // 30 s: gli envelope più lenti arrivano a zero
+#define TOTAL_FRAMES (2 * BURST_FRAMES + SILENCE_FRAMES)
+static_assert(TOTAL_FRAMES % BLOCK == 0, "la sequenza deve essere fatta di blocchi interi");
+#define TAIL_FRAMES (SILENCE_FRAMES / 3) // Ultima parte del silenzio, dove si misura il tempo
+#define MIN_SPEEDUP 4.0
+
+typedef struct {
+    const char* name;
+    float ratio_mode;
+    float oversampling;
+    float os_mode;
+    float sc_hp;
+    float bands;
+    float stereo_link;
+} IdleConfig;
+
+static const IdleConfig configs[] = {
+    // name                 ratio                oversampling  mode  hp    bands link
+    { "3:1, 4x, sc hp",     GLA3A_RATIO_3_TO_1,  GLA3A_OS_4X,  0.0f, 1.0f, 1.0f, GLA3A_LINK_UNLINKED },
+    { "9:1, 8x bassa lat.", GLA3A_RATIO_9_TO_1,  GLA3A_OS_8X,  1.0f, 0.0f, 1.0f, GLA3A_LINK_LINKED },
+    { "limit, 2x",          GLA3A_RATIO_LIMIT,   GLA3A_OS_2X,  1.0f, 0.0f, 1.0f, GLA3A_LINK_UNLINKED },
+    { "3 bande, misto",     GLA3A_RATIO_6_TO_1,  GLA3A_OS_4X,  0.0f, 0.0f, 3.0f, GLA3A_LINK_BLEND },
+};
+
+static float in_l[TOTAL_FRAMES], in_r[TOTAL_FRAMES];
+static float out_l[TOTAL_FRAMES], out_r[TOTAL_FRAMES];
+static float ref_l[TOTAL_FRAMES], ref_r[TOTAL_FRAMES];
+static MiniHost host;
+
+static double now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static bool check(const char* name, bool ok) {
+    printf("  %-40s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+// Elabora tutta la sequenza a blocchi; ritorna i ns spesi nella coda del silenzio
+static double render(const IdleConfig* cfg, float* l, float* r, bool toggle_meter) {
+    host_open(&host, SAMPLERATE, BLOCK);
+    host.controls[GLA3A_RATIO_MODE] = cfg->ratio_mode;
+    host.controls[GLA3A_OVERSAMPLING] = cfg->oversampling;
+    host.controls[GLA3A_OS_MODE] = cfg->os_mode;
+    host.controls[GLA3A_SC_HP_ON] = cfg->sc_hp;
+    host.controls[GLA3A_BANDS] = cfg->bands;
+    host.controls[GLA3A_STEREO_LINK] = cfg->stereo_link;
+    host_activate(&host);
+
+    const uint32_t tail_start = BURST_FRAMES + SILENCE_FRAMES - TAIL_FRAMES;
+    double tail_ns = 0.0;
+    for (uint32_t offset = 0; offset < TOTAL_FRAMES; offset += BLOCK) {
+        if (toggle_meter) host.controls[GLA3A_METER] = 1.0f - host.controls[GLA3A_METER];
+        host_connect_audio(&host, in_l + offset, in_r + offset, l + offset, r + offset);
+        const double start = now_ns();
+        host_run(&host, BLOCK);
+        const double elapsed = now_ns() - start;
+        if (offset >= tail_start && offset < BURST_FRAMES + SILENCE_FRAMES) tail_ns += elapsed;
+    }
+    host_close(&host);
+    return tail_ns;
+}
+
+int main() {
+    bool ok = true;
+    printf("idle: %.1f s di silenzio tra due colpi da %.1f s, blocchi da %d\n",
+           SILENCE_FRAMES / SAMPLERATE, BURST_FRAMES / SAMPLERATE, BLOCK);
+
+    generate_signal(SIGNAL_DRUMS, SAMPLERATE, in_l, in_r, BURST_FRAMES);
+    memcpy(in_l + BURST_FRAMES + SILENCE_FRAMES, in_l, BURST_FRAMES * sizeof(float));
+    memcpy(in_r + BURST_FRAMES + SILENCE_FRAMES, in_r, BURST_FRAMES * sizeof(float));
+
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); ++c) {
+        const IdleConfig* cfg = &configs[c];
+        const double idle_ns = render(cfg, out_l, out_r, false);
+        const double full_ns = render(cfg, ref_l, ref_r, true);
+
+        bool same = true;
+        for (uint32_t i = 0; i < TOTAL_FRAMES && same; ++i) {
+            same = (out_l[i] == ref_l[i]) && (out_r[i] == ref_r[i]);
+        }
+        char name[96];
+        snprintf(name, sizeof(name), "%s: uscita identica", cfg->name);
+        ok &= check(name, same);
+        snprintf(name, sizeof(name), "%s: coda %.1fx piu' veloce", cfg->name, full_ns / idle_ns);
+        ok &= check(name, idle_ns * MIN_SPEEDUP < full_ns);
+    }
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// Verifica delle varianti ISA dei kernel (gla3a_isa.h)
+// La stessa sequenza elaborata da un'istanza per ogni variante che la CPU supporta (scelta con
+// GLA3A_ISA nell'ambiente, come farebbe instantiate() su una CPU più vecchia):
+//  - audio e meter (output RMS, gain reduction) identici, bit per bit, a quelli della base
+// La sequenza passa per le configurazioni che scelgono kernel diversi (M/S, filtri della
+// sidechain, stadi e modalità dell'oversampling, Limit, multibanda, collegamento, bypass), con
+// blocchi di lunghezze diverse: anche i meter finiscono su blocchi che non sono multipli del vettore.
+
+#include "../gla3a_isa.h"
+#include "../tools/gla3a_host.h"
+#include "../tools/gla3a_signals.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define MAX_BLOCK 1024
+#define SCENE_FRAMES 6144
+#define MAX_SETTINGS 4
+
+typedef struct {
+    GLA3A_PortIndex port;
+    float value;
+} Setting;
+
+// Ogni scena parte dai valori della precedente; port 0 con value 0 chiude la lista
+static const Setting scenes[][MAX_SETTINGS] = {
+    { { GLA3A_OVERSAMPLING, GLA3A_OS_4X } },
+    { { GLA3A_MS_MODE_ACTIVE, 1.0f }, { GLA3A_SC_HP_ON, 1.0f } },
+    { { GLA3A_SC_LP_ON, 1.0f }, { GLA3A_OVERSAMPLING, GLA3A_OS_8X }, { GLA3A_RATIO_MODE, GLA3A_RATIO_9_TO_1 } },
+    { { GLA3A_MS_MODE_ACTIVE, 0.0f }, { GLA3A_STEREO_LINK, GLA3A_LINK_LINKED }, { GLA3A_OS_MODE, 1.0f } },
+    { { GLA3A_STEREO_LINK, GLA3A_LINK_BLEND }, { GLA3A_OVERSAMPLING, GLA3A_OS_2X }, { GLA3A_SC_HP_ON, 0.0f } },
+    { { GLA3A_RATIO_MODE, GLA3A_RATIO_LIMIT }, { GLA3A_OVERSAMPLING, GLA3A_OS_1X } },
+    { { GLA3A_RATIO_MODE, GLA3A_RATIO_6_TO_1 }, { GLA3A_BANDS, 3.0f }, { GLA3A_OS_MODE, 0.0f } },
+    { { GLA3A_BANDS, 4.0f }, { GLA3A_MS_MODE_ACTIVE, 1.0f }, { GLA3A_OVERSAMPLING, GLA3A_OS_4X } },
+    { { GLA3A_BYPASS, 1.0f } },
+};
+#define NUM_SCENES (sizeof(scenes) / sizeof(scenes[0]))
+#define FRAMES (NUM_SCENES * SCENE_FRAMES)
+
+static const uint32_t block_lengths[] = { 256, 37, 1024, 5, 613, 64 };
+#define NUM_BLOCK_LENGTHS (sizeof(block_lengths) / sizeof(block_lengths[0]))
+#define MAX_RUNS (FRAMES / 5 + NUM_SCENES)
+
+typedef struct {
+    float out_l[FRAMES], out_r[FRAMES];
+    float output_rms[MAX_RUNS];
+    float gain_reduction[MAX_RUNS];
+    uint32_t runs;
+} Render;
+
+static float in_l[FRAMES], in_r[FRAMES];
+static Render base, variant;
+static MiniHost host;
+
+static bool check(const char* name, bool ok) {
+    printf("  %-44s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+// Tutta la sequenza con la variante isa (limitata come da GLA3A_ISA)
+static bool render(int isa, Render* r) {
+    setenv("GLA3A_ISA", isa_names[isa], 1);
+    if (!host_open(&host, SAMPLERATE, MAX_BLOCK)) return false;
+    host_activate(&host);
+
+    r->runs = 0;
+    for (uint32_t s = 0, offset = 0, b = 0; s < NUM_SCENES; ++s) {
+        for (int k = 0; k < MAX_SETTINGS && (scenes[s][k].port || scenes[s][k].value); ++k) {
+            host.controls[scenes[s][k].port] = scenes[s][k].value;
+        }
+        const uint32_t end = (s + 1) * SCENE_FRAMES;
+        while (offset < end) {
+            uint32_t n = block_lengths[b++ % NUM_BLOCK_LENGTHS];
+            if (n > end - offset) n = end - offset;
+            host_connect_audio(&host, in_l + offset, in_r + offset, r->out_l + offset, r->out_r + offset);
+            host_run(&host, n);
+            r->output_rms[r->runs] = host.controls[GLA3A_OUTPUT_RMS];
+            r->gain_reduction[r->runs] = host.controls[GLA3A_GAIN_REDUCTION_METER];
+            ++r->runs;
+            offset += n;
+        }
+    }
+    host_close(&host);
+    unsetenv("GLA3A_ISA");
+    return true;
+}
+
+static bool same_render(const Render* a, const Render* b) {
+    return a->runs == b->runs && !memcmp(a->out_l, b->out_l, sizeof(a->out_l)) &&
+           !memcmp(a->out_r, b->out_r, sizeof(a->out_r)) &&
+           !memcmp(a->output_rms, b->output_rms, a->runs * sizeof(float)) &&
+           !memcmp(a->gain_reduction, b->gain_reduction, a->runs * sizeof(float));
+}
+
+int main() {
+    bool ok = true;
+    const int best = isa_detect();
+    printf("isa: %d scene da %d campioni a %.0f Hz, CPU fino a %s\n", (int)NUM_SCENES, SCENE_FRAMES, SAMPLERATE,
+           isa_names[best]);
+    generate_signal(SIGNAL_DRUMS, SAMPLERATE, in_l, in_r, FRAMES);
+
+    if (!render(GLA3A_ISA_BASELINE, &base)) return 1;
+    if (best == GLA3A_ISA_BASELINE) printf("  nessuna variante oltre la base su questa CPU\n");
+    for (int isa = GLA3A_ISA_BASELINE + 1; isa <= best; ++isa) {
+        char name[96];
+        snprintf(name, sizeof(name), "%s: audio e meter identici alla base", isa_names[isa]);
+        ok &= check(name, render(isa, &variant) && same_render(&base, &variant));
+    }
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
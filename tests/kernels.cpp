@@ -0,0 +1,156 @@
+// Verifica dei kernel specializzati (gla3a_kernels.h) contro quelli generici
+//  - oversampling: per ogni fattore e modalità, interpolazione e decimazione con gli stadi noti a
+//    compilazione danno gli stessi campioni, bit per bit, di quelle che leggono gli stadi a runtime
+//  - sidechain: LowPass e HighPass in un passo solo (biquad_bank_process_chain) danno la stessa
+//    uscita e gli stessi stati dei due banchi uno dopo l'altro, stereo e su un canale solo
+// Blocchi di lunghezze diverse, così gli stati passano da un blocco all'altro.
+
+#include "../gla3a_biquad_bank.h"
+#include "../gla3a_oversampler.h"
+#include "../tools/gla3a_signals.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define N 8192
+#define NUM_BIQUADS 3
+
+static const uint32_t block_lengths[] = { 1, 37, 256, 61, 1024, 5 };
+#define NUM_BLOCK_LENGTHS (sizeof(block_lengths) / sizeof(block_lengths[0]))
+
+static float in_l[N], in_r[N];
+static float up_M[2][N * OS_MAX_FACTOR], up_S[2][N * OS_MAX_FACTOR];
+static float scratch_M[N * OS_MAX_FACTOR / 2], scratch_S[N * OS_MAX_FACTOR / 2];
+static float dn_M[2][N], dn_S[2][N];
+static DetectorReal sc_M[2][N], sc_S[2][N];
+
+static bool check(const char* name, bool ok) {
+    printf("  %-44s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+// --- Oversampling ---
+
+template <int STAGES>
+static void run_oversampler(Oversampler* os, int k, uint32_t offset, uint32_t n) {
+    oversampler_upsample<STAGES>(os, in_l + offset, in_r + offset, up_M[k] + offset * os->factor,
+                                 up_S[k] + offset * os->factor, scratch_M, scratch_S, n);
+    // La decimazione lavora sul posto: parte da una copia dell'interpolato
+    static float buf_M[N * OS_MAX_FACTOR], buf_S[N * OS_MAX_FACTOR];
+    memcpy(buf_M, up_M[k] + offset * os->factor, sizeof(float) * n * os->factor);
+    memcpy(buf_S, up_S[k] + offset * os->factor, sizeof(float) * n * os->factor);
+    oversampler_downsample<STAGES>(os, buf_M, buf_S, dn_M[k] + offset, dn_S[k] + offset, n);
+}
+
+static void run_oversampler_kernel(Oversampler* os, uint32_t offset, uint32_t n) {
+    switch (os->num_stages) {
+        case 0:  run_oversampler<0>(os, 1, offset, n); break;
+        case 1:  run_oversampler<1>(os, 1, offset, n); break;
+        case 2:  run_oversampler<2>(os, 1, offset, n); break;
+        default: run_oversampler<3>(os, 1, offset, n); break;
+    }
+}
+
+static bool same_oversampling(int factor, int mode) {
+    static Oversampler generic, kernel;
+    oversampler_init(&generic);
+    oversampler_init(&kernel);
+    oversampler_configure(&generic, factor, mode);
+    oversampler_configure(&kernel, factor, mode);
+
+    for (uint32_t offset = 0, b = 0; offset < N; ++b) {
+        uint32_t n = block_lengths[b % NUM_BLOCK_LENGTHS];
+        if (n > N - offset) n = N - offset;
+        run_oversampler<KERNEL_RUNTIME>(&generic, 0, offset, n);
+        run_oversampler_kernel(&kernel, offset, n);
+        offset += n;
+    }
+    const size_t up_bytes = sizeof(float) * N * factor;
+    return !memcmp(up_M[0], up_M[1], up_bytes) && !memcmp(up_S[0], up_S[1], up_bytes) &&
+           !memcmp(dn_M[0], dn_M[1], sizeof(dn_M[0])) && !memcmp(dn_S[0], dn_S[1], sizeof(dn_S[0]));
+}
+
+// --- Sidechain ---
+
+// Coefficienti RBJ normalizzati (Q Butterworth), come calculate_biquad_coeffs()
+static void set_rbj(BiquadBank* bank, double freq_hz, bool highpass) {
+    const double omega = 2.0 * M_PI * freq_hz / SAMPLERATE;
+    const double alpha = sin(omega) * M_SQRT1_2;
+    const double a0 = 1.0 + alpha;
+    const double c = cos(omega);
+    const double b0 = (highpass ? (1.0 + c) : (1.0 - c)) / 2.0 / a0;
+    const double b1 = (highpass ? -(1.0 + c) : (1.0 - c)) / a0;
+    for (int k = 0; k < NUM_BIQUADS; ++k) {
+        biquad_bank_set_stage(bank, k, (FilterReal)b0, (FilterReal)b1, (FilterReal)b0,
+                              (FilterReal)(-2.0 * c / a0), (FilterReal)((1.0 - alpha) / a0));
+    }
+}
+
+static bool same_state(const BiquadBank* a, const BiquadBank* b) {
+    return !memcmp(a->z1, b->z1, sizeof(a->z1)) && !memcmp(a->z2, b->z2, sizeof(a->z2));
+}
+
+// lp/hp: cascate accese; mono: un canale solo (detector collegato)
+template <int LP, int HP>
+static bool same_sidechain(bool mono) {
+    BiquadBank lp[2], hp[2];
+    for (int k = 0; k < 2; ++k) {
+        biquad_bank_init(&lp[k], NUM_BIQUADS);
+        biquad_bank_init(&hp[k], NUM_BIQUADS);
+        set_rbj(&lp[k], 3000.0, false);
+        set_rbj(&hp[k], 120.0, true);
+        for (int i = 0; i < N; ++i) {
+            sc_M[k][i] = fabsf(in_l[i]);
+            sc_S[k][i] = fabsf(in_r[i]);
+        }
+    }
+
+    for (uint32_t offset = 0, b = 0; offset < N; ++b) {
+        uint32_t n = block_lengths[b % NUM_BLOCK_LENGTHS];
+        if (n > N - offset) n = N - offset;
+        DetectorReal* m0 = sc_M[0] + offset;
+        DetectorReal* s0 = sc_S[0] + offset;
+        if (LP) {
+            if (mono) biquad_bank_process_mono(&lp[0], m0, n);
+            else      biquad_bank_process(&lp[0], m0, s0, n);
+        }
+        if (HP) {
+            if (mono) biquad_bank_process_mono(&hp[0], m0, n);
+            else      biquad_bank_process(&hp[0], m0, s0, n);
+        }
+        biquad_bank_process_chain<LP ? NUM_BIQUADS : 0, HP ? NUM_BIQUADS : 0>(
+            &lp[1], &hp[1], sc_M[1] + offset, mono ? NULL : sc_S[1] + offset, n);
+        offset += n;
+    }
+    return !memcmp(sc_M[0], sc_M[1], sizeof(sc_M[0])) && !memcmp(sc_S[0], sc_S[1], sizeof(sc_S[0])) &&
+           same_state(&lp[0], &lp[1]) && same_state(&hp[0], &hp[1]);
+}
+
+int main() {
+    bool ok = true;
+    printf("kernels: %d campioni a %.0f Hz, %s\n", N, SAMPLERATE, GLA3A_PRECISION_NAME);
+    generate_signal(SIGNAL_DRUMS, SAMPLERATE, in_l, in_r, N);
+
+    char name[96];
+    for (int mode = OS_MODE_LINEAR_PHASE; mode <= OS_MODE_LOW_LATENCY; ++mode) {
+        for (int factor = 1; factor <= OS_MAX_FACTOR; factor *= 2) {
+            snprintf(name, sizeof(name), "oversampling %dx %s", factor,
+                     mode == OS_MODE_LINEAR_PHASE ? "fase lineare" : "bassa latenza");
+            ok &= check(name, same_oversampling(factor, mode));
+        }
+    }
+
+    for (int mono = 0; mono <= 1; ++mono) {
+        const char* channels = mono ? "un canale" : "stereo";
+        snprintf(name, sizeof(name), "sidechain LowPass, %s", channels);
+        ok &= check(name, same_sidechain<1, 0>(mono));
+        snprintf(name, sizeof(name), "sidechain HighPass, %s", channels);
+        ok &= check(name, same_sidechain<0, 1>(mono));
+        snprintf(name, sizeof(name), "sidechain LowPass e HighPass, %s", channels);
+        ok &= check(name, same_sidechain<1, 1>(mono));
+    }
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+// Verifica della latenza riportata (porta GLA3A_LATENCY) contro il ritardo misurato di un impulso
+// Per ogni fattore e modalità di oversampling, in compressione e in Limit (con il lookahead):
+//  - elaborato: il picco dell'uscita cade esattamente alla latenza riportata con i filtri a fase
+//    lineare; con quelli a bassa latenza (fase non lineare, ritardo non intero) entro un campione
+//  - in bypass: l'uscita è l'ingresso ritardato esattamente della stessa latenza
+//  - il bypass attivato a metà flusso non sposta il segnale: gli impulsi successivi restano allineati
+// L'impulso è sotto la soglia: niente gain reduction, solo il ritardo dei filtri e del limiter.
+
+#include "../tools/gla3a_host.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define FRAMES 8192
+#define BLOCK 256
+#define IMPULSE_AT 1000
+#define IMPULSE_SPACING 2048
+#define IMPULSE_LEVEL 0.1f // -20 dBFS, sotto la soglia più alta (Peak Reduction a 1)
+
+static float in_l[FRAMES], in_r[FRAMES];
+static float out_l[FRAMES], out_r[FRAMES];
+static MiniHost host;
+
+static bool check(const char* name, bool ok) {
+    printf("  %-50s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+// Elabora tutta la sequenza; bypass_from: primo blocco in bypass (FRAMES = mai). Ritorna la latenza
+// riportata all'ultimo blocco.
+static uint32_t render(float oversampling, float os_mode, float ratio_mode, uint32_t bypass_from) {
+    host_open(&host, SAMPLERATE, BLOCK);
+    host.controls[GLA3A_PEAK_REDUCTION] = 1.0f;
+    host.controls[GLA3A_GAIN] = 0.0f;
+    host.controls[GLA3A_OVERSAMPLING] = oversampling;
+    host.controls[GLA3A_OS_MODE] = os_mode;
+    host.controls[GLA3A_RATIO_MODE] = ratio_mode;
+    host_activate(&host);
+    for (uint32_t offset = 0; offset < FRAMES; offset += BLOCK) {
+        host.controls[GLA3A_BYPASS] = (offset >= bypass_from) ? 1.0f : 0.0f;
+        host_connect_audio(&host, in_l + offset, in_r + offset, out_l + offset, out_r + offset);
+        host_run(&host, BLOCK);
+    }
+    const uint32_t latency = (uint32_t)host.controls[GLA3A_LATENCY];
+    host_close(&host);
+    return latency;
+}
+
+// Ritardo del picco dell'uscita sinistra rispetto all'impulso che parte da 'at'
+static int32_t measured_delay(uint32_t at) {
+    uint32_t peak = at;
+    for (uint32_t i = at; i < at + IMPULSE_SPACING / 2 && i < FRAMES; ++i) {
+        if (fabsf(out_l[i]) > fabsf(out_l[peak])) peak = i;
+    }
+    return (int32_t)(peak - at);
+}
+
+int main() {
+    bool ok = true;
+    printf("latency: impulsi a %.0f dBFS, %d campioni a %.0f Hz\n", 20.0 * log10(IMPULSE_LEVEL), FRAMES, SAMPLERATE);
+
+    for (uint32_t at = IMPULSE_AT; at < FRAMES; at += IMPULSE_SPACING) in_l[at] = in_r[at] = IMPULSE_LEVEL;
+
+    static const char* const ratio_names[] = { "3:1", "Limit" };
+    static const float ratios[] = { GLA3A_RATIO_3_TO_1, GLA3A_RATIO_LIMIT };
+    for (int os = GLA3A_OS_1X; os <= GLA3A_OS_8X; ++os) {
+        for (int mode = 0; mode <= 1; ++mode) {
+            if (os == GLA3A_OS_1X && mode == 1) continue; // A 1x i filtri non ci sono
+            for (int r = 0; r < 2; ++r) {
+                const bool exact = (mode == 0);
+                char name[96];
+
+                const uint32_t latency = render((float)os, (float)mode, ratios[r], FRAMES);
+                const int32_t delay = measured_delay(IMPULSE_AT);
+                snprintf(name, sizeof(name), "%dx %s %s: latenza %u, picco a %d", 1 << os, mode ? "bassa lat." : "lineare",
+                         ratio_names[r], latency, delay);
+                ok &= check(name, exact ? delay == (int32_t)latency : abs(delay - (int32_t)latency) <= 1);
+
+                const uint32_t bypass_latency = render((float)os, (float)mode, ratios[r], 0);
+                bool same = bypass_latency == latency;
+                for (uint32_t i = 0; i < FRAMES; ++i) {
+                    const float expected = (i >= latency) ? in_l[i - latency] : 0.0f;
+                    same &= out_l[i] == expected && out_r[i] == expected;
+                }
+                snprintf(name, sizeof(name), "%dx %s %s: bypass ritardato di %u", 1 << os, mode ? "bassa lat." : "lineare",
+                         ratio_names[r], bypass_latency);
+                ok &= check(name, same);
+            }
+        }
+    }
+
+    // Bypass attivato tra due impulsi: il secondo esce allo stesso ritardo del primo
+    const uint32_t latency = render(GLA3A_OS_4X, 0, GLA3A_RATIO_3_TO_1, IMPULSE_AT + IMPULSE_SPACING / 2);
+    ok &= check("bypass a metà flusso: stesso ritardo",
+                measured_delay(IMPULSE_AT) == (int32_t)latency && measured_delay(IMPULSE_AT + IMPULSE_SPACING) == (int32_t)latency);
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
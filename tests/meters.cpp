@@ -0,0 +1,253 @@
+// Verifica dei frame dei meter sulla porta GLA3A_NOTIFY (meter_feed() in gla3a.cpp)
+//  - un frame ogni meter_period campioni, con il timestamp dell'ultimo campione della finestra,
+//    qualunque sia la lunghezza dei blocchi dell'host
+//  - l'audio non cambia con la porta collegata (i pezzi tagliati al confine delle finestre)
+//  - in bypass picco e RMS di un seno con periodo intero nella finestra, uscita uguale all'ingresso
+//    ritardato della latenza riportata
+//  - con ingresso e uscita sullo stesso buffer i meter d'ingresso leggono l'ingresso
+//  - la GR del frame è la massima di quelle riportate dal meter di controllo nella finestra
+//  - con poco spazio nella porta i frame in più si perdono e la sequenza resta valida
+
+#include "../tools/gla3a_host.h"
+#include "../tools/gla3a_signals.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define PERIOD 1600 // SAMPLERATE / GLA3A_METER_RATE_HZ
+#define FRAMES (30 * PERIOD)
+#define MAX_BLOCK 1024
+#define MAX_METER_FRAMES (FRAMES / PERIOD)
+#define SINE_HZ 600.0 // 80 campioni per ciclo: 20 cicli in una finestra
+#define DB_TOLERANCE 1e-3f
+
+static const uint32_t block_lengths[] = { 256, 37, 1024, 5, 613, 64 };
+#define NUM_BLOCK_LENGTHS (sizeof(block_lengths) / sizeof(block_lengths[0]))
+
+typedef struct {
+    uint64_t time; // Campione nella sequenza intera
+    float value[GLA3A_METER_NUM_VALUES];
+} MeterFrame;
+
+typedef struct {
+    MeterFrame frame[MAX_METER_FRAMES + 1];
+    uint32_t count;
+    bool valid;    // Ogni evento era un frame ben formato
+} MeterFrames;
+
+typedef struct {
+    float bypass;
+    bool notify;   // Porta GLA3A_NOTIFY collegata
+    bool in_place; // Ingresso e uscita sullo stesso buffer
+    uint32_t block; // 0: le lunghezze di block_lengths[]
+} Setup;
+
+static float in_l[FRAMES], in_r[FRAMES];
+static float out_l[FRAMES], out_r[FRAMES];
+static float ref_l[FRAMES], ref_r[FRAMES];
+static float port_gr[FRAMES];
+static uint32_t latency; // GLA3A_LATENCY dopo l'ultima run di render()
+static MeterFrames frames, ref_frames;
+static MiniHost host;
+
+static bool check(const char* name, bool ok) {
+    printf("  %-44s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+// Aggiunge i frame della sequenza in uscita dopo una run iniziata al campione 'start'
+static void collect_frames(const MiniHost* h, uint64_t start, MeterFrames* f) {
+    const LV2_URID object = host_map_uri(NULL, LV2_ATOM__Object);
+    const LV2_URID vector = host_map_uri(NULL, LV2_ATOM__Vector);
+    const LV2_URID atom_float = host_map_uri(NULL, LV2_ATOM__Float);
+    const LV2_URID meter_frame = host_map_uri(NULL, GLA3A_METER_FRAME_URI);
+    const LV2_URID meter_values = host_map_uri(NULL, GLA3A_METER_VALUES_URI);
+    if (h->notify.sequence.atom.type != host_map_uri(NULL, LV2_ATOM__Sequence)) {
+        f->valid = false;
+        return;
+    }
+
+    LV2_ATOM_SEQUENCE_FOREACH(&h->notify.sequence, ev) {
+        const LV2_Atom_Object* obj = (const LV2_Atom_Object*)&ev->body;
+        const LV2_Atom* values = NULL;
+        if (ev->body.type != object || obj->body.otype != meter_frame || f->count > MAX_METER_FRAMES) {
+            f->valid = false;
+            return;
+        }
+        lv2_atom_object_get(obj, meter_values, &values, 0);
+        const LV2_Atom_Vector* v = (const LV2_Atom_Vector*)values;
+        if (!v || v->atom.type != vector || v->body.child_type != atom_float || v->body.child_size != sizeof(float) ||
+            v->atom.size != sizeof(LV2_Atom_Vector_Body) + GLA3A_METER_NUM_VALUES * sizeof(float)) {
+            f->valid = false;
+            return;
+        }
+        MeterFrame* frame = &f->frame[f->count++];
+        frame->time = start + ev->time.frames;
+        memcpy(frame->value, v + 1, sizeof(frame->value));
+    }
+}
+
+// La sequenza intera, con i controlli di base di MiniHost (compressione a 3:1, oversampling 4x)
+static void render(const Setup* s, float* dst_l, float* dst_r, MeterFrames* f) {
+    host_open(&host, SAMPLERATE, MAX_BLOCK);
+    host.controls[GLA3A_BYPASS] = s->bypass;
+    if (!s->notify) host.descriptor->connect_port(host.instance, GLA3A_NOTIFY, NULL);
+    host_activate(&host);
+
+    if (s->in_place) {
+        memcpy(dst_l, in_l, sizeof(in_l));
+        memcpy(dst_r, in_r, sizeof(in_r));
+    }
+    f->count = 0;
+    f->valid = true;
+    for (uint32_t offset = 0, b = 0; offset < FRAMES; ++b) {
+        uint32_t n = s->block ? s->block : block_lengths[b % NUM_BLOCK_LENGTHS];
+        if (n > FRAMES - offset) n = FRAMES - offset;
+        const float* src_l = s->in_place ? dst_l : in_l;
+        const float* src_r = s->in_place ? dst_r : in_r;
+        host_connect_audio(&host, src_l + offset, src_r + offset, dst_l + offset, dst_r + offset);
+        host_run(&host, n);
+        if (s->notify) collect_frames(&host, offset, f);
+        port_gr[b] = host.controls[GLA3A_GAIN_REDUCTION_METER];
+        offset += n;
+    }
+    latency = (uint32_t)host.controls[GLA3A_LATENCY];
+    host_close(&host);
+}
+
+static bool near_db(float a, float b) {
+    return fabsf(a - b) <= DB_TOLERANCE;
+}
+
+// Un frame per finestra, ciascuno sull'ultimo campione della sua finestra
+static bool fixed_rate(const MeterFrames* f) {
+    if (!f->valid || f->count != MAX_METER_FRAMES) return false;
+    for (uint32_t k = 0; k < f->count; ++k) {
+        if (f->frame[k].time != (uint64_t)(k + 1) * PERIOD - 1) return false;
+    }
+    return true;
+}
+
+// Picco e RMS di [start, start + PERIOD) di un canale, in dB
+static void window_levels(const float* x, uint32_t start, float* peak_db, float* rms_db) {
+    float peak = 0.0f;
+    double sum = 0.0;
+    for (uint32_t i = start; i < start + PERIOD; ++i) {
+        peak = fmaxf(peak, fabsf(x[i]));
+        sum += (double)x[i] * x[i];
+    }
+    *peak_db = 20.0f * log10f(peak);
+    *rms_db = 20.0f * log10f((float)sqrt(sum / PERIOD));
+}
+
+// Picchi e RMS d'ingresso dei frame uguali a quelli misurati sul segnale
+static bool input_levels(const MeterFrames* f) {
+    if (!f->valid || f->count != MAX_METER_FRAMES) return false;
+    for (uint32_t k = 0; k < f->count; ++k) {
+        const float* v = f->frame[k].value;
+        float peak_l, rms_l, peak_r, rms_r;
+        window_levels(in_l, k * PERIOD, &peak_l, &rms_l);
+        window_levels(in_r, k * PERIOD, &peak_r, &rms_r);
+        if (!near_db(v[GLA3A_METER_IN_PEAK_L], peak_l) || !near_db(v[GLA3A_METER_IN_RMS_L], rms_l) ||
+            !near_db(v[GLA3A_METER_IN_PEAK_R], peak_r) || !near_db(v[GLA3A_METER_IN_RMS_R], rms_r)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Bypass: uscita uguale all'ingresso ritardato, nessuna GR. Dal secondo frame (il primo contiene
+// il ritardo) i livelli d'uscita sono quelli d'ingresso: il seno ha un periodo intero nella finestra.
+static bool bypass_values(const MeterFrames* f) {
+    if (!input_levels(f) || latency == 0) return false;
+    if (memcmp(out_l + latency, in_l, (FRAMES - latency) * sizeof(float)) ||
+        memcmp(out_r + latency, in_r, (FRAMES - latency) * sizeof(float))) {
+        return false;
+    }
+    for (uint32_t k = 0; k < f->count; ++k) {
+        const float* v = f->frame[k].value;
+        if (v[GLA3A_METER_GR] != 0.0f) return false;
+        if (k > 0 && (!near_db(v[GLA3A_METER_OUT_PEAK_L], v[GLA3A_METER_IN_PEAK_L]) || !near_db(v[GLA3A_METER_OUT_RMS_L], v[GLA3A_METER_IN_RMS_L]) ||
+                      !near_db(v[GLA3A_METER_OUT_PEAK_R], v[GLA3A_METER_IN_PEAK_R]) || !near_db(v[GLA3A_METER_OUT_RMS_R], v[GLA3A_METER_IN_RMS_R]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Blocchi di mezza finestra: la GR del frame k è la massima delle run 2k e 2k + 1
+static bool gr_matches_port(const MeterFrames* f) {
+    if (!f->valid || f->count != MAX_METER_FRAMES) return false;
+    bool compressed = false;
+    for (uint32_t k = 0; k < f->count; ++k) {
+        const float gr = f->frame[k].value[GLA3A_METER_GR];
+        if (gr != fmaxf(port_gr[2 * k], port_gr[2 * k + 1])) return false;
+        compressed |= gr > 1.0f;
+    }
+    return compressed;
+}
+
+// Spazio per un frame solo in run da tre finestre: il primo entra, gli altri si perdono
+static bool small_buffer() {
+    host_open(&host, SAMPLERATE, 3 * PERIOD);
+    host_activate(&host);
+    bool ok = true;
+    uint32_t frame_bytes = 0;
+    for (uint32_t run = 0; run < 3; ++run) {
+        host_connect_audio(&host, in_l + run * 3 * PERIOD, in_r + run * 3 * PERIOD, out_l, out_r);
+        host.notify.sequence.atom.type = host_map_uri(NULL, LV2_ATOM__Chunk);
+        host.notify.sequence.atom.size = sizeof(LV2_Atom_Sequence) + 100; // Un frame, non due
+        host.descriptor->run(host.instance, 3 * PERIOD);
+        MeterFrames* f = &ref_frames;
+        f->count = 0;
+        f->valid = true;
+        collect_frames(&host, 0, f);
+        ok &= f->valid && f->count == 1 && f->frame[0].time == PERIOD - 1;
+        frame_bytes = host.notify.sequence.atom.size - sizeof(LV2_Atom_Sequence_Body);
+    }
+    host_close(&host);
+    printf("  frame da %u byte, %.0f al secondo\n", frame_bytes, SAMPLERATE / PERIOD);
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    printf("meters: %d campioni a %.0f Hz, un frame ogni %d\n", FRAMES, SAMPLERATE, PERIOD);
+
+    generate_signal(SIGNAL_DRUMS, SAMPLERATE, in_l, in_r, FRAMES);
+    const Setup with_port = { 0.0f, true, false, 0 };
+    const Setup without_port = { 0.0f, false, false, 0 };
+    render(&with_port, out_l, out_r, &frames);
+    render(&without_port, ref_l, ref_r, &ref_frames);
+    ok &= check("un frame per finestra, blocchi vari", fixed_rate(&frames));
+    ok &= check("audio identico senza la porta", !memcmp(out_l, ref_l, sizeof(out_l)) && !memcmp(out_r, ref_r, sizeof(out_r)));
+    ok &= check("nessun frame senza la porta", ref_frames.count == 0);
+    ok &= check("picchi e RMS d'ingresso", input_levels(&frames));
+
+    const Setup in_place = { 0.0f, true, true, 0 };
+    render(&in_place, ref_l, ref_r, &ref_frames);
+    ok &= check("sul posto: stessa uscita", !memcmp(out_l, ref_l, sizeof(out_l)) && !memcmp(out_r, ref_r, sizeof(out_r)));
+    ok &= check("sul posto: meter d'ingresso sull'ingresso", fixed_rate(&ref_frames) && input_levels(&ref_frames));
+
+    const Setup half_windows = { 0.0f, true, false, PERIOD / 2 };
+    render(&half_windows, out_l, out_r, &frames);
+    ok &= check("GR massima del meter di controllo", gr_matches_port(&frames));
+
+    // Seno a periodo intero nella finestra, livelli diversi sui due canali
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        const float x = (float)sin(2.0 * M_PI * SINE_HZ * i / SAMPLERATE);
+        in_l[i] = 0.5f * x;
+        in_r[i] = 0.125f * x;
+    }
+    const Setup bypass = { 1.0f, true, false, 0 };
+    render(&bypass, out_l, out_r, &frames);
+    ok &= check("bypass: seno ritardato, GR nulla", fixed_rate(&frames) && bypass_values(&frames));
+    ok &= check("bypass: RMS del seno", near_db(frames.frame[0].value[GLA3A_METER_IN_RMS_L], 20.0f * log10f(0.5f * (float)M_SQRT1_2)) &&
+                                         near_db(frames.frame[0].value[GLA3A_METER_IN_PEAK_R], 20.0f * log10f(0.125f)));
+
+    ok &= check("poco spazio: un frame per run", small_buffer());
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// Verifica della modalità multibanda (gla3a_multiband.h)
+//  - crossover: con 2, 3 e 4 bande la somma delle bande ha la stessa ampiezza dell'ingresso
+//    (LR4 + passa-tutto di compensazione) a ogni frequenza di prova
+//  - gain computer vettoriale: bit per bit uguale a quello scalare su tutto il range
+//  - band dynamics: spezzare il blocco non cambia un bit
+
+#include "../gla3a_multiband.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define N 16384
+#define SETTLE 8192 // Campioni scartati prima di misurare (transitorio dei filtri)
+#define SPLIT 37
+
+static float in_M[N], in_S[N], whole[N], parts[N];
+static v4sf bands_M[N], bands_S[N];
+
+static bool check(const char* name, bool ok) {
+    printf("  %-32s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+// Scarto massimo (dB) tra l'ampiezza della somma delle bande e quella dell'ingresso
+static double crossover_flatness(int num_bands) {
+    static const float freq[MULTIBAND_MAX_CROSSOVERS] = { 200.0f, 1000.0f, 5000.0f };
+    // Numero intero di periodi nella finestra di misura: l'RMS non dipende dalla fase
+    static const int probe_periods[] = { 7, 26, 34, 77, 171, 375, 853, 1536, 2731 }; // ~40 Hz .. ~16 kHz
+    double worst = 0.0;
+    for (size_t p = 0; p < sizeof(probe_periods) / sizeof(probe_periods[0]); ++p) {
+        const double freq_hz = probe_periods[p] * SAMPLERATE / (N - SETTLE);
+        Crossover xo;
+        crossover_init(&xo);
+        crossover_configure(&xo, num_bands, freq, SAMPLERATE);
+        for (int i = 0; i < N; ++i) {
+            in_M[i] = (float)sin(2.0 * M_PI * freq_hz * i / SAMPLERATE);
+            in_S[i] = 0.5f * in_M[i];
+        }
+        stage_crossover(&xo, in_M, in_S, bands_M, bands_S, N);
+
+        double sum_in = 0.0, sum_out = 0.0;
+        for (int i = SETTLE; i < N; ++i) {
+            float y = bands_M[i][0] + bands_M[i][1] + bands_M[i][2] + bands_M[i][3];
+            sum_in += (double)in_M[i] * in_M[i];
+            sum_out += (double)y * y;
+        }
+        double deviation = fabs(10.0 * log10(sum_out / sum_in));
+        if (deviation > worst) worst = deviation;
+    }
+    return worst;
+}
+
+int main() {
+    bool ok = true;
+    printf("multiband: %d campioni a %.0f Hz\n", N, SAMPLERATE);
+
+    // --- Somma piatta del crossover ---
+    for (int bands = 2; bands <= MULTIBAND_MAX_BANDS; ++bands) {
+        char name[64];
+        double worst = crossover_flatness(bands);
+        snprintf(name, sizeof(name), "crossover %d bande (%.4f dB)", bands, worst);
+        ok &= check(name, worst < 0.01);
+    }
+
+    // --- Gain computer vettoriale contro scalare ---
+    GainComputer gc;
+    gain_computer_init(&gc);
+    gain_computer_update(&gc, 6.0f, 10.0f);
+    bool same = true;
+    const v4sf threshold = { -30.0f, -20.0f, -40.0f, -10.0f };
+    for (float db = -100.0f; db < 10.0f && same; db += 0.0137f) {
+        v4sf level = { db, db + 3.1f, db - 7.3f, db + 11.9f };
+        v4sf gr = gain_computer_lookup_v4(&gc, level, threshold);
+        for (int k = 0; k < 4; ++k) {
+            same &= gr[k] == gain_computer_lookup(&gc, level[k], threshold[k]);
+        }
+    }
+    ok &= check("gain computer vettoriale", same);
+
+    // --- Band dynamics: blocco intero contro blocchi spezzati ---
+    static const float freq[MULTIBAND_MAX_CROSSOVERS] = { 150.0f, 800.0f, 4000.0f };
+    Crossover xo;
+    crossover_init(&xo);
+    crossover_configure(&xo, 4, freq, SAMPLERATE);
+    srand(1);
+    for (int i = 0; i < N; ++i) {
+        in_M[i] = (float)rand() / (float)RAND_MAX * 2.0f - 1.0f;
+        in_S[i] = 0.0f;
+    }
+    stage_crossover(&xo, in_M, in_S, bands_M, bands_S, N);
+
+    const v4sf band_threshold = { -30.0f, -24.0f, -18.0f, -12.0f };
+    const BandDetector det = { &gc, band_threshold, 1.5f, 0.01f, 0.001f, 0.02f };
+    BandDynamics d;
+    band_dynamics_reset(&d);
+    stage_band_dynamics(&d, bands_M, whole, N, &det);
+    band_dynamics_reset(&d);
+    for (int i = 0; i < N; i += SPLIT) {
+        uint32_t n = (N - i < SPLIT) ? N - i : SPLIT;
+        stage_band_dynamics(&d, bands_M + i, parts + i, n, &det);
+    }
+    ok &= check("band dynamics a blocchi", !memcmp(whole, parts, sizeof(whole)));
+
+    // Ogni banda sopra la sua soglia deve essere compressa: guadagno sotto il make-up
+    bool reduced = true;
+    for (int k = 0; k < 4; ++k) reduced &= d.gain[k] < 1.5f;
+    ok &= check("riduzione su ogni banda", reduced);
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+// Verifica della precisione dei filtri (gla3a_precision.h), compilata con GLA3A_PRECISION_MIXED
+// Un passa-alto Butterworth a 20 Hz a 192 kHz (poli a un passo da 1) nel BiquadBank, alla sua
+// frequenza di taglio, dove l'ampiezza teorica è esattamente -3.01 dB:
+//  - con coefficienti e stati double e segnale float l'ampiezza è quella teorica
+//  - lo stesso filtro tutto in float (gli stessi passi di biquad_process()) se ne allontana:
+//    la verifica distingue le due precisioni
+//  - a riposo gli stati double arrivano a zero esatto con il flush di fine blocco
+
+#include "../gla3a_biquad_bank.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLERATE 192000.0
+#define CUTOFF_HZ 20.0
+#define PERIOD 9600                // Campioni per periodo a CUTOFF_HZ
+#define SETTLE (20 * PERIOD)       // Transitorio del filtro (costante di tempo ~11 ms)
+#define N (SETTLE + 4 * PERIOD)    // Misura su un numero intero di periodi
+#define CUTOFF_DB (-3.0103)        // 20*log10(Q) con Q = 1/sqrt(2)
+#define MIXED_TOLERANCE_DB 0.001
+#define FLOAT_MIN_ERROR_DB 0.01
+
+static float in[N], out_mixed[N], out_float[N];
+
+static bool check(const char* name, bool ok) {
+    printf("  %-44s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+// RMS (dB) dell'uscita rispetto all'ingresso, dopo il transitorio
+static double gain_db(const float* x, const float* y) {
+    double sum_x = 0.0, sum_y = 0.0;
+    for (int i = SETTLE; i < N; ++i) {
+        sum_x += (double)x[i] * x[i];
+        sum_y += (double)y[i] * y[i];
+    }
+    return 10.0 * log10(sum_y / sum_x);
+}
+
+int main() {
+    bool ok = true;
+    printf("precision: passa-alto a %.0f Hz a %.0f Hz, %s\n", CUTOFF_HZ, SAMPLERATE, GLA3A_PRECISION_NAME);
+
+    // Coefficienti RBJ in double, come calculate_biquad_coeffs() con FilterReal = double
+    const double omega = 2.0 * M_PI * CUTOFF_HZ / SAMPLERATE;
+    const double alpha = sin(omega) * M_SQRT1_2;
+    const double a0 = 1.0 + alpha;
+    const double b0 = (1.0 + cos(omega)) / 2.0 / a0;
+    const double b1 = -(1.0 + cos(omega)) / a0;
+    const double a1 = -2.0 * cos(omega) / a0;
+    const double a2 = (1.0 - alpha) / a0;
+    for (int i = 0; i < N; ++i) in[i] = (float)sin(omega * i);
+
+    // --- Coefficienti e stati double, segnale float ---
+    BiquadBank bank;
+    biquad_bank_init(&bank, 1);
+    biquad_bank_set_stage(&bank, 0, b0, b1, b0, a1, a2);
+    memcpy(out_mixed, in, sizeof(in));
+    biquad_bank_process_mono(&bank, out_mixed, N);
+    const double mixed_error = fabs(gain_db(in, out_mixed) - CUTOFF_DB);
+
+    // --- Tutto in float ---
+    const float fb0 = (float)b0, fb1 = (float)b1, fa1 = (float)a1, fa2 = (float)a2;
+    float z1 = 0.0f, z2 = 0.0f;
+    for (int i = 0; i < N; ++i) {
+        float y = in[i] * fb0 + z1;
+        z1 = in[i] * fb1 + z2 - fa1 * y;
+        z2 = in[i] * fb0 - fa2 * y;
+        out_float[i] = y;
+    }
+    const double float_error = fabs(gain_db(in, out_float) - CUTOFF_DB);
+
+    char name[96];
+    snprintf(name, sizeof(name), "%s al taglio: scarto %.2g dB", GLA3A_PRECISION_NAME, mixed_error);
+    ok &= check(name, mixed_error < MIXED_TOLERANCE_DB);
+    snprintf(name, sizeof(name), "float al taglio: scarto %.2g dB", float_error);
+    ok &= check(name, float_error > FLOAT_MIN_ERROR_DB);
+
+    // --- Riposo ---
+    memset(out_mixed, 0, sizeof(out_mixed));
+    for (int b = 0; b < 64 && !biquad_bank_is_silent(&bank); ++b) {
+        biquad_bank_process_mono(&bank, out_mixed, N);
+        biquad_bank_flush_denormals(&bank);
+    }
+    ok &= check("stati a riposo a zero", biquad_bank_is_silent(&bank));
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
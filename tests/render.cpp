@@ -0,0 +1,175 @@
+// Verifica del render offline a chunk (tools/gla3a_render.h)
+// Un file WAV temporaneo passa nel render a chunk paralleli e in quello in un solo passo:
+//  - con il warm-up di default le giunzioni non si vedono (scarto entro la tolleranza di gla3a-render)
+//    per banda singola, Limit e multibanda
+//  - senza warm-up lo scarto alle giunzioni è evidente: la verifica distingue i due casi
+//  - la compensazione della latenza allinea l'uscita all'ingresso (campione per campione con l'uscita
+//    non compensata, spostata della latenza)
+//  - i campioni PCM 24 bit negativi si leggono con il segno
+
+#include "../tools/gla3a_render.h"
+#include "../tools/gla3a_signals.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define SECONDS 12
+#define FRAMES ((uint32_t)(SECONDS * SAMPLERATE))
+#define CHUNK_SECONDS 2.0
+#define THREADS 4
+#define TOLERANCE 1e-5
+#define MIN_SEAM_ERROR 1e-3
+
+typedef struct {
+    const char* name;
+    GLA3A_PortIndex port;
+    float value;
+} RenderConfig;
+
+static const RenderConfig configs[] = {
+    { "banda singola", GLA3A_PEAK_REDUCTION, 0.6f },
+    { "limit",         GLA3A_RATIO_MODE,     GLA3A_RATIO_LIMIT },
+    { "3 bande",       GLA3A_BANDS,          3.0f },
+};
+
+static float sig_l[FRAMES], sig_r[FRAMES];
+static float tmp_l[FRAMES], tmp_r[FRAMES];
+
+static bool check(const char* name, bool ok) {
+    printf("  %-44s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+// WAV PCM 24 bit stereo: metà batteria, metà rumore rosa (transienti e livello costante ai chunk)
+static bool write_input(const char* path) {
+    generate_signal(SIGNAL_DRUMS, SAMPLERATE, sig_l, sig_r, FRAMES / 2);
+    generate_signal(SIGNAL_PINK, SAMPLERATE, sig_l + FRAMES / 2, sig_r + FRAMES / 2, FRAMES - FRAMES / 2);
+
+    const uint32_t data_size = FRAMES * 6;
+    uint8_t header[44];
+    memcpy(header, "RIFF", 4);
+    write_le32(header + 4, 36 + data_size);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    write_le32(header + 16, 16);
+    write_le16(header + 20, WAV_FORMAT_PCM);
+    write_le16(header + 22, 2);
+    write_le32(header + 24, (uint32_t)SAMPLERATE);
+    write_le32(header + 28, (uint32_t)SAMPLERATE * 6);
+    write_le16(header + 32, 6);
+    write_le16(header + 34, 24);
+    memcpy(header + 36, "data", 4);
+    write_le32(header + 40, data_size);
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fwrite(header, 1, sizeof(header), f);
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        const float v[2] = { sig_l[i], sig_r[i] };
+        for (int c = 0; c < 2; ++c) {
+            const float x = (v[c] > 0.99f) ? 0.99f : (v[c] < -0.99f ? -0.99f : v[c]);
+            const int32_t q = (int32_t)lrintf(x * 8388608.0f);
+            const uint8_t b[3] = { (uint8_t)(q & 0xFF), (uint8_t)((q >> 8) & 0xFF), (uint8_t)((q >> 16) & 0xFF) };
+            fwrite(b, 1, 3, f);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool render(const char* in_path, const char* out_path, const RenderOptions* opts, RenderVerify* v) {
+    char error[256] = "";
+    AudioFile in, out;
+    out.map = NULL;
+    out.fd = -1;
+    bool ok = audio_open_input(&in, in_path, SAMPLERATE, 2, error, sizeof(error)) &&
+              audio_create_output(&out, out_path, &in, error, sizeof(error)) &&
+              render_file(&in, &out, opts) &&
+              (!v || render_verify(&in, &out, opts, v));
+    if (!ok) printf("  %s\n", error);
+    audio_close(&out);
+    audio_close(&in);
+    return ok;
+}
+
+static bool read_output(const char* path, float* l, float* r) {
+    char error[256];
+    AudioFile out;
+    const bool ok = audio_open_input(&out, path, SAMPLERATE, 2, error, sizeof(error)) && out.frames == FRAMES;
+    if (ok) audio_read(&out, 0, FRAMES, l, r);
+    audio_close(&out);
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    char in_path[] = "/tmp/gla3a_render_in_XXXXXX.wav";
+    char out_path[] = "/tmp/gla3a_render_out_XXXXXX.wav";
+    int fd_in = mkstemps(in_path, 4);
+    int fd_out = mkstemps(out_path, 4);
+    if (fd_in < 0 || fd_out < 0) return 1;
+    close(fd_in);
+    close(fd_out);
+    printf("render: %d s a %.0f Hz, chunk da %.0f s su %d thread\n", SECONDS, SAMPLERATE, CHUNK_SECONDS, THREADS);
+
+    ok &= check("scrittura dell'ingresso", write_input(in_path));
+
+    // --- Lettura PCM 24 bit ---
+    {
+        char error[256];
+        AudioFile in;
+        bool same = audio_open_input(&in, in_path, SAMPLERATE, 2, error, sizeof(error)) && in.frames == FRAMES;
+        if (same) audio_read(&in, 0, FRAMES, tmp_l, tmp_r);
+        for (uint32_t i = 0; i < FRAMES && same; ++i) {
+            const float l = (sig_l[i] > 0.99f) ? 0.99f : (sig_l[i] < -0.99f ? -0.99f : sig_l[i]);
+            const float r = (sig_r[i] > 0.99f) ? 0.99f : (sig_r[i] < -0.99f ? -0.99f : sig_r[i]);
+            same = fabsf(tmp_l[i] - l) < 1e-6f && fabsf(tmp_r[i] - r) < 1e-6f;
+        }
+        audio_close(&in);
+        ok &= check("lettura PCM 24 bit", same);
+    }
+
+    // --- Giunzioni dei chunk ---
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); ++c) {
+        RenderOptions opts;
+        render_options_init(&opts, SAMPLERATE);
+        opts.chunk_frames = (uint64_t)(CHUNK_SECONDS * SAMPLERATE);
+        opts.threads = THREADS;
+        opts.set[configs[c].port] = true;
+        opts.values[configs[c].port] = configs[c].value;
+
+        RenderVerify v;
+        char name[96];
+        const bool rendered = render(in_path, out_path, &opts, &v);
+        snprintf(name, sizeof(name), "%s: scarto %.2g", configs[c].name, v.max_error);
+        ok &= check(name, rendered && v.max_error <= TOLERANCE);
+
+        opts.warmup_frames = 0;
+        const bool cold = render(in_path, out_path, &opts, &v);
+        snprintf(name, sizeof(name), "%s senza warm-up: giunzioni %.2g", configs[c].name, v.max_seam_error);
+        ok &= check(name, cold && v.max_seam_error > MIN_SEAM_ERROR);
+    }
+
+    // --- Compensazione della latenza ---
+    {
+        RenderOptions opts;
+        render_options_init(&opts, SAMPLERATE);
+        opts.chunk_frames = 0;
+        const uint32_t latency = render_latency(&opts, SAMPLERATE);
+
+        bool aligned = latency > 0 && render(in_path, out_path, &opts, NULL) && read_output(out_path, tmp_l, tmp_r);
+        opts.compensate_latency = false;
+        aligned = aligned && render(in_path, out_path, &opts, NULL) && read_output(out_path, sig_l, sig_r); // Il segnale non serve più
+        for (uint32_t i = 0; i + latency < FRAMES && aligned; ++i) {
+            aligned = tmp_l[i] == sig_l[i + latency] && tmp_r[i] == sig_r[i + latency];
+        }
+        char name[96];
+        snprintf(name, sizeof(name), "latenza compensata (%u campioni)", latency);
+        ok &= check(name, aligned);
+    }
+
+    unlink(in_path);
+    unlink(out_path);
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+// Verifica degli stadi di gla3a_stages.h, ognuno preso da solo
+//  - encode/decode M/S: andata e ritorno senza perdita (a meno dell'arrotondamento)
+//  - envelope e gain smooth: spezzare il blocco non cambia un bit (lo stato passa tra i blocchi)
+//  - gain computer: make-up invariato sotto soglia, curva soft-knee sopra
+//  - collegamento stereo: con due canali uguali il detector collegato è quello di un canale;
+//    il misto va da scollegato (amount 0) a collegato (amount 1)
+//  - clip: uscita mai oltre il fondo scala
+//  - denormali: un envelope a riposo arriva a zero esatto; FTZ/DAZ solo dentro la guardia
+
+#include "../gla3a_stages.h"
+#include "../gla3a_denormal.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N 4096
+#define SPLIT 37 // Blocchi irregolari per provare il passaggio di stato
+
+static float in_l[N], in_r[N], buf_M[N], buf_S[N], out_l[N], out_r[N];
+static float whole[N];
+static DetectorReal sc_whole[N], sc_parts[N], sc_M[N], sc_S[N]; // Segnale del detector (gla3a_precision.h)
+
+static float noise() {
+    return (float)rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+static bool check(const char* name, bool ok) {
+    printf("  %-28s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    srand(1);
+    for (int i = 0; i < N; ++i) {
+        in_l[i] = noise();
+        in_r[i] = noise();
+    }
+    printf("stages: %d campioni\n", N);
+
+    // --- Encode/Decode ---
+    float max_err = 0.0f;
+    stage_encode(in_l, in_r, buf_M, buf_S, N, true);
+    stage_decode(buf_M, buf_S, out_l, out_r, N, true);
+    for (int i = 0; i < N; ++i) {
+        max_err = fmaxf(max_err, fmaxf(fabsf(out_l[i] - in_l[i]), fabsf(out_r[i] - in_r[i])));
+    }
+    ok &= check("encode/decode M/S", max_err < 1e-6f);
+
+    stage_encode(in_l, in_r, buf_M, buf_S, N, false);
+    stage_decode(buf_M, buf_S, out_l, out_r, N, false);
+    ok &= check("encode/decode L/R", !memcmp(out_l, in_l, sizeof(in_l)) && !memcmp(out_r, in_r, sizeof(in_r)));
+
+    // --- Envelope: blocco intero contro blocchi spezzati ---
+    stage_rectify(in_l, sc_whole, N);
+    memcpy(sc_parts, sc_whole, sizeof(sc_whole));
+    FilterReal env = 0.0f;
+    stage_envelope(sc_whole, N, &env, 0.01f, 0.001f);
+    env = 0.0f;
+    for (int i = 0; i < N; i += SPLIT) {
+        uint32_t n = (N - i < SPLIT) ? N - i : SPLIT;
+        stage_envelope(sc_parts + i, n, &env, 0.01f, 0.001f);
+    }
+    ok &= check("envelope a blocchi", !memcmp(sc_whole, sc_parts, sizeof(sc_whole)));
+
+    // --- Gain smooth: stesso controllo ---
+    memcpy(sc_parts, sc_whole, sizeof(sc_whole));
+    FilterReal gain = 1.0f;
+    stage_gain_smooth(sc_whole, N, &gain, 0.02f);
+    gain = 1.0f;
+    for (int i = 0; i < N; i += SPLIT) {
+        uint32_t n = (N - i < SPLIT) ? N - i : SPLIT;
+        stage_gain_smooth(sc_parts + i, n, &gain, 0.02f);
+    }
+    ok &= check("gain smooth a blocchi", !memcmp(sc_whole, sc_parts, sizeof(sc_whole)));
+
+    // --- Gain computer ---
+    GainComputer gc;
+    gain_computer_init(&gc);
+    gain_computer_update(&gc, 4.0f, 10.0f);
+    const float threshold_db = -30.0f;
+    const float make_up = 2.0f;
+    bool below_ok = true;
+    float max_curve_err = 0.0f;
+    for (float db = -80.0f; db < 0.0f; db += 0.01f) {
+        DetectorReal g = db_to_linear(db);
+        stage_gain_computer(&g, 1, &gc, threshold_db, make_up);
+        if (db <= threshold_db && g != make_up) below_ok = false;
+        float expected = -gain_computer_curve(db - threshold_db, 4.0f, 10.0f);
+        max_curve_err = fmaxf(max_curve_err, fabsf(to_db((float)(g / make_up)) - expected));
+    }
+    ok &= check("gain computer sotto soglia", below_ok);
+    ok &= check("gain computer sopra soglia", max_curve_err < 0.01f);
+
+    // --- Collegamento Stereo ---
+    stage_rectify(in_l, sc_whole, N);
+    stage_rectify_linked(in_l, in_l, sc_parts, N, false);
+    bool linked_ok = !memcmp(sc_whole, sc_parts, sizeof(sc_whole));
+    stage_rectify_linked(in_l, in_l, sc_parts, N, true);
+    linked_ok &= !memcmp(sc_whole, sc_parts, sizeof(sc_whole));
+    ok &= check("detector collegato, mono", linked_ok);
+
+    stage_rectify(in_l, sc_M, N);
+    stage_rectify(in_r, sc_S, N);
+    memcpy(sc_whole, sc_M, sizeof(sc_whole));
+    memcpy(sc_parts, sc_S, sizeof(sc_parts));
+    stage_link_blend(sc_whole, sc_parts, N, 0.0f, false);
+    bool blend_ok = !memcmp(sc_whole, sc_M, sizeof(sc_whole)) && !memcmp(sc_parts, sc_S, sizeof(sc_parts));
+    stage_link_blend(sc_M, sc_S, N, 1.0f, false);
+    for (int i = 0; i < N; ++i) {
+        blend_ok &= sc_M[i] == sc_S[i] && sc_M[i] == real_max(sc_whole[i], sc_parts[i]);
+    }
+    ok &= check("misto: estremi", blend_ok);
+
+    // --- Clip ---
+    for (int i = 0; i < N; ++i) whole[i] = in_l[i] * 10.0f;
+    stage_clip(whole, N, db_to_linear(-1.0f), 0.5f);
+    float peak = 0.0f;
+    for (int i = 0; i < N; ++i) peak = fmaxf(peak, fabsf(whole[i]));
+    ok &= check("clip entro il fondo scala", peak <= 1.0f);
+
+    // --- Denormali ---
+    // Senza flush il rilascio si ferma sul denormale più piccolo (x * (1 - alpha) si arrotonda a x)
+    FilterReal idle_env = 1.0f;
+    for (int b = 0; b < 64; ++b) {
+        memset(sc_M, 0, sizeof(sc_M)); // stage_envelope scrive l'envelope sul posto
+        stage_envelope(sc_M, N, &idle_env, 0.01f, 0.001f);
+        idle_env = flush_denormal(idle_env);
+    }
+    ok &= check("envelope a riposo a zero", idle_env == 0.0f);
+
+#if GLA3A_DENORMAL_GUARD && (defined(__SSE__) || defined(__x86_64__) || defined(__aarch64__))
+    // Prodotti su volatile: il compilatore non li sposta fuori dalla guardia
+    volatile float tiny = 1e-39f; // Denormale
+    volatile float inside, outside;
+    DenormalGuard guard;
+    denormal_guard_enter(&guard);
+    inside = tiny * 3.0f;
+    denormal_guard_leave(&guard);
+    outside = tiny * 3.0f;
+    const bool flushed = (inside == 0.0f);
+    const bool restored = (outside != 0.0f);
+    ok &= check("FTZ/DAZ solo nella guardia", flushed && restored);
+#endif
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
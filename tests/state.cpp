@@ -0,0 +1,269 @@
+// Verifica dello stato e del banco di preset (state:interface, patch:Set su preset/presetStore)
+// Un'istanza con il worker di tools/gla3a_host.h contro un riferimento senza worker che riceve gli
+// stessi valori come patch:Set (i cambi costosi un blocco dopo, quando il worker li consegna):
+//  - uno slot salvato con presetStore e richiamato a metà blocco vale dal campione dell'evento,
+//    senza richieste al worker, anche con una richiesta ancora in volo (il suo progetto, superato,
+//    non si applica quando arriva)
+//  - lo stato salvato e ripristinato in un'istanza che sta già elaborando porta parametri e banco:
+//    uscita identica, nessuna richiesta al worker, e un secondo save dà lo stesso stato
+//  - lo stato ripristinato tra instantiate e activate (l'ordine abituale degli host) vale dalla
+//    prima run, anche se le porte di controllo hanno altri valori, finché l'host non le muove
+//  - un numero di slot fuori dal banco (negativo dopo l'arrotondamento, oltre l'ultimo, NaN) non
+//    richiama né salva nulla
+
+#include "../gla3a_svf.h"
+#include "../tools/gla3a_host.h"
+#include "../tools/gla3a_signals.h"
+#include <lv2/state/state.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define BLOCK 256
+#define NUM_BLOCKS 40
+#define FRAMES (NUM_BLOCKS * BLOCK)
+#define SLOT 2
+#define MAX_SETTINGS 8
+#define STATE_MAX_ENTRIES 64
+#define STATE_VALUE_CAPACITY 2048
+
+typedef struct {
+    GLA3A_PortIndex port;
+    float value;
+    bool costly; // Progettato nel worker: sull'istanza con il worker vale dal blocco successivo
+} Setting;
+
+// Il taglio della sidechain passa dal worker solo con i biquad (gla3a_svf.h)
+#define SC_COSTLY (GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_BIQUAD)
+
+// Una scena (V) e la successiva (W); port 0 con value 0 chiude la lista
+static const Setting scene_v[MAX_SETTINGS] = {
+    { GLA3A_PEAK_REDUCTION, 0.7f, false }, { GLA3A_SC_HP_ON, 1.0f, false },
+    { GLA3A_RATIO_MODE, GLA3A_RATIO_9_TO_1, true }, { GLA3A_SC_HP_FREQ, 300.0f, SC_COSTLY },
+    { GLA3A_BANDS, 3.0f, true }, { GLA3A_CROSSOVER_1, 250.0f, true },
+};
+static const Setting scene_w[MAX_SETTINGS] = {
+    { GLA3A_PEAK_REDUCTION, 0.3f, false }, { GLA3A_RATIO_MODE, GLA3A_RATIO_3_TO_1, true },
+    { GLA3A_SC_HP_FREQ, 150.0f, SC_COSTLY }, { GLA3A_BANDS, 1.0f, true },
+};
+
+// --- Stato dell'Host ---
+
+typedef struct {
+    uint32_t key;
+    uint32_t type;
+    uint32_t flags;
+    size_t size;
+    uint8_t data[STATE_VALUE_CAPACITY];
+} StateEntry;
+
+typedef struct {
+    StateEntry entries[STATE_MAX_ENTRIES];
+    uint32_t count;
+} StateStore;
+
+static LV2_State_Status state_store(LV2_State_Handle handle, uint32_t key, const void* value, size_t size,
+                                    uint32_t type, uint32_t flags) {
+    StateStore* st = (StateStore*)handle;
+    if (st->count == STATE_MAX_ENTRIES || size > STATE_VALUE_CAPACITY) return LV2_STATE_ERR_NO_SPACE;
+    StateEntry* e = &st->entries[st->count++];
+    e->key = key;
+    e->type = type;
+    e->flags = flags;
+    e->size = size;
+    memcpy(e->data, value, size);
+    return LV2_STATE_SUCCESS;
+}
+
+static const void* state_retrieve(LV2_State_Handle handle, uint32_t key, size_t* size, uint32_t* type, uint32_t* flags) {
+    StateStore* st = (StateStore*)handle;
+    for (uint32_t i = 0; i < st->count; ++i) {
+        if (st->entries[i].key != key) continue;
+        *size = st->entries[i].size;
+        *type = st->entries[i].type;
+        *flags = st->entries[i].flags;
+        return st->entries[i].data;
+    }
+    return NULL;
+}
+
+static bool same_state(const StateStore* a, const StateStore* b) {
+    if (a->count != b->count) return false;
+    for (uint32_t i = 0; i < a->count; ++i) {
+        const StateEntry* x = &a->entries[i];
+        const StateEntry* y = &b->entries[i];
+        if (x->key != y->key || x->type != y->type || x->flags != y->flags || x->size != y->size ||
+            memcmp(x->data, y->data, x->size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static float in_l[FRAMES], in_r[FRAMES];
+static float out_l[FRAMES], out_r[FRAMES];
+static float ref_l[FRAMES], ref_r[FRAMES];
+static MiniHost host, reference;
+static HostWorker worker;
+static StateStore saved, saved_again, before_slot, after_slot;
+
+static bool check(const char* name, bool ok) {
+    printf("  %-44s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+// Accoda i patch:Set di una scena: tutti (costly < 0), solo i costosi (1) o solo gli economici (0)
+static void send_scene(MiniHost* h, uint32_t frame, const Setting* scene, int costly) {
+    for (int i = 0; i < MAX_SETTINGS && (scene[i].port || scene[i].value); ++i) {
+        if (costly < 0 || scene[i].costly == (costly > 0)) host_set_param(h, frame, scene[i].port, scene[i].value);
+    }
+}
+
+static void run_block(uint32_t b) {
+    const uint32_t offset = b * BLOCK;
+    host_connect_audio(&host, in_l + offset, in_r + offset, out_l + offset, out_r + offset);
+    host_connect_audio(&reference, in_l + offset, in_r + offset, ref_l + offset, ref_r + offset);
+    host_run(&host, BLOCK);
+    host_run(&reference, BLOCK);
+}
+
+static bool same_output() {
+    const size_t bytes = FRAMES * sizeof(float);
+    return !memcmp(out_l, ref_l, bytes) && !memcmp(out_r, ref_r, bytes);
+}
+
+static bool open_pair() {
+    host_worker_init(&worker);
+    if (!host_open_with_schedule(&host, SAMPLERATE, BLOCK, &worker.schedule) || !host_open(&reference, SAMPLERATE, BLOCK)) {
+        return false;
+    }
+    host_activate(&host);
+    host_activate(&reference);
+    return true;
+}
+
+int main() {
+    bool ok = true;
+    printf("state: %d blocchi da %d a %.0f Hz, slot %d\n", NUM_BLOCKS, BLOCK, SAMPLERATE, SLOT);
+    generate_signal(SIGNAL_DRUMS, SAMPLERATE, in_l, in_r, FRAMES);
+    if (!open_pair()) return 1;
+
+    const LV2_State_Interface* state =
+        (const LV2_State_Interface*)host.descriptor->extension_data(LV2_STATE__interface);
+    ok &= check("state:interface", state && state->save && state->restore);
+    if (!state) return 1;
+
+    // --- Salvataggio e richiamo di uno slot ---
+    const uint32_t recall_frame = 100;
+    uint32_t requests_at_recall = 0;
+    for (uint32_t b = 0; b < NUM_BLOCKS; ++b) {
+        if (b == 10) {
+            send_scene(&host, 0, scene_v, -1);
+            send_scene(&reference, 0, scene_v, 0);
+        }
+        if (b == 11) send_scene(&reference, 0, scene_v, 1);
+        if (b == 12) host_set_property(&host, 0, GLA3A_PRESET_STORE_URI, SLOT);
+        if (b == 20) {
+            send_scene(&host, 0, scene_w, -1); // Il progetto di W resta nel worker fino al blocco 30
+            send_scene(&reference, 0, scene_w, 0);
+        }
+        if (b == 21) {
+            host_set_property(&host, recall_frame, GLA3A_PRESET_URI, SLOT);
+            send_scene(&reference, recall_frame, scene_v, 0); // I coefficienti di V non sono mai cambiati
+            requests_at_recall = worker.total_requests;
+        }
+        run_block(b);
+        if (b < 20 || b >= 30) host_worker_deliver(&worker, &host);
+    }
+    ok &= check("richiamo a campione preciso", same_output());
+    ok &= check("nessuna richiesta dopo il richiamo", worker.total_requests == requests_at_recall);
+    ok &= check("richieste: scena V, presetStore, scena W", worker.total_requests == 3);
+
+    const LV2_State_Status saved_status = state->save(host.instance, state_store, &saved, 0, NULL);
+    bool pod = saved.count > 0;
+    for (uint32_t i = 0; i < saved.count; ++i) {
+        pod &= (saved.entries[i].flags & (LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE)) == (LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE);
+    }
+    ok &= check("save", saved_status == LV2_STATE_SUCCESS && pod);
+    host_close(&host);
+    host_close(&reference);
+
+    // --- Restore su un'istanza che sta già elaborando ---
+    // Il riferimento riceve V al blocco del restore, poi W; poi lo slot torna: è quello salvato
+    if (!open_pair()) return 1;
+    const uint32_t restore_block = 5;
+    bool restored = true;
+    uint32_t requests_after_restore = 0;
+    for (uint32_t b = 0; b < NUM_BLOCKS; ++b) {
+        if (b == restore_block) {
+            restored &= state->restore(host.instance, state_retrieve, &saved, 0, NULL) == LV2_STATE_SUCCESS;
+            restored &= state->save(host.instance, state_store, &saved_again, 0, NULL) == LV2_STATE_SUCCESS;
+            send_scene(&reference, 0, scene_v, -1);
+        }
+        if (b == 15) {
+            send_scene(&host, 0, scene_w, -1);
+            send_scene(&reference, 0, scene_w, 0);
+        }
+        if (b == 16) send_scene(&reference, 0, scene_w, 1);
+        if (b == 25) {
+            host_set_property(&host, recall_frame, GLA3A_PRESET_URI, SLOT);
+            send_scene(&reference, recall_frame, scene_v, -1);
+        }
+        run_block(b);
+        if (b == restore_block) requests_after_restore = worker.total_requests;
+        host_worker_deliver(&worker, &host);
+    }
+    ok &= check("restore", restored);
+    ok &= check("stato identico al secondo save", same_state(&saved, &saved_again));
+    ok &= check("nessuna richiesta per il restore", requests_after_restore == 0);
+    ok &= check("uscita dopo il restore e slot ripristinato", same_output());
+
+    host_close(&host);
+    host_close(&reference);
+
+    // --- Restore prima di activate: instantiate → restore → activate → run ---
+    // Le porte restano ai valori di tools/gla3a_host.h; al blocco 20 l'host muove Peak Reduction
+    host_worker_init(&worker);
+    if (!host_open_with_schedule(&host, SAMPLERATE, BLOCK, &worker.schedule) || !host_open(&reference, SAMPLERATE, BLOCK)) {
+        return 1;
+    }
+    restored = state->restore(host.instance, state_retrieve, &saved, 0, NULL) == LV2_STATE_SUCCESS;
+    host_activate(&host);
+    host_activate(&reference);
+    send_scene(&reference, 0, scene_v, -1);
+    for (uint32_t b = 0; b < NUM_BLOCKS; ++b) {
+        if (b == 20) host.controls[GLA3A_PEAK_REDUCTION] = reference.controls[GLA3A_PEAK_REDUCTION] = 0.4f;
+        run_block(b);
+        host_worker_deliver(&worker, &host);
+    }
+    ok &= check("restore prima di activate", restored);
+    ok &= check("valori ripristinati dalla prima run", same_output());
+    ok &= check("nessuna richiesta per il restore", worker.total_requests == 0);
+
+    host_close(&host);
+    host_close(&reference);
+
+    // --- Numeri di slot fuori dal banco ---
+    if (!host_open(&host, SAMPLERATE, BLOCK)) return 1;
+    host_activate(&host);
+    host_connect_audio(&host, in_l, in_r, out_l, out_r);
+    host_run(&host, BLOCK);
+    state->save(host.instance, state_store, &before_slot, 0, NULL);
+    static const float outside[] = { -0.6f, -1.0f, GLA3A_NUM_PRESETS - 0.4f, 1e30f, NAN };
+    for (size_t i = 0; i < sizeof(outside) / sizeof(outside[0]); ++i) {
+        host_set_property(&host, 0, GLA3A_PRESET_STORE_URI, outside[i]);
+        host_set_property(&host, 0, GLA3A_PRESET_URI, outside[i]);
+    }
+    host_run(&host, BLOCK);
+    state->save(host.instance, state_store, &after_slot, 0, NULL);
+    ok &= check("slot fuori dal banco ignorati", same_state(&before_slot, &after_slot));
+    host_set_property(&host, 0, GLA3A_PRESET_URI, 0.4f);
+    host_run(&host, BLOCK);
+    after_slot.count = 0;
+    state->save(host.instance, state_store, &after_slot, 0, NULL);
+    ok &= check("slot 0.4 richiama lo slot 0", !same_state(&before_slot, &after_slot));
+    host_close(&host);
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+// Verifica dei filtri SVF TPT della sidechain (gla3a_svf.h)
+//  - svf_tan() contro la tan() della libm fino al taglio massimo
+//  - a taglio fermo la cascata ha la risposta dei biquad RBJ (in double) con lo stesso taglio e Q
+//  - uno sweep automatizzato non fa click né diverge: con ingresso costante il LowPass resta sul
+//    valore dell'ingresso mentre taglio e Q saltano a ogni blocco da un estremo all'altro, e con
+//    rumore l'uscita resta limitata
+//  - il glide arriva esattamente al target, nel tempo atteso, e da lì i coefficienti sono quelli di
+//    un banco fermo sul target
+//  - LowPass e HighPass in un passo solo (svf_bank_process_chain) a blocchi di lunghezze diverse
+//    danno, durante il glide, la stessa uscita e lo stesso stato del percorso generico su tutto il
+//    segnale, stereo e su un canale solo
+
+#include "../gla3a_svf.h"
+#include "../tools/gla3a_signals.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define N 16384
+#define NUM_STAGES 3
+#define SWEEP_BLOCK 64
+#define TAN_TOLERANCE 1e-5   // Il taglio sbaglia dello stesso ordine: 0.2 Hz a 20 kHz
+#define RESPONSE_TOLERANCE 1e-4 // Scarto massimo dal riferimento double, rispetto al picco
+#define DC_TOLERANCE 1e-5
+#define NOISE_BOUND 100.0f
+#define GLIDE_MARGIN 1.01
+
+static const uint32_t block_lengths[] = { 1, 37, 256, 61, 1024, 5 };
+#define NUM_BLOCK_LENGTHS (sizeof(block_lengths) / sizeof(block_lengths[0]))
+
+static float in_l[N], in_r[N];
+static DetectorReal buf_M[2][N], buf_S[2][N];
+
+static bool check(const char* name, bool ok) {
+    printf("  %-44s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+static bool same_vreal(vreal a, vreal b) {
+    return !memcmp(&a, &b, sizeof(vreal));
+}
+
+static void bank_at(SvfBank* bank, float freq_hz, float q_val) {
+    svf_bank_init(bank, NUM_STAGES, SAMPLERATE);
+    svf_bank_set_target(bank, freq_hz, q_val, SAMPLERATE);
+}
+
+// --- tan() ---
+
+static bool tan_accurate(void) {
+    double worst = 0.0;
+    for (int i = 1; i <= 10000; ++i) {
+        const FilterReal x = (FilterReal)(M_PI * SVF_MAX_CUTOFF * i / 10000);
+        const double err = fabs(svf_tan(x) / tan((double)x) - 1.0);
+        if (err > worst) worst = err;
+    }
+    printf("  svf_tan errore relativo max %.3e\n", worst);
+    return worst < TAN_TOLERANCE;
+}
+
+// --- Risposta a Taglio Fermo ---
+
+// Cascata RBJ in double (calculate_biquad_coeffs() con FilterReal = double) sul rumore di in_l
+static void rbj_reference(double* out, double freq_hz, double q_val, int type) {
+    const double omega = 2.0 * M_PI * freq_hz / SAMPLERATE;
+    const double alpha = sin(omega) / (2.0 * q_val);
+    const double c = cos(omega);
+    const double a0 = 1.0 + alpha;
+    const double b0 = ((type == SVF_LOWPASS) ? (1.0 - c) : (1.0 + c)) / 2.0 / a0;
+    const double b1 = ((type == SVF_LOWPASS) ? (1.0 - c) : -(1.0 + c)) / a0;
+    const double a1 = -2.0 * c / a0;
+    const double a2 = (1.0 - alpha) / a0;
+    double z1[NUM_STAGES] = { 0 }, z2[NUM_STAGES] = { 0 };
+    for (int i = 0; i < N; ++i) {
+        double x = in_l[i];
+        for (int k = 0; k < NUM_STAGES; ++k) {
+            const double y = x * b0 + z1[k];
+            z1[k] = x * b1 + z2[k] - a1 * y;
+            z2[k] = x * b0 - a2 * y;
+            x = y;
+        }
+        out[i] = x;
+    }
+}
+
+static bool same_response(float freq_hz, float q_val, int type) {
+    static double reference[N];
+    rbj_reference(reference, freq_hz, q_val, type);
+    SvfBank bank;
+    bank_at(&bank, freq_hz, q_val);
+    for (int i = 0; i < N; ++i) buf_M[0][i] = in_l[i];
+    if (type == SVF_LOWPASS) svf_bank_process<SVF_LOWPASS>(&bank, buf_M[0], NULL, N);
+    else                     svf_bank_process<SVF_HIGHPASS>(&bank, buf_M[0], NULL, N);
+
+    double peak = 0.0, err = 0.0;
+    for (int i = 0; i < N; ++i) {
+        peak = fmax(peak, fabs(reference[i]));
+        err = fmax(err, fabs(buf_M[0][i] - reference[i]));
+    }
+    return err <= RESPONSE_TOLERANCE * peak;
+}
+
+// --- Sweep ---
+
+// Taglio e Q da un estremo all'altro a ogni blocco di SWEEP_BLOCK campioni
+static void sweep_target(SvfBank* bank, int block) {
+    const bool high = (block & 1) != 0;
+    svf_bank_set_target(bank, high ? 20000.0f : 20.0f, (block & 2) ? 10.0f : 0.1f, SAMPLERATE);
+}
+
+static bool dc_without_clicks(void) {
+    SvfBank bank;
+    bank_at(&bank, 1000.0f, 0.707f);
+    for (int i = 0; i < N; ++i) buf_M[0][i] = 1.0f;
+    svf_bank_process<SVF_LOWPASS>(&bank, buf_M[0], NULL, N); // Arriva a regime
+
+    double worst = 0.0;
+    for (int b = 0; b < N / SWEEP_BLOCK; ++b) {
+        sweep_target(&bank, b);
+        DetectorReal* y = buf_M[0] + b * SWEEP_BLOCK;
+        for (int i = 0; i < SWEEP_BLOCK; ++i) y[i] = 1.0f;
+        svf_bank_process<SVF_LOWPASS>(&bank, y, NULL, SWEEP_BLOCK);
+        for (int i = 0; i < SWEEP_BLOCK; ++i) worst = fmax(worst, fabs(y[i] - 1.0));
+    }
+    printf("  sweep con ingresso costante: scarto max %.3e\n", worst);
+    return worst <= DC_TOLERANCE;
+}
+
+template <int TYPE>
+static bool noise_bounded(void) {
+    SvfBank bank;
+    bank_at(&bank, 1000.0f, 0.707f);
+    bool bounded = true;
+    for (int b = 0; b < N / SWEEP_BLOCK; ++b) {
+        sweep_target(&bank, b);
+        DetectorReal* y = buf_M[0] + b * SWEEP_BLOCK;
+        DetectorReal* s = buf_S[0] + b * SWEEP_BLOCK;
+        for (int i = 0; i < SWEEP_BLOCK; ++i) {
+            y[i] = in_l[b * SWEEP_BLOCK + i];
+            s[i] = in_r[b * SWEEP_BLOCK + i];
+        }
+        svf_bank_process<TYPE>(&bank, y, s, SWEEP_BLOCK);
+        for (int i = 0; i < SWEEP_BLOCK; ++i) bounded &= fabsf(y[i]) < NOISE_BOUND && fabsf(s[i]) < NOISE_BOUND;
+    }
+    return bounded;
+}
+
+// --- Glide ---
+
+static bool glide_settles(void) {
+    SvfBank bank, still;
+    bank_at(&bank, 100.0f, 0.707f);
+    bank_at(&still, 2000.0f, 4.0f);
+    svf_bank_set_target(&bank, 2000.0f, 4.0f, SAMPLERATE);
+    if (!bank.gliding) return false;
+
+    // Lo scarto relativo cala di e ogni SVF_GLIDE_SECONDS: arriva alla tolleranza in
+    // ln(scarto / tolleranza) costanti di tempo, il più lento tra w e k = 1 / Q (qui k, da 1.41 a
+    // 0.25); in float gli arrotondamenti del passo lo allungano di poco
+    const double tau = SVF_GLIDE_SECONDS * SAMPLERATE;
+    const double w_gap = (2000.0 - 100.0) / 2000.0;
+    const double k_gap = (1.0 / 0.707 - 1.0 / 4.0) / (1.0 / 4.0);
+    const double expected = tau * log(fmax(w_gap, k_gap) / SVF_SETTLE_TOLERANCE) * GLIDE_MARGIN;
+    int samples = 0;
+    for (; bank.gliding && samples < N; ++samples) {
+        buf_M[0][samples] = 0;
+        svf_bank_process<SVF_LOWPASS>(&bank, buf_M[0] + samples, NULL, 1);
+    }
+    printf("  glide 100 -> 2000 Hz, Q 0.707 -> 4: %d campioni (attesi %.0f)\n", samples, expected);
+    return samples <= expected && bank.w == still.w && bank.k == still.k &&
+           same_vreal(bank.a1, still.a1) && same_vreal(bank.a2, still.a2) && same_vreal(bank.a3, still.a3) &&
+           same_vreal(bank.hp_k, still.hp_k);
+}
+
+// --- Kernel Specializzato ---
+
+static bool same_state(const SvfBank* a, const SvfBank* b) {
+    return !memcmp(a->ic1, b->ic1, sizeof(a->ic1)) && !memcmp(a->ic2, b->ic2, sizeof(a->ic2)) &&
+           a->w == b->w && a->k == b->k && a->gliding == b->gliding;
+}
+
+// lp/hp: cascate accese; mono: un canale solo (detector collegato). I target cambiano a metà del
+// segnale, quindi il glide attraversa i confini dei blocchi.
+template <int LP, int HP>
+static bool same_chain(bool mono) {
+    SvfBank lp[2], hp[2];
+    for (int k = 0; k < 2; ++k) {
+        bank_at(&lp[k], 3000.0f, 0.707f);
+        bank_at(&hp[k], 120.0f, 0.707f);
+        for (int i = 0; i < N; ++i) {
+            buf_M[k][i] = fabsf(in_l[i]);
+            buf_S[k][i] = fabsf(in_r[i]);
+        }
+    }
+
+    // Generico: due metà, ogni cascata su tutta la metà
+    for (int half = 0; half < 2; ++half) {
+        if (half) {
+            svf_bank_set_target(&lp[0], 800.0f, 2.0f, SAMPLERATE);
+            svf_bank_set_target(&hp[0], 400.0f, 0.5f, SAMPLERATE);
+        }
+        DetectorReal* m = buf_M[0] + half * N / 2;
+        DetectorReal* s = mono ? NULL : buf_S[0] + half * N / 2;
+        if (LP) svf_bank_process<SVF_LOWPASS>(&lp[0], m, s, N / 2);
+        if (HP) svf_bank_process<SVF_HIGHPASS>(&hp[0], m, s, N / 2);
+    }
+
+    // Specializzato: blocchi di lunghezze diverse
+    for (uint32_t offset = 0, b = 0; offset < N; ++b) {
+        if (offset == N / 2) {
+            svf_bank_set_target(&lp[1], 800.0f, 2.0f, SAMPLERATE);
+            svf_bank_set_target(&hp[1], 400.0f, 0.5f, SAMPLERATE);
+        }
+        const uint32_t limit = (offset < N / 2) ? N / 2 : N;
+        uint32_t n = block_lengths[b % NUM_BLOCK_LENGTHS];
+        if (n > limit - offset) n = limit - offset;
+        svf_bank_process_chain<LP ? NUM_STAGES : 0, HP ? NUM_STAGES : 0>(
+            &lp[1], &hp[1], buf_M[1] + offset, mono ? NULL : buf_S[1] + offset, n);
+        offset += n;
+    }
+    return !memcmp(buf_M[0], buf_M[1], sizeof(buf_M[0])) && !memcmp(buf_S[0], buf_S[1], sizeof(buf_S[0])) &&
+           same_state(&lp[0], &lp[1]) && same_state(&hp[0], &hp[1]);
+}
+
+int main() {
+    bool ok = true;
+    printf("svf: %d campioni a %.0f Hz, %s\n", N, SAMPLERATE, GLA3A_PRECISION_NAME);
+    generate_signal(SIGNAL_PINK, SAMPLERATE, in_l, in_r, N);
+
+    ok &= check("tan approssimata", tan_accurate());
+    ok &= check("LowPass 3000 Hz come RBJ", same_response(3000.0f, 0.707f, SVF_LOWPASS));
+    ok &= check("LowPass 20 kHz, Q 4 come RBJ", same_response(20000.0f, 4.0f, SVF_LOWPASS));
+    ok &= check("HighPass 120 Hz come RBJ", same_response(120.0f, 0.707f, SVF_HIGHPASS));
+    ok &= check("HighPass 20 Hz, Q 0.5 come RBJ", same_response(20.0f, 0.5f, SVF_HIGHPASS));
+    ok &= check("sweep senza click (ingresso costante)", dc_without_clicks());
+    ok &= check("sweep LowPass stabile sul rumore", noise_bounded<SVF_LOWPASS>());
+    ok &= check("sweep HighPass stabile sul rumore", noise_bounded<SVF_HIGHPASS>());
+    ok &= check("glide esatto sul target", glide_settles());
+
+    char name[96];
+    for (int mono = 0; mono <= 1; ++mono) {
+        const char* channels = mono ? "un canale" : "stereo";
+        snprintf(name, sizeof(name), "catena LowPass, %s", channels);
+        ok &= check(name, same_chain<1, 0>(mono));
+        snprintf(name, sizeof(name), "catena HighPass, %s", channels);
+        ok &= check(name, same_chain<0, 1>(mono));
+        snprintf(name, sizeof(name), "catena LowPass e HighPass, %s", channels);
+        ok &= check(name, same_chain<1, 1>(mono));
+    }
+
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// Verifica del progetto dei coefficienti nel worker (work:schedule / work:interface, gla3a.cpp)
+// Un host con il worker di tools/gla3a_host.h (richieste eseguite e risposte consegnate tra una run
+// e l'altra, come fa un host vero a fine ciclo) contro un'istanza senza worker che progetta tutto
+// nel run:
+//  - con le risposte consegnate subito un cambio costoso (ratio, crossover, filtri della sidechain
+//    se sono biquad: gli SVF di gla3a_svf.h prendono il target subito) vale dal blocco successivo: l'uscita è identica al riferimento con il cambio spostato di un
+//    blocco, latenza compresa; i cambi economici restano immediati
+//  - con le risposte trattenute si elabora con i coefficienti vecchi e c'è una sola richiesta in
+//    volo: i cambi arrivati intanto partono con la richiesta successiva
+//  - dopo activate() la prima run progetta subito, senza aspettare il worker
+//  - una richiesta che non viene dal plugin è rifiutata senza risposta e non cambia l'uscita
+
+#include "../gla3a_svf.h"
+#include "../tools/gla3a_host.h"
+#include "../tools/gla3a_signals.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLERATE 48000.0
+#define BLOCK 256
+#define NUM_BLOCKS 200
+#define FRAMES (NUM_BLOCKS * BLOCK)
+
+// Cambio sull'istanza con il worker al blocco 'block'; il riferimento lo riceve a 'reference_block'
+typedef struct {
+    uint32_t block;
+    uint32_t reference_block;
+    GLA3A_PortIndex port;
+    float value;
+} Change;
+
+// Taglio della sidechain: nel worker con i biquad, economico (glide nel blocco) con gli SVF
+#if GLA3A_SIDECHAIN == GLA3A_SIDECHAIN_SVF
+#define SC_BLOCK(block, reference_block) (block)
+#define SC_REQUESTS 0
+#else
+#define SC_BLOCK(block, reference_block) (reference_block)
+#define SC_REQUESTS 2
+#endif
+
+static const Change changes[] = {
+    { 20,  21,  GLA3A_RATIO_MODE,  GLA3A_RATIO_9_TO_1 },
+    { 40,  40,  GLA3A_SC_HP_ON,    1.0f },               // Economico: subito su entrambe
+    { 40,  SC_BLOCK(40, 41),   GLA3A_SC_HP_FREQ, 400.0f },
+    { 60,  61,  GLA3A_BANDS,       3.0f },
+    { 80,  81,  GLA3A_CROSSOVER_1, 300.0f },
+    { 80,  80,  GLA3A_PEAK_REDUCTION, 0.8f },            // Economico
+    { 100, 104, GLA3A_RATIO_MODE,  GLA3A_RATIO_6_TO_1 }, // Risposte trattenute (HOLD_*)
+    { 102, SC_BLOCK(102, 105), GLA3A_SC_HP_FREQ, 250.0f }, // Biquad: parte quando arriva la prima risposta
+    { 120, 121, GLA3A_BANDS,       1.0f },
+    { 140, 141, GLA3A_RATIO_MODE,  GLA3A_RATIO_LIMIT },
+    { 170, 171, GLA3A_RATIO_MODE,  GLA3A_RATIO_3_TO_1 },
+};
+
+#define HOLD_FIRST 100 // Risposte trattenute dopo le run dei blocchi HOLD_FIRST .. HOLD_LAST - 1
+#define HOLD_LAST 103
+#define ACTIVATE_BLOCK 160
+#define EXPECTED_REQUESTS (7 + SC_REQUESTS) // Una per cambio costoso; nessuna per activate()
+
+static float in_l[FRAMES], in_r[FRAMES];
+static float out_l[FRAMES], out_r[FRAMES];
+static float ref_l[FRAMES], ref_r[FRAMES];
+static MiniHost host, reference;
+static HostWorker worker;
+
+static bool check(const char* name, bool ok) {
+    printf("  %-44s %s\n", name, ok ? "ok" : "FALLITO");
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    printf("worker: %d blocchi da %d a %.0f Hz\n", NUM_BLOCKS, BLOCK, SAMPLERATE);
+    generate_signal(SIGNAL_DRUMS, SAMPLERATE, in_l, in_r, FRAMES);
+
+    host_worker_init(&worker);
+    if (!host_open_with_schedule(&host, SAMPLERATE, BLOCK, &worker.schedule) || !host_open(&reference, SAMPLERATE, BLOCK)) return 1;
+
+    // --- Interfaccia ---
+    const LV2_Worker_Interface* iface =
+        (const LV2_Worker_Interface*)host.descriptor->extension_data(LV2_WORKER__interface);
+    ok &= check("work:interface", iface && iface->work && iface->work_response);
+    ok &= check("estensione sconosciuta", host.descriptor->extension_data("urn:gla3a:nessuna") == NULL);
+    if (!iface) return 1;
+    const char foreign[] = "richiesta estranea";
+    ok &= check("richiesta estranea rifiutata",
+                iface->work(host.instance, host_worker_respond, &worker, sizeof(foreign), foreign) == LV2_WORKER_ERR_UNKNOWN &&
+                worker.num_responses == 0);
+
+    host_activate(&host);
+    host_activate(&reference);
+
+    // --- Cambi durante l'elaborazione ---
+    bool one_in_flight = true;
+    bool same_latency = true;
+    uint32_t requests_at_hold = 0;
+    for (uint32_t b = 0; b < NUM_BLOCKS; ++b) {
+        if (b == ACTIVATE_BLOCK) {
+            host_activate(&host);
+            host_activate(&reference);
+        }
+        for (size_t c = 0; c < sizeof(changes) / sizeof(changes[0]); ++c) {
+            if (changes[c].block == b) host.controls[changes[c].port] = changes[c].value;
+            if (changes[c].reference_block == b) reference.controls[changes[c].port] = changes[c].value;
+        }
+
+        const uint32_t offset = b * BLOCK;
+        host_connect_audio(&host, in_l + offset, in_r + offset, out_l + offset, out_r + offset);
+        host_connect_audio(&reference, in_l + offset, in_r + offset, ref_l + offset, ref_r + offset);
+        host_run(&host, BLOCK);
+        host_run(&reference, BLOCK);
+        same_latency &= host.controls[GLA3A_LATENCY] == reference.controls[GLA3A_LATENCY];
+
+        if (b == HOLD_FIRST) requests_at_hold = worker.total_requests;
+        if (b >= HOLD_FIRST && b < HOLD_LAST) {
+            one_in_flight &= worker.total_requests == requests_at_hold; // Il secondo cambio aspetta
+            continue;
+        }
+        host_worker_deliver(&worker, &host);
+    }
+
+    const size_t bytes = FRAMES * sizeof(float);
+    ok &= check("uscita identica con i cambi a blocco dopo", !memcmp(out_l, ref_l, bytes) && !memcmp(out_r, ref_r, bytes));
+    ok &= check("latenza identica", same_latency);
+    ok &= check("una sola richiesta in volo", one_in_flight);
+
+    char name[96];
+    snprintf(name, sizeof(name), "richieste al worker: %u (attese %d)", worker.total_requests, EXPECTED_REQUESTS);
+    ok &= check(name, worker.total_requests == EXPECTED_REQUESTS);
+
+    host_close(&host);
+    host_close(&reference);
+    printf("%s\n", ok ? "OK" : "FALLITO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,479 @@
+// Benchmark end-to-end di GLA3A, senza host LV2
+// Il plugin è linkato direttamente (gla3a.cpp) e guidato tramite lv2_descriptor(0):
+// instantiate/connect_port/activate/run, con segnali sintetici e tutte le combinazioni di parametri.
+//
+// Uso: tools/gla3a_bench [--full] [--seconds S] [--format table|csv|json]
+//   (default)   otto sweep: blocco x frequenza, modalità x segnale, oversampling, bande,
+//               collegamento stereo, decadimento al silenzio, strisce con l'API a blocchi, taglio e
+//               Q della sidechain in automazione
+//   --full      prodotto cartesiano completo di tutte le dimensioni (lento)
+//   --seconds   secondi di audio per configurazione (default 2)
+//   --format    tabella leggibile (default), CSV o JSON per tenere traccia delle regressioni
+//
+// Metriche per configurazione:
+//   ns/sample   tempo medio per campione stereo (con l'API a blocchi: per campione di ogni striscia)
+//   rt%         percentuale di un core per elaborare in tempo reale
+//   worst_us    blocco più lento (µs) e worst%: la sua frazione del tempo disponibile per quel blocco
+//
+// Ogni riga riporta la precisione di filtri e detector con cui è compilato il core (gla3a_precision.h);
+// "make bench-precision" ripete il benchmark per float, mixed e double.
+// Riporta anche il kernel del blocco (gla3a_kernels.h): "make bench-kernels" ripete il benchmark con
+// i kernel specializzati per configurazione e con il kernel generico, per misurare il guadagno.
+// E la variante ISA scelta da instantiate() (gla3a_isa.h): "make bench-isa" lo ripete con ognuna.
+// E i filtri della sidechain (gla3a_svf.h): "make bench-sidechain" lo ripete con gli SVF e con i
+// biquad; nelle righe con sweep = 1 taglio e Q cambiano a ogni blocco, e worst% mostra i picchi.
+//
+// Il segnale "decay" (un colpo di rumore e poi silenzio) misura la coda in cui gli stati dei filtri
+// decadono verso i denormali: con la protezione attiva (gla3a_denormal.h) deve costare come "pink".
+// Per il confronto senza protezione:
+//   make clean bench CXXFLAGS="-g -O2 -Wall -fPIC -Wno-psabi -DGLA3A_DENORMAL_GUARD=0"
+
+#include "../gla3a_batch.h"
+#include "../gla3a_isa.h"
+#include "../gla3a_kernels.h"
+#include "../gla3a_precision.h"
+#include "../gla3a_svf.h"
+#include "gla3a_host.h"
+#include "gla3a_signals.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_SECONDS 2.0
+#define BENCH_WARMUP_BLOCKS 8
+#define BENCH_SWEEP_SECONDS 0.5 // Periodo dell'automazione della sidechain (sweep = 1)
+
+// --- Dimensioni dello Sweep ---
+
+static const uint32_t block_sizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+static const double sample_rates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+
+#define NUM_BLOCK_SIZES  (sizeof(block_sizes) / sizeof(block_sizes[0]))
+#define NUM_SAMPLE_RATES (sizeof(sample_rates) / sizeof(sample_rates[0]))
+
+static const char* ratio_names[] = { "3:1", "6:1", "9:1", "limit" };
+static const char* os_mode_names[] = { "linear", "lowlat" };
+static const char* link_names[] = { "off", "max", "sum", "blend" };
+
+typedef struct {
+    SignalType signal;
+    double samplerate;
+    uint32_t block_size;
+    int ratio_mode;     // GLA3A_RatioMode
+    int ms;             // M/S attivo
+    int sc_lp;          // LowPass sidechain attivo
+    int sc_hp;          // HighPass sidechain attivo
+    int oversampling;   // GLA3A_OversamplingFactor
+    int os_mode;        // 0 = fase lineare, 1 = bassa latenza
+    int bands;          // Bande del compressore (1 = banda singola)
+    int link;           // 0 = scollegati, 1 = collegati (massimo), 2 = collegati (somma), 3 = misto
+    int strips;         // 0 = un'istanza LV2; altrimenti strisce elaborate insieme (gla3a_batch.h)
+    int sweep;          // Taglio e Q dei filtri sidechain in automazione, un valore nuovo per blocco
+} BenchConfig;
+
+typedef struct {
+    double ns_per_sample;
+    double rt_percent;
+    double worst_block_us;
+    double worst_block_percent;
+    float latency;
+} BenchResult;
+
+typedef enum {
+    FORMAT_TABLE = 0,
+    FORMAT_CSV,
+    FORMAT_JSON
+} BenchFormat;
+
+
+// --- Esecuzione di una Configurazione ---
+
+static double now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Valori delle porte che la configurazione cambia rispetto ai default dell'host
+static void config_controls(const BenchConfig* cfg, float* controls) {
+    controls[GLA3A_MS_MODE_ACTIVE] = (float)cfg->ms;
+    controls[GLA3A_RATIO_MODE] = (float)cfg->ratio_mode;
+    controls[GLA3A_SC_LP_ON] = (float)cfg->sc_lp;
+    controls[GLA3A_SC_HP_ON] = (float)cfg->sc_hp;
+    controls[GLA3A_OVERSAMPLING] = (float)cfg->oversampling;
+    controls[GLA3A_OS_MODE] = (float)cfg->os_mode;
+    controls[GLA3A_BANDS] = (float)cfg->bands;
+    controls[GLA3A_STEREO_LINK] = (float)((cfg->link == 3) ? GLA3A_LINK_BLEND : (cfg->link ? GLA3A_LINK_LINKED : GLA3A_LINK_UNLINKED));
+    controls[GLA3A_LINK_DETECTOR] = (cfg->link == 2) ? 1.0f : 0.0f;
+}
+
+// Automazione della sidechain al blocco: un triangolo in ottave, LowPass 20 kHz -> 312 Hz,
+// HighPass 20 -> 640 Hz e Q 0.5 -> 4, con periodo BENCH_SWEEP_SECONDS
+static void sweep_controls(const BenchConfig* cfg, uint32_t block, float* controls) {
+    const double t = (double)block * cfg->block_size / cfg->samplerate / BENCH_SWEEP_SECONDS;
+    const double tri = 1.0 - fabs(2.0 * (t - floor(t)) - 1.0);
+    controls[GLA3A_SC_LP_FREQ] = (float)(20000.0 * exp2(-6.0 * tri));
+    controls[GLA3A_SC_HP_FREQ] = (float)(20.0 * exp2(5.0 * tri));
+    controls[GLA3A_SC_LP_Q] = controls[GLA3A_SC_HP_Q] = (float)(0.5 * exp2(3.0 * tri));
+}
+
+static void fill_result(const BenchConfig* cfg, double total_ns, double worst_ns, double processed, BenchResult* result) {
+    const double block_budget_ns = cfg->block_size / cfg->samplerate * 1e9;
+    const double strips = cfg->strips ? cfg->strips : 1;
+    result->ns_per_sample = total_ns / (processed * strips);
+    result->rt_percent = 100.0 * total_ns / (processed / cfg->samplerate * 1e9);
+    result->worst_block_us = worst_ns / 1000.0;
+    result->worst_block_percent = 100.0 * worst_ns / block_budget_ns;
+}
+
+// Tutte le strisce con gli stessi parametri e lo stesso segnale, una chiamata per blocco
+static bool run_batch_config(const BenchConfig* cfg, double seconds, BenchResult* result) {
+    static MiniHost defaults; // Stessi valori iniziali delle porte dell'istanza LV2
+    if (!host_open(&defaults, cfg->samplerate, cfg->block_size)) return false;
+    config_controls(cfg, defaults.controls);
+    host_close(&defaults);
+
+    Gla3aBatch* batch = gla3a_batch_new(cfg->samplerate, cfg->strips, cfg->block_size);
+    if (!batch) return false;
+    for (uint32_t s = 0; s < (uint32_t)cfg->strips; ++s) {
+        for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+            gla3a_batch_set_param(batch, s, gla3a_parameters[i].port, defaults.controls[gla3a_parameters[i].port]);
+        }
+    }
+
+    const uint32_t frames = (uint32_t)(seconds * cfg->samplerate);
+    const uint32_t num_blocks = (frames + cfg->block_size - 1) / cfg->block_size;
+    const size_t padded = (size_t)num_blocks * cfg->block_size;
+    float* in_l = (float*)calloc(padded, sizeof(float));
+    float* in_r = (float*)calloc(padded, sizeof(float));
+    float* out = (float*)calloc((size_t)cfg->block_size * cfg->strips * 2, sizeof(float));
+    const float** ins = (const float**)calloc(cfg->strips * 2, sizeof(float*));
+    float** outs = (float**)calloc(cfg->strips * 2, sizeof(float*));
+    if (!in_l || !in_r || !out || !ins || !outs) {
+        free(in_l); free(in_r); free(out); free(ins); free(outs);
+        gla3a_batch_free(batch);
+        return false;
+    }
+    generate_signal(cfg->signal, cfg->samplerate, in_l, in_r, frames);
+    for (int s = 0; s < cfg->strips; ++s) {
+        outs[s] = out + (size_t)cfg->block_size * s;
+        outs[cfg->strips + s] = out + (size_t)cfg->block_size * (cfg->strips + s);
+    }
+
+    double total_ns = 0.0;
+    double worst_ns = 0.0;
+    for (uint32_t b = 0; b < BENCH_WARMUP_BLOCKS + num_blocks; ++b) {
+        const size_t offset = (size_t)(b % num_blocks) * cfg->block_size;
+        for (int s = 0; s < cfg->strips; ++s) {
+            ins[s] = in_l + offset;
+            ins[cfg->strips + s] = in_r + offset;
+        }
+        const double start = now_ns();
+        if (cfg->sweep) {
+            static const GLA3A_PortIndex swept[] = { GLA3A_SC_LP_FREQ, GLA3A_SC_LP_Q, GLA3A_SC_HP_FREQ, GLA3A_SC_HP_Q };
+            sweep_controls(cfg, b, defaults.controls);
+            for (int s = 0; s < cfg->strips; ++s) {
+                for (size_t i = 0; i < sizeof(swept) / sizeof(swept[0]); ++i) {
+                    gla3a_batch_set_param(batch, s, swept[i], defaults.controls[swept[i]]);
+                }
+            }
+        }
+        gla3a_batch_process(batch, ins, ins + cfg->strips, outs, outs + cfg->strips, cfg->block_size);
+        const double elapsed = now_ns() - start;
+        if (b < BENCH_WARMUP_BLOCKS) continue;
+        total_ns += elapsed;
+        if (elapsed > worst_ns) worst_ns = elapsed;
+    }
+
+    fill_result(cfg, total_ns, worst_ns, (double)num_blocks * cfg->block_size, result);
+    result->latency = (float)gla3a_batch_latency(batch, 0);
+
+    gla3a_batch_free(batch);
+    free(in_l); free(in_r); free(out); free(ins); free(outs);
+    return true;
+}
+
+static bool run_config(const BenchConfig* cfg, double seconds, BenchResult* result) {
+    if (cfg->strips) return run_batch_config(cfg, seconds, result);
+
+    // L'host riporta il blocco più lungo che userà, come farebbe un host reale
+    static MiniHost host;
+    if (!host_open(&host, cfg->samplerate, cfg->block_size)) return false;
+    config_controls(cfg, host.controls);
+
+    const uint32_t frames = (uint32_t)(seconds * cfg->samplerate);
+    const uint32_t num_blocks = (frames + cfg->block_size - 1) / cfg->block_size;
+    const size_t padded = (size_t)num_blocks * cfg->block_size;
+    float* in_l = (float*)calloc(padded, sizeof(float));
+    float* in_r = (float*)calloc(padded, sizeof(float));
+    float* out_l = (float*)calloc(cfg->block_size, sizeof(float));
+    float* out_r = (float*)calloc(cfg->block_size, sizeof(float));
+    if (!in_l || !in_r || !out_l || !out_r) {
+        free(in_l); free(in_r); free(out_l); free(out_r);
+        host_close(&host);
+        return false;
+    }
+    generate_signal(cfg->signal, cfg->samplerate, in_l, in_r, frames);
+    host_activate(&host);
+
+    // Riscaldamento: cache, predittori e prima costruzione delle tabelle fuori dalla misura
+    for (uint32_t b = 0; b < BENCH_WARMUP_BLOCKS && b < num_blocks; ++b) {
+        const size_t offset = (size_t)b * cfg->block_size;
+        host_connect_audio(&host, in_l + offset, in_r + offset, out_l, out_r);
+        host_run(&host, cfg->block_size);
+    }
+
+    double total_ns = 0.0;
+    double worst_ns = 0.0;
+    for (uint32_t b = 0; b < num_blocks; ++b) {
+        const size_t offset = (size_t)b * cfg->block_size;
+        host_connect_audio(&host, in_l + offset, in_r + offset, out_l, out_r);
+        if (cfg->sweep) sweep_controls(cfg, b, host.controls);
+        const double start = now_ns();
+        host_run(&host, cfg->block_size);
+        const double elapsed = now_ns() - start;
+        total_ns += elapsed;
+        if (elapsed > worst_ns) worst_ns = elapsed;
+    }
+
+    fill_result(cfg, total_ns, worst_ns, (double)num_blocks * cfg->block_size, result);
+    result->latency = host.controls[GLA3A_LATENCY];
+
+    host_close(&host);
+    free(in_l); free(in_r); free(out_l); free(out_r);
+    return true;
+}
+
+
+// --- Output ---
+
+static int results_written = 0;
+
+// Variante ISA dei kernel, la stessa che sceglie instantiate()
+#define BENCH_ISA_NAME isa_names[isa_select()]
+
+static void print_header(BenchFormat format) {
+    switch (format) {
+        case FORMAT_CSV:
+            printf("precision,kernel,isa,sidechain,signal,samplerate,block,ratio,ms,sc_lp,sc_hp,oversampling,os_mode,bands,link,strips,sweep,latency,"
+                   "ns_per_sample,rt_percent,worst_block_us,worst_block_percent\n");
+            break;
+        case FORMAT_JSON:
+            printf("[\n");
+            break;
+        case FORMAT_TABLE:
+        default:
+            printf("%-6s %-11s %-8s %-6s %-8s %7s %5s %-6s %-3s %-3s %-3s %-3s %-7s %-5s %-5s %6s %5s %4s %10s %8s %10s %8s\n",
+                   "prec", "kernel", "isa", "sc", "signal", "rate", "block", "ratio", "ms", "lp", "hp", "os", "mode", "bands", "link", "strips", "sweep", "lat",
+                   "ns/sample", "rt%", "worst_us", "worst%");
+            break;
+    }
+}
+
+static void print_result(BenchFormat format, const BenchConfig* c, const BenchResult* r) {
+    const int os = 1 << c->oversampling;
+    switch (format) {
+        case FORMAT_CSV:
+            printf("%s,%s,%s,%s,%s,%.0f,%u,%s,%d,%d,%d,%d,%s,%d,%s,%d,%d,%.0f,%.3f,%.4f,%.3f,%.3f\n",
+                   GLA3A_PRECISION_NAME, GLA3A_KERNEL_NAME, BENCH_ISA_NAME, GLA3A_SIDECHAIN_NAME, signal_name(c->signal), c->samplerate, c->block_size, ratio_names[c->ratio_mode],
+                   c->ms, c->sc_lp, c->sc_hp, os, os_mode_names[c->os_mode], c->bands, link_names[c->link], c->strips, c->sweep, r->latency,
+                   r->ns_per_sample, r->rt_percent, r->worst_block_us, r->worst_block_percent);
+            break;
+        case FORMAT_JSON:
+            printf("%s  {\"precision\": \"%s\", \"kernel\": \"%s\", \"isa\": \"%s\", \"sidechain\": \"%s\", \"signal\": \"%s\", \"samplerate\": %.0f, \"block\": %u, \"ratio\": \"%s\", "
+                   "\"ms\": %d, \"sc_lp\": %d, \"sc_hp\": %d, \"oversampling\": %d, \"os_mode\": \"%s\", \"bands\": %d, \"link\": \"%s\", "
+                   "\"strips\": %d, \"sweep\": %d, \"latency\": %.0f, \"ns_per_sample\": %.3f, \"rt_percent\": %.4f, "
+                   "\"worst_block_us\": %.3f, \"worst_block_percent\": %.3f}",
+                   results_written ? ",\n" : "", GLA3A_PRECISION_NAME, GLA3A_KERNEL_NAME, BENCH_ISA_NAME, GLA3A_SIDECHAIN_NAME,
+                   signal_name(c->signal), c->samplerate, c->block_size, ratio_names[c->ratio_mode],
+                   c->ms, c->sc_lp, c->sc_hp, os, os_mode_names[c->os_mode], c->bands, link_names[c->link], c->strips, c->sweep, r->latency,
+                   r->ns_per_sample, r->rt_percent, r->worst_block_us, r->worst_block_percent);
+            break;
+        case FORMAT_TABLE:
+        default:
+            printf("%-6s %-11s %-8s %-6s %-8s %7.0f %5u %-6s %-3d %-3d %-3d %-3d %-7s %-5d %-5s %6d %5d %4.0f %10.2f %8.3f %10.2f %8.2f\n",
+                   GLA3A_PRECISION_NAME, GLA3A_KERNEL_NAME, BENCH_ISA_NAME, GLA3A_SIDECHAIN_NAME, signal_name(c->signal), c->samplerate, c->block_size, ratio_names[c->ratio_mode],
+                   c->ms, c->sc_lp, c->sc_hp, os, os_mode_names[c->os_mode], c->bands, link_names[c->link], c->strips, c->sweep, r->latency,
+                   r->ns_per_sample, r->rt_percent, r->worst_block_us, r->worst_block_percent);
+            break;
+    }
+    fflush(stdout);
+    ++results_written;
+}
+
+static void print_footer(BenchFormat format) {
+    if (format == FORMAT_JSON) printf("\n]\n");
+}
+
+static int bench(BenchFormat format, const BenchConfig* cfg, double seconds) {
+    BenchResult result;
+    if (!run_config(cfg, seconds, &result)) {
+        fprintf(stderr, "gla3a_bench: configurazione fallita (%s, %.0f Hz, blocco %u)\n",
+                signal_name(cfg->signal), cfg->samplerate, cfg->block_size);
+        return 1;
+    }
+    print_result(format, cfg, &result);
+    return 0;
+}
+
+// Configurazione di riferimento: ogni sweep ne varia solo alcune dimensioni
+static BenchConfig default_config() {
+    BenchConfig cfg;
+    cfg.signal = SIGNAL_PINK;
+    cfg.samplerate = 48000.0;
+    cfg.block_size = 256;
+    cfg.ratio_mode = GLA3A_RATIO_3_TO_1;
+    cfg.ms = 0;
+    cfg.sc_lp = 0;
+    cfg.sc_hp = 0;
+    cfg.oversampling = GLA3A_OS_4X;
+    cfg.os_mode = 0;
+    cfg.bands = 1;
+    cfg.link = 0;
+    cfg.strips = 0;
+    cfg.sweep = 0;
+    return cfg;
+}
+
+
+int main(int argc, char** argv) {
+    BenchFormat format = FORMAT_TABLE;
+    double seconds = BENCH_DEFAULT_SECONDS;
+    bool full = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--full")) {
+            full = true;
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+            const char* f = argv[++i];
+            if (!strcmp(f, "csv")) format = FORMAT_CSV;
+            else if (!strcmp(f, "json")) format = FORMAT_JSON;
+            else format = FORMAT_TABLE;
+        } else {
+            fprintf(stderr, "Uso: %s [--full] [--seconds S] [--format table|csv|json]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (seconds <= 0.0) seconds = BENCH_DEFAULT_SECONDS;
+
+    int failures = 0;
+    print_header(format);
+
+    if (full) {
+        // Prodotto cartesiano completo
+        for (int s = 0; s < NUM_SIGNALS; ++s)
+        for (size_t r = 0; r < NUM_SAMPLE_RATES; ++r)
+        for (size_t b = 0; b < NUM_BLOCK_SIZES; ++b)
+        for (int ratio = GLA3A_RATIO_3_TO_1; ratio <= GLA3A_RATIO_LIMIT; ++ratio)
+        for (int ms = 0; ms <= 1; ++ms)
+        for (int sc = 0; sc < 4; ++sc)
+        for (int os = GLA3A_OS_1X; os <= GLA3A_OS_8X; ++os)
+        for (int mode = 0; mode <= 1; ++mode)
+        for (int bands = 1; bands <= 4; ++bands)
+        for (int link = 0; link < 4; ++link) {
+            BenchConfig cfg = { (SignalType)s, sample_rates[r], block_sizes[b], ratio, ms,
+                                sc & 1, (sc >> 1) & 1, os, mode, bands, link, 0, 0 };
+            failures += bench(format, &cfg, seconds);
+        }
+    } else {
+        // 1. Dimensione del blocco x frequenza di campionamento
+        for (size_t r = 0; r < NUM_SAMPLE_RATES; ++r) {
+            for (size_t b = 0; b < NUM_BLOCK_SIZES; ++b) {
+                BenchConfig cfg = default_config();
+                cfg.samplerate = sample_rates[r];
+                cfg.block_size = block_sizes[b];
+                failures += bench(format, &cfg, seconds);
+            }
+        }
+        // 2. Ogni ratio, M/S e combinazione dei filtri sidechain, per ogni segnale
+        for (int s = 0; s < NUM_SIGNALS; ++s)
+        for (int ratio = GLA3A_RATIO_3_TO_1; ratio <= GLA3A_RATIO_LIMIT; ++ratio)
+        for (int ms = 0; ms <= 1; ++ms)
+        for (int sc = 0; sc < 4; ++sc) {
+            BenchConfig cfg = default_config();
+            cfg.signal = (SignalType)s;
+            cfg.ratio_mode = ratio;
+            cfg.ms = ms;
+            cfg.sc_lp = sc & 1;
+            cfg.sc_hp = (sc >> 1) & 1;
+            failures += bench(format, &cfg, seconds);
+        }
+        // 3. Fattore e tipo di oversampling
+        for (int os = GLA3A_OS_1X; os <= GLA3A_OS_8X; ++os) {
+            for (int mode = 0; mode <= 1; ++mode) {
+                BenchConfig cfg = default_config();
+                cfg.oversampling = os;
+                cfg.os_mode = mode;
+                failures += bench(format, &cfg, seconds);
+            }
+        }
+        // 4. Numero di bande, per ogni segnale
+        for (int s = 0; s < NUM_SIGNALS; ++s) {
+            for (int bands = 1; bands <= 4; ++bands) {
+                BenchConfig cfg = default_config();
+                cfg.signal = (SignalType)s;
+                cfg.bands = bands;
+                failures += bench(format, &cfg, seconds);
+            }
+        }
+        // 5. Collegamento stereo, a banda singola e a 4 bande
+        for (int bands = 1; bands <= 4; bands += 3) {
+            for (int link = 0; link < 4; ++link) {
+                BenchConfig cfg = default_config();
+                cfg.bands = bands;
+                cfg.link = link;
+                failures += bench(format, &cfg, seconds);
+            }
+        }
+        // 6. Decadimento al silenzio: tutti gli stati ricorsivi (celle allpass dell'oversampling
+        //    a bassa latenza, filtri sidechain, crossover) su ogni fattore di oversampling
+        for (int os = GLA3A_OS_1X; os <= GLA3A_OS_8X; ++os) {
+            for (int bands = 1; bands <= 4; bands += 3) {
+                BenchConfig cfg = default_config();
+                cfg.signal = SIGNAL_DECAY;
+                cfg.oversampling = os;
+                cfg.os_mode = 1;
+                cfg.sc_lp = 1;
+                cfg.sc_hp = 1;
+                cfg.bands = bands;
+                failures += bench(format, &cfg, seconds);
+            }
+        }
+        // 7. API a blocchi: istanza singola contro 8 e 64 strisce, con i filtri sidechain accesi
+        //    (gli stadi ricorsivi che le corsie avanzano insieme)
+        static const int strip_counts[] = { 0, 8, 64 };
+        for (int os = GLA3A_OS_1X; os <= GLA3A_OS_4X; os += GLA3A_OS_4X) {
+            for (size_t k = 0; k < sizeof(strip_counts) / sizeof(strip_counts[0]); ++k) {
+                BenchConfig cfg = default_config();
+                cfg.oversampling = os;
+                cfg.sc_lp = 1;
+                cfg.sc_hp = 1;
+                cfg.strips = strip_counts[k];
+                failures += bench(format, &cfg, seconds);
+            }
+        }
+        // 8. Taglio e Q della sidechain in automazione, fermi e a ogni blocco: istanza singola e 8
+        //    strisce, su blocchi piccoli e grandi
+        for (int strips = 0; strips <= 8; strips += 8) {
+            for (uint32_t block = 64; block <= 1024; block *= 16) {
+                for (int sweep = 0; sweep <= 1; ++sweep) {
+                    BenchConfig cfg = default_config();
+                    cfg.block_size = block;
+                    cfg.sc_lp = 1;
+                    cfg.sc_hp = 1;
+                    cfg.strips = strips;
+                    cfg.sweep = sweep;
+                    failures += bench(format, &cfg, seconds);
+                }
+            }
+        }
+    }
+
+    print_footer(format);
+    return failures ? 1 : 0;
+}
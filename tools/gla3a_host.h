@@ -0,0 +1,255 @@
+#ifndef GLA3A_HOST_H
+#define GLA3A_HOST_H
+
+// --- Host LV2 Minimo ---
+// Quanto basta per guidare il plugin linkato direttamente (lv2_descriptor(0)) da benchmark e test:
+// mappa URID, opzione bufsz:maxBlockLength, porte di controllo in un array dell'host e una
+// sequenza di patch:Set per la porta GLA3A_CONTROL (svuotata dopo ogni run), un buffer per i frame
+// dei meter sulla porta GLA3A_NOTIFY (riscritto a ogni run). work:schedule solo
+// se il chiamante lo passa (host_open_with_schedule()): senza, il plugin progetta tutto nel run.
+// Le porte puntano dentro la struct: un MiniHost aperto non va copiato né spostato.
+
+#include "../gla3a.h"
+#include <lv2/core/lv2.h>
+#include <lv2/urid/urid.h>
+#include <lv2/atom/atom.h>
+#include <lv2/atom/util.h>
+#include <lv2/patch/patch.h>
+#include <lv2/options/options.h>
+#include <lv2/buf-size/buf-size.h>
+#include <lv2/worker/worker.h>
+#include <stdint.h>
+#include <string.h>
+
+#define HOST_MAX_URIS 64
+#define HOST_NUM_PORTS GLA3A_NUM_PORTS
+#define HOST_EVENT_CAPACITY 8192 // Byte della sequenza di eventi
+#define HOST_NOTIFY_CAPACITY 8192 // Byte della sequenza in uscita
+
+static const char* host_uri_table[HOST_MAX_URIS];
+static uint32_t host_num_uris = 0;
+
+static LV2_URID host_map_uri(LV2_URID_Map_Handle handle, const char* uri) {
+    for (uint32_t i = 0; i < host_num_uris; ++i) {
+        if (!strcmp(host_uri_table[i], uri)) return i + 1;
+    }
+    if (host_num_uris == HOST_MAX_URIS) return 0;
+    host_uri_table[host_num_uris] = uri;
+    return ++host_num_uris;
+}
+
+// Un evento patch:Set con valore float, come lo scriverebbe un atom forge (proprietà allineate a 8)
+typedef struct {
+    LV2_Atom_Event event;          // Timestamp + intestazione dell'oggetto
+    LV2_Atom_Object_Body object;
+    uint32_t property_key;
+    uint32_t property_context;
+    LV2_Atom_URID property;
+    uint32_t property_pad;
+    uint32_t value_key;
+    uint32_t value_context;
+    LV2_Atom_Float value;
+} HostPatchSet;
+
+typedef struct {
+    const LV2_Descriptor* descriptor;
+    LV2_Handle instance;
+    float controls[HOST_NUM_PORTS]; // Valori delle porte di controllo (ingressi e uscite)
+    union {
+        LV2_Atom_Sequence sequence;
+        uint8_t bytes[HOST_EVENT_CAPACITY];
+    } events;                       // Ingresso atom (GLA3A_CONTROL)
+    union {
+        LV2_Atom_Sequence sequence;
+        uint8_t bytes[HOST_NOTIFY_CAPACITY];
+    } notify;                       // Uscita atom (GLA3A_NOTIFY), valida dopo ogni run
+
+    int32_t max_block_length;
+    LV2_URID_Map map;
+    LV2_Options_Option options[2];
+    LV2_Feature map_feature;
+    LV2_Feature options_feature;
+    LV2_Feature schedule_feature;
+    const LV2_Feature* features[4];
+} MiniHost;
+
+// Istanzia il plugin e collega le porte di controllo. max_block_length = 0: opzione non passata;
+// schedule NULL: niente work:schedule.
+// I controlli partono dai valori di default del TTL più rilevanti; il chiamante li modifica prima di run.
+static bool host_open_with_schedule(MiniHost* h, double samplerate, uint32_t max_block_length,
+                                    LV2_Worker_Schedule* schedule) {
+    memset(h, 0, sizeof(MiniHost));
+    h->descriptor = lv2_descriptor(0);
+    if (!h->descriptor) return false;
+
+    h->max_block_length = (int32_t)max_block_length;
+    h->map.handle = NULL;
+    h->map.map = host_map_uri;
+    h->options[0].context = LV2_OPTIONS_INSTANCE;
+    h->options[0].key = host_map_uri(NULL, LV2_BUF_SIZE__maxBlockLength);
+    h->options[0].size = sizeof(int32_t);
+    h->options[0].type = host_map_uri(NULL, LV2_ATOM__Int);
+    h->options[0].value = &h->max_block_length;
+    h->map_feature.URI = LV2_URID__map;
+    h->map_feature.data = &h->map;
+    h->options_feature.URI = LV2_OPTIONS__options;
+    h->options_feature.data = h->options;
+    h->schedule_feature.URI = LV2_WORKER__schedule;
+    h->schedule_feature.data = schedule;
+    int num_features = 0;
+    h->features[num_features++] = &h->map_feature;
+    if (max_block_length) h->features[num_features++] = &h->options_feature;
+    if (schedule) h->features[num_features++] = &h->schedule_feature;
+    h->features[num_features] = NULL;
+
+    h->instance = h->descriptor->instantiate(h->descriptor, samplerate, "", h->features);
+    if (!h->instance) return false;
+
+    h->controls[GLA3A_PEAK_REDUCTION] = 0.6f;
+    h->controls[GLA3A_GAIN] = 0.25f;
+    h->controls[GLA3A_SC_LP_FREQ] = 5000.0f;
+    h->controls[GLA3A_SC_LP_Q] = 0.707f;
+    h->controls[GLA3A_SC_HP_FREQ] = 120.0f;
+    h->controls[GLA3A_SC_HP_Q] = 0.707f;
+    h->controls[GLA3A_OVERSAMPLING] = GLA3A_OS_4X;
+    h->controls[GLA3A_LOOKAHEAD] = 5.0f;
+    h->controls[GLA3A_BANDS] = 1.0f;
+    h->controls[GLA3A_CROSSOVER_1] = 200.0f;
+    h->controls[GLA3A_CROSSOVER_2] = 1000.0f;
+    h->controls[GLA3A_CROSSOVER_3] = 5000.0f;
+    h->controls[GLA3A_LINK_AMOUNT] = 0.5f;
+    for (uint32_t p = 0; p < HOST_NUM_PORTS; ++p) {
+        if ((p < GLA3A_AUDIO_IN_L || p > GLA3A_AUDIO_OUT_R) && p != GLA3A_CONTROL && p != GLA3A_NOTIFY) {
+            h->descriptor->connect_port(h->instance, p, &h->controls[p]);
+        }
+    }
+
+    h->events.sequence.atom.type = host_map_uri(NULL, LV2_ATOM__Sequence);
+    h->events.sequence.body.unit = 0;
+    h->events.sequence.body.pad = 0;
+    lv2_atom_sequence_clear(&h->events.sequence);
+    h->descriptor->connect_port(h->instance, GLA3A_CONTROL, &h->events.sequence);
+    h->descriptor->connect_port(h->instance, GLA3A_NOTIFY, &h->notify.sequence);
+    return true;
+}
+
+static bool host_open(MiniHost* h, double samplerate, uint32_t max_block_length) {
+    return host_open_with_schedule(h, samplerate, max_block_length, NULL);
+}
+
+// Accoda un patch:Set con valore float sulla proprietà 'uri' (un parametro o il banco di preset,
+// GLA3A_PRESET_URI / GLA3A_PRESET_STORE_URI) al campione 'frame' del prossimo run.
+// Gli eventi vanno accodati in ordine di tempo; false se non c'è spazio.
+static bool host_set_property(MiniHost* h, uint32_t frame, const char* uri, float value) {
+    HostPatchSet ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.event.time.frames = frame;
+    ev.event.body.type = host_map_uri(NULL, LV2_ATOM__Object);
+    ev.event.body.size = sizeof(HostPatchSet) - sizeof(LV2_Atom_Event);
+    ev.object.otype = host_map_uri(NULL, LV2_PATCH__Set);
+    ev.property_key = host_map_uri(NULL, LV2_PATCH__property);
+    ev.property.atom.type = host_map_uri(NULL, LV2_ATOM__URID);
+    ev.property.atom.size = sizeof(uint32_t);
+    ev.property.body = host_map_uri(NULL, uri);
+    ev.value_key = host_map_uri(NULL, LV2_PATCH__value);
+    ev.value.atom.type = host_map_uri(NULL, LV2_ATOM__Float);
+    ev.value.atom.size = sizeof(float);
+    ev.value.body = value;
+    return lv2_atom_sequence_append_event(&h->events.sequence, HOST_EVENT_CAPACITY, &ev.event) != NULL;
+}
+
+// Come host_set_property() sul parametro della porta 'port'; false se la porta non è un parametro
+static inline bool host_set_param(MiniHost* h, uint32_t frame, GLA3A_PortIndex port, float value) {
+    for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+        if (gla3a_parameters[i].port == port) return host_set_property(h, frame, gla3a_parameters[i].uri, value);
+    }
+    return false;
+}
+
+static void host_connect_audio(MiniHost* h, const float* in_l, const float* in_r, float* out_l, float* out_r) {
+    h->descriptor->connect_port(h->instance, GLA3A_AUDIO_IN_L, (void*)in_l);
+    h->descriptor->connect_port(h->instance, GLA3A_AUDIO_IN_R, (void*)in_r);
+    h->descriptor->connect_port(h->instance, GLA3A_AUDIO_OUT_L, out_l);
+    h->descriptor->connect_port(h->instance, GLA3A_AUDIO_OUT_R, out_r);
+}
+
+static void host_activate(MiniHost* h) {
+    h->descriptor->activate(h->instance);
+}
+
+static void host_run(MiniHost* h, uint32_t sample_count) {
+    // Uscita atom: un atom:Chunk con lo spazio disponibile, che il plugin riscrive come sequenza
+    h->notify.sequence.atom.type = host_map_uri(NULL, LV2_ATOM__Chunk);
+    h->notify.sequence.atom.size = HOST_NOTIFY_CAPACITY - sizeof(LV2_Atom);
+    h->descriptor->run(h->instance, sample_count);
+    lv2_atom_sequence_clear(&h->events.sequence);
+}
+
+static void host_close(MiniHost* h) {
+    if (h->instance) h->descriptor->cleanup(h->instance);
+    h->instance = NULL;
+}
+
+
+// --- Worker dell'Host (work:schedule) ---
+// Richieste e risposte copiate in code, come nei ring buffer di un host vero; host_worker_deliver()
+// esegue le richieste (il thread del worker) e consegna le risposte (il thread audio, dopo la run).
+// Tutto sullo stesso thread: basta per verificare lo scambio al confine del blocco.
+
+#define HOST_WORKER_QUEUE_LENGTH 8
+#define HOST_WORKER_MESSAGE_CAPACITY 1024
+
+typedef struct {
+    uint8_t data[HOST_WORKER_MESSAGE_CAPACITY];
+    uint32_t size;
+} HostWorkerMessage;
+
+typedef struct {
+    LV2_Worker_Schedule schedule;   // Da passare a host_open_with_schedule()
+    HostWorkerMessage requests[HOST_WORKER_QUEUE_LENGTH];
+    HostWorkerMessage responses[HOST_WORKER_QUEUE_LENGTH];
+    uint32_t num_requests;
+    uint32_t num_responses;
+    uint32_t total_requests;        // Richieste accettate dall'inizio
+} HostWorker;
+
+static bool host_worker_push(HostWorkerMessage* queue, uint32_t* count, uint32_t size, const void* data) {
+    if (*count == HOST_WORKER_QUEUE_LENGTH || size > HOST_WORKER_MESSAGE_CAPACITY) return false;
+    memcpy(queue[*count].data, data, size);
+    queue[*count].size = size;
+    ++*count;
+    return true;
+}
+
+static LV2_Worker_Status host_worker_schedule(LV2_Worker_Schedule_Handle handle, uint32_t size, const void* data) {
+    HostWorker* w = (HostWorker*)handle;
+    if (!host_worker_push(w->requests, &w->num_requests, size, data)) return LV2_WORKER_ERR_NO_SPACE;
+    ++w->total_requests;
+    return LV2_WORKER_SUCCESS;
+}
+
+static LV2_Worker_Status host_worker_respond(LV2_Worker_Respond_Handle handle, uint32_t size, const void* data) {
+    HostWorker* w = (HostWorker*)handle;
+    return host_worker_push(w->responses, &w->num_responses, size, data) ? LV2_WORKER_SUCCESS : LV2_WORKER_ERR_NO_SPACE;
+}
+
+static inline void host_worker_init(HostWorker* w) {
+    memset(w, 0, sizeof(HostWorker));
+    w->schedule.handle = w;
+    w->schedule.schedule_work = host_worker_schedule;
+}
+
+static inline void host_worker_deliver(HostWorker* w, MiniHost* h) {
+    const LV2_Worker_Interface* iface =
+        (const LV2_Worker_Interface*)h->descriptor->extension_data(LV2_WORKER__interface);
+    for (uint32_t i = 0; i < w->num_requests; ++i) {
+        iface->work(h->instance, host_worker_respond, w, w->requests[i].size, w->requests[i].data);
+    }
+    w->num_requests = 0;
+    for (uint32_t i = 0; i < w->num_responses; ++i) {
+        iface->work_response(h->instance, w->responses[i].size, w->responses[i].data);
+    }
+    w->num_responses = 0;
+}
+
+#endif // GLA3A_HOST_H
@@ -0,0 +1,153 @@
+// gla3a-render: render offline di un file attraverso GLA3A, senza host LV2
+// Il plugin è linkato direttamente (gla3a.cpp); ingresso e uscita sono mappati in memoria e i file
+// lunghi si dividono in chunk elaborati in parallelo (tools/gla3a_render.h).
+//
+// Uso: tools/gla3a-render [opzioni] ingresso uscita
+//   ingresso/uscita  .wav (PCM 16/24/32 bit o float; l'uscita è sempre float 32 bit) oppure
+//                    float 32 bit interleaved senza intestazione (qualunque altra estensione)
+//   --set nome=valore  parametro con il nome della sua proprietà (peakReduction, ratioMode, ...),
+//                      ripetibile; gli altri restano ai default
+//   --threads N        thread del pool (default: i core disponibili)
+//   --chunk S          secondi per chunk (default 30; 0 = un solo chunk)
+//   --warmup S         secondi elaborati e scartati prima di ogni chunk (default 3)
+//   --block N          campioni per run() (default 512)
+//   --rate HZ          frequenza di un file grezzo (default 48000)
+//   --channels N       canali di un file grezzo, 1 o 2 (default 2)
+//   --no-latency-comp  uscita così come esce dal plugin, ritardata della sua latenza
+//   --verify           rifà il render in un solo passo e confronta: esce con 1 se lo scarto
+//                      supera --tolerance (default 1e-5)
+
+#include "gla3a_render.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RENDER_DEFAULT_RAW_RATE 48000.0
+#define RENDER_DEFAULT_TOLERANCE 1e-5
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// "nome=valore" con il nome della proprietà del parametro (gla3a_parameters, senza il prefisso)
+static bool parse_setting(const char* arg, RenderOptions* opts) {
+    const char* eq = strchr(arg, '=');
+    if (!eq) return false;
+    const size_t prefix = strlen(GLA3A_PARAM_PREFIX);
+    for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+        const char* name = gla3a_parameters[i].uri + prefix;
+        if (strlen(name) == (size_t)(eq - arg) && !strncmp(name, arg, eq - arg)) {
+            opts->set[gla3a_parameters[i].port] = true;
+            opts->values[gla3a_parameters[i].port] = (float)atof(eq + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr,
+            "Uso: %s [--set nome=valore]... [--threads N] [--chunk S] [--warmup S] [--block N]\n"
+            "       [--rate HZ] [--channels N] [--no-latency-comp] [--verify] [--tolerance E] ingresso uscita\n"
+            "Parametri:", argv0);
+    for (size_t i = 0; i < GLA3A_NUM_PARAMETERS; ++i) {
+        fprintf(stderr, " %s", gla3a_parameters[i].uri + strlen(GLA3A_PARAM_PREFIX));
+    }
+    fprintf(stderr, "\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    RenderOptions opts;
+    render_options_init(&opts, 1.0); // Le durate in secondi si convertono quando si conosce la frequenza
+    double chunk_seconds = RENDER_DEFAULT_CHUNK_SECONDS;
+    double warmup_seconds = RENDER_DEFAULT_WARMUP_SECONDS;
+    double raw_rate = RENDER_DEFAULT_RAW_RATE;
+    uint32_t raw_channels = 2;
+    double tolerance = RENDER_DEFAULT_TOLERANCE;
+    bool verify = false;
+    const char* paths[2] = { NULL, NULL };
+    int num_paths = 0;
+
+    const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    opts.threads = (cores > 0) ? (int)cores : 1;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!strcmp(argv[i], "--set") && has_value) {
+            if (!parse_setting(argv[++i], &opts)) {
+                fprintf(stderr, "Parametro sconosciuto: %s\n", argv[i]);
+                return usage(argv[0]);
+            }
+        } else if (!strcmp(argv[i], "--threads") && has_value) {
+            opts.threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--chunk") && has_value) {
+            chunk_seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--warmup") && has_value) {
+            warmup_seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--block") && has_value) {
+            opts.block_size = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--rate") && has_value) {
+            raw_rate = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--channels") && has_value) {
+            raw_channels = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--tolerance") && has_value) {
+            tolerance = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--no-latency-comp")) {
+            opts.compensate_latency = false;
+        } else if (!strcmp(argv[i], "--verify")) {
+            verify = true;
+        } else if (argv[i][0] != '-' && num_paths < 2) {
+            paths[num_paths++] = argv[i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (num_paths != 2 || opts.block_size == 0 || chunk_seconds < 0.0 || warmup_seconds < 0.0) return usage(argv[0]);
+
+    char error[256];
+    AudioFile in, out;
+    if (!audio_open_input(&in, paths[0], raw_rate, raw_channels, error, sizeof(error))) {
+        fprintf(stderr, "%s: %s\n", paths[0], error);
+        audio_close(&in);
+        return 1;
+    }
+    if (!audio_create_output(&out, paths[1], &in, error, sizeof(error))) {
+        fprintf(stderr, "%s: %s\n", paths[1], error);
+        audio_close(&in);
+        audio_close(&out);
+        return 1;
+    }
+    opts.chunk_frames = (uint64_t)(chunk_seconds * in.samplerate);
+    opts.warmup_frames = (uint64_t)(warmup_seconds * in.samplerate);
+
+    const double seconds = in.frames / in.samplerate;
+    const double start = now_seconds();
+    bool ok = render_file(&in, &out, &opts);
+    const double elapsed = now_seconds() - start;
+    const uint64_t chunk = render_chunk_length(&opts, in.frames);
+    const uint64_t num_chunks = in.frames ? (in.frames + chunk - 1) / chunk : 0;
+    printf("%s: %.1f s a %.0f Hz, %llu chunk su %d thread, %.2f s (%.1fx tempo reale)%s\n",
+           paths[1], seconds, in.samplerate, (unsigned long long)num_chunks, opts.threads,
+           elapsed, elapsed > 0.0 ? seconds / elapsed : 0.0, ok ? "" : " FALLITO");
+
+    if (ok && verify) {
+        RenderVerify v;
+        ok = render_verify(&in, &out, &opts, &v);
+        const uint64_t seam = v.chunk_length ? v.max_error_frame / v.chunk_length * v.chunk_length : 0;
+        printf("verifica: scarto max %.3g (%.1f dBFS) al campione %llu, %llu dopo la giunzione; "
+               "alle giunzioni %.3g: %s\n",
+               v.max_error, 20.0 * log10(v.max_error > 1e-30 ? v.max_error : 1e-30),
+               (unsigned long long)v.max_error_frame, (unsigned long long)(v.max_error_frame - seam),
+               v.max_seam_error, (ok && v.max_error <= tolerance) ? "ok" : "FALLITO");
+        ok = ok && v.max_error <= tolerance;
+    }
+
+    audio_close(&out);
+    audio_close(&in);
+    return ok ? 0 : 1;
+}
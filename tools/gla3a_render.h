@@ -0,0 +1,463 @@
+#ifndef GLA3A_RENDER_H
+#define GLA3A_RENDER_H
+
+// --- Render Offline di File ---
+// Motore di tools/gla3a_render.cpp (e di tests/render.cpp): un file WAV o float grezzo passa nel
+// plugin linkato direttamente (MiniHost) e l'uscita va in un file WAV o grezzo, in float 32 bit.
+//  - Ingresso e uscita sono mappati in memoria (mmap): ogni worker converte solo i blocchi che sta
+//    elaborando, quindi la RAM non dipende dalla lunghezza del file.
+//  - I file lunghi si dividono in chunk elaborati da un pool di thread. Ogni chunk parte
+//    warmup_frames prima del suo inizio, con un'istanza appena attivata, e scarta quell'uscita:
+//    envelope, smoothing e filtri (costanti di tempo fino a 200 ms) arrivano allo stato che
+//    avrebbero in un render continuo prima del primo campione scritto.
+//  - La latenza del plugin (oversampling, lookahead) si compensa: l'uscita è allineata
+//    all'ingresso e ha la stessa lunghezza, con la coda presa dall'elaborazione di zeri.
+//  - render_verify() rifà il render in un solo passo e misura lo scarto dall'uscita a chunk,
+//    con la distanza dalla giunzione più vicina.
+
+#include "gla3a_host.h"
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RENDER_DEFAULT_BLOCK 512
+#define RENDER_DEFAULT_CHUNK_SECONDS 30.0
+#define RENDER_DEFAULT_WARMUP_SECONDS 3.0 // 15 costanti di tempo del rilascio più lento
+#define RENDER_MAX_THREADS 64
+
+#define WAV_FORMAT_PCM 1
+#define WAV_FORMAT_FLOAT 3
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+#define WAV_FLOAT_HEADER_SIZE 58 // RIFF + fmt (18 byte) + fact + intestazione del chunk data
+
+
+// --- File Audio Mappati ---
+
+typedef enum {
+    SAMPLE_PCM16 = 0,
+    SAMPLE_PCM24,
+    SAMPLE_PCM32,
+    SAMPLE_FLOAT32
+} SampleFormat;
+
+typedef struct {
+    int fd;
+    uint8_t* map;
+    size_t map_size;
+    const uint8_t* data;    // Primo campione
+    SampleFormat format;
+    uint32_t channels;      // 1 o 2 (un file mono entra uguale sui due canali)
+    uint32_t bytes_per_frame;
+    uint64_t frames;
+    double samplerate;
+    bool wav;               // false: float 32 bit interleaved senza intestazione
+} AudioFile;
+
+static uint32_t read_le16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t read_le32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static void write_le16(uint8_t* p, uint32_t v) { p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; }
+static void write_le32(uint8_t* p, uint32_t v) { write_le16(p, v & 0xFFFF); write_le16(p + 2, v >> 16); }
+
+static uint32_t sample_bytes(SampleFormat format) {
+    static const uint32_t bytes[] = { 2, 3, 4, 4 };
+    return bytes[format];
+}
+
+// Chunk fmt e data di un WAV (PCM 16/24/32 bit o float 32 bit, anche WAVE_FORMAT_EXTENSIBLE)
+static bool wav_parse(AudioFile* f, char* error, size_t error_size) {
+    const uint8_t* p = f->map;
+    const uint8_t* end = f->map + f->map_size;
+    if (f->map_size < 12 || memcmp(p, "RIFF", 4) || memcmp(p + 8, "WAVE", 4)) {
+        snprintf(error, error_size, "non è un file RIFF/WAVE");
+        return false;
+    }
+    bool have_fmt = false;
+    uint32_t tag = 0, bits = 0;
+    for (p += 12; p + 8 <= end; ) {
+        const uint32_t size = read_le32(p + 4);
+        const uint8_t* body = p + 8;
+        if (size > (size_t)(end - body)) {
+            // Un chunk data troncato (render interrotto) si legge fino alla fine del file
+            if (memcmp(p, "data", 4)) break;
+        }
+        if (!memcmp(p, "fmt ", 4) && size >= 16) {
+            tag = read_le16(body);
+            f->channels = read_le16(body + 2);
+            f->samplerate = read_le32(body + 4);
+            bits = read_le16(body + 14);
+            if (tag == WAV_FORMAT_EXTENSIBLE && size >= 40) tag = read_le16(body + 24); // GUID del sottoformato
+            have_fmt = true;
+        } else if (!memcmp(p, "data", 4)) {
+            if (!have_fmt) break;
+            if (tag == WAV_FORMAT_PCM && bits == 16) f->format = SAMPLE_PCM16;
+            else if (tag == WAV_FORMAT_PCM && bits == 24) f->format = SAMPLE_PCM24;
+            else if (tag == WAV_FORMAT_PCM && bits == 32) f->format = SAMPLE_PCM32;
+            else if (tag == WAV_FORMAT_FLOAT && bits == 32) f->format = SAMPLE_FLOAT32;
+            else {
+                snprintf(error, error_size, "formato WAV non supportato (tag %u, %u bit)", tag, bits);
+                return false;
+            }
+            if (f->channels < 1 || f->channels > 2) {
+                snprintf(error, error_size, "%u canali non supportati (solo mono e stereo)", f->channels);
+                return false;
+            }
+            const size_t available = (size > (size_t)(end - body)) ? (size_t)(end - body) : size;
+            f->data = body;
+            f->bytes_per_frame = sample_bytes(f->format) * f->channels;
+            f->frames = available / f->bytes_per_frame;
+            return true;
+        }
+        p = body + size + (size & 1);
+    }
+    snprintf(error, error_size, "chunk fmt o data mancante");
+    return false;
+}
+
+static bool path_is_wav(const char* path) {
+    const size_t len = strlen(path);
+    return len >= 4 && !strcasecmp(path + len - 4, ".wav");
+}
+
+// Mappa un file in sola lettura. I file .wav si leggono dall'intestazione; gli altri sono float
+// 32 bit interleaved con la frequenza e i canali passati dal chiamante.
+static bool audio_open_input(AudioFile* f, const char* path, double raw_samplerate, uint32_t raw_channels,
+                             char* error, size_t error_size) {
+    memset(f, 0, sizeof(AudioFile));
+    f->fd = open(path, O_RDONLY);
+    struct stat st;
+    if (f->fd < 0 || fstat(f->fd, &st) != 0) {
+        snprintf(error, error_size, "impossibile aprire %s", path);
+        if (f->fd >= 0) close(f->fd);
+        f->fd = -1;
+        return false;
+    }
+    f->map_size = (size_t)st.st_size;
+    if (f->map_size > 0) {
+        f->map = (uint8_t*)mmap(NULL, f->map_size, PROT_READ, MAP_PRIVATE, f->fd, 0);
+        if (f->map == MAP_FAILED) {
+            f->map = NULL;
+            snprintf(error, error_size, "mmap di %s fallita", path);
+            return false;
+        }
+        madvise(f->map, f->map_size, MADV_SEQUENTIAL);
+    }
+
+    f->wav = path_is_wav(path);
+    if (f->wav) return wav_parse(f, error, error_size);
+
+    if (raw_channels < 1 || raw_channels > 2) {
+        snprintf(error, error_size, "%u canali non supportati (solo mono e stereo)", raw_channels);
+        return false;
+    }
+    f->data = f->map;
+    f->format = SAMPLE_FLOAT32;
+    f->channels = raw_channels;
+    f->samplerate = raw_samplerate;
+    f->bytes_per_frame = 4 * raw_channels;
+    f->frames = f->map_size / f->bytes_per_frame;
+    return true;
+}
+
+// Crea l'uscita (float 32 bit, stessi canali e frame dell'ingresso; WAV o grezzo secondo l'estensione)
+// già della sua dimensione finale e la mappa in scrittura: i worker scrivono ognuno nel suo tratto.
+static bool audio_create_output(AudioFile* f, const char* path, const AudioFile* like, char* error, size_t error_size) {
+    memset(f, 0, sizeof(AudioFile));
+    f->fd = -1;
+    f->format = SAMPLE_FLOAT32;
+    f->channels = like->channels;
+    f->bytes_per_frame = 4 * like->channels;
+    f->frames = like->frames;
+    f->samplerate = like->samplerate;
+    f->wav = path_is_wav(path);
+
+    const uint64_t data_size = f->frames * f->bytes_per_frame;
+    const size_t header = f->wav ? WAV_FLOAT_HEADER_SIZE : 0;
+    if (f->wav && data_size + header - 8 > 0xFFFFFFFFull) {
+        snprintf(error, error_size, "uscita oltre i 4 GB del formato WAV (usare il formato grezzo)");
+        return false;
+    }
+    f->map_size = header + data_size;
+    f->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (f->fd < 0 || ftruncate(f->fd, (off_t)f->map_size) != 0) {
+        snprintf(error, error_size, "impossibile creare %s", path);
+        return false;
+    }
+    if (f->map_size > 0) {
+        f->map = (uint8_t*)mmap(NULL, f->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, f->fd, 0);
+        if (f->map == MAP_FAILED) {
+            f->map = NULL;
+            snprintf(error, error_size, "mmap di %s fallita", path);
+            return false;
+        }
+    }
+    f->data = f->map + header;
+
+    if (f->wav) {
+        uint8_t* h = f->map;
+        memcpy(h, "RIFF", 4);
+        write_le32(h + 4, (uint32_t)(f->map_size - 8));
+        memcpy(h + 8, "WAVE", 4);
+        memcpy(h + 12, "fmt ", 4);
+        write_le32(h + 16, 18);
+        write_le16(h + 20, WAV_FORMAT_FLOAT);
+        write_le16(h + 22, f->channels);
+        write_le32(h + 24, (uint32_t)f->samplerate);
+        write_le32(h + 28, (uint32_t)f->samplerate * f->bytes_per_frame);
+        write_le16(h + 32, f->bytes_per_frame);
+        write_le16(h + 34, 32);
+        write_le16(h + 36, 0);  // cbSize
+        memcpy(h + 38, "fact", 4);
+        write_le32(h + 42, 4);
+        write_le32(h + 46, (uint32_t)f->frames);
+        memcpy(h + 50, "data", 4);
+        write_le32(h + 54, (uint32_t)data_size);
+    }
+    return true;
+}
+
+static void audio_close(AudioFile* f) {
+    if (f->map) munmap(f->map, f->map_size);
+    if (f->fd >= 0) close(f->fd);
+    f->map = NULL;
+    f->fd = -1;
+}
+
+// Legge n frame da 'start' in due canali float; oltre la fine del file legge silenzio
+static void audio_read(const AudioFile* f, uint64_t start, uint32_t n, float* l, float* r) {
+    uint32_t i = 0;
+    for (; i < n && start + i < f->frames; ++i) {
+        const uint8_t* p = f->data + (start + i) * f->bytes_per_frame;
+        float v[2] = { 0.0f, 0.0f };
+        for (uint32_t c = 0; c < f->channels; ++c, p += sample_bytes(f->format)) {
+            switch (f->format) {
+                case SAMPLE_PCM16:   v[c] = (int16_t)read_le16(p) * (1.0f / 32768.0f); break;
+                case SAMPLE_PCM24:   v[c] = (float)((int32_t)((p[0] << 8) | (p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8) * (1.0f / 8388608.0f); break;
+                case SAMPLE_PCM32:   v[c] = (float)(int32_t)read_le32(p) * (1.0f / 2147483648.0f); break;
+                case SAMPLE_FLOAT32: memcpy(&v[c], p, 4); break;
+            }
+        }
+        l[i] = v[0];
+        r[i] = (f->channels == 2) ? v[1] : v[0];
+    }
+    for (; i < n; ++i) l[i] = r[i] = 0.0f;
+}
+
+// Scrive n frame da 'start' (solo il canale sinistro per un file mono)
+static void audio_write(AudioFile* f, uint64_t start, uint32_t n, const float* l, const float* r) {
+    uint8_t* p = (uint8_t*)f->data + start * f->bytes_per_frame;
+    for (uint32_t i = 0; i < n; ++i) {
+        memcpy(p, &l[i], 4);
+        p += 4;
+        if (f->channels == 2) {
+            memcpy(p, &r[i], 4);
+            p += 4;
+        }
+    }
+}
+
+
+// --- Elaborazione di un Tratto ---
+
+typedef struct {
+    uint32_t block_size;            // bufsz:maxBlockLength dell'istanza e lunghezza di ogni run()
+    uint64_t chunk_frames;          // 0 = un solo chunk
+    uint64_t warmup_frames;
+    int threads;
+    bool compensate_latency;
+    bool set[GLA3A_NUM_PORTS];      // Porte di controllo impostate dal chiamante...
+    float values[GLA3A_NUM_PORTS];  // ...e i loro valori (le altre restano ai default di MiniHost)
+} RenderOptions;
+
+static void render_options_init(RenderOptions* opts, double samplerate) {
+    memset(opts, 0, sizeof(RenderOptions));
+    opts->block_size = RENDER_DEFAULT_BLOCK;
+    opts->chunk_frames = (uint64_t)(RENDER_DEFAULT_CHUNK_SECONDS * samplerate);
+    opts->warmup_frames = (uint64_t)(RENDER_DEFAULT_WARMUP_SECONDS * samplerate);
+    opts->threads = 1;
+    opts->compensate_latency = true;
+}
+
+// Destinazione dei blocchi d'uscita già allineati: scrittura nel file o confronto con il file
+typedef void (*RenderSink)(void* ctx, uint64_t frame, uint32_t n, const float* l, const float* r);
+
+static bool render_open_host(MiniHost* host, const RenderOptions* opts, double samplerate) {
+    if (!host_open(host, samplerate, opts->block_size)) return false;
+    for (uint32_t p = 0; p < GLA3A_NUM_PORTS; ++p) {
+        if (opts->set[p]) host->controls[p] = opts->values[p];
+    }
+    host_activate(host);
+    return true;
+}
+
+// Latenza con i parametri del render (un blocco di silenzio su un'istanza di prova).
+// Va chiamata prima di avviare i worker: mappa sul thread principale tutti gli URID che le
+// istanze chiedono, così la tabella di MiniHost nei worker viene solo letta.
+static uint32_t render_latency(const RenderOptions* opts, double samplerate) {
+    MiniHost* host = (MiniHost*)calloc(1, sizeof(MiniHost));
+    float* buf = (float*)calloc(opts->block_size * 2, sizeof(float));
+    uint32_t latency = 0;
+    if (host && buf && render_open_host(host, opts, samplerate)) {
+        host_connect_audio(host, buf, buf, buf + opts->block_size, buf + opts->block_size);
+        host_run(host, opts->block_size);
+        latency = opts->compensate_latency ? (uint32_t)host->controls[GLA3A_LATENCY] : 0;
+    }
+    if (host) host_close(host);
+    free(host);
+    free(buf);
+    return latency;
+}
+
+// Uscita [start, end) da un'istanza nuova che parte da start - warmup (o dall'inizio del file).
+// L'uscita del plugin al campione t è l'uscita compensata al campione t - latency.
+static bool render_range(const AudioFile* in, const RenderOptions* opts, uint32_t latency,
+                         uint64_t start, uint64_t end, RenderSink sink, void* ctx) {
+    const uint32_t block = opts->block_size;
+    MiniHost* host = (MiniHost*)calloc(1, sizeof(MiniHost));
+    float* buf = (float*)calloc((size_t)block * 4, sizeof(float));
+    if (!host || !buf || !render_open_host(host, opts, in->samplerate)) {
+        if (host) host_close(host);
+        free(host);
+        free(buf);
+        return false;
+    }
+    float* in_l = buf;
+    float* in_r = buf + block;
+    float* out_l = buf + 2 * block;
+    float* out_r = buf + 3 * block;
+    host_connect_audio(host, in_l, in_r, out_l, out_r);
+
+    // Sulla stessa griglia di blocchi del render in un solo passo
+    const uint64_t from = (start > opts->warmup_frames) ? (start - opts->warmup_frames) / block * block : 0;
+    const uint64_t to = end + latency;
+    for (uint64_t t = from; t < to; t += block) {
+        audio_read(in, t, block, in_l, in_r);
+        host_run(host, block);
+
+        // Parte del blocco che cade in [start, end) dopo la compensazione
+        const uint64_t first = (t >= start + latency) ? t : start + latency;
+        const uint64_t last = (t + block <= to) ? t + block : to;
+        if (first < last) {
+            const uint32_t skip = (uint32_t)(first - t);
+            sink(ctx, first - latency, (uint32_t)(last - first), out_l + skip, out_r + skip);
+        }
+    }
+
+    host_close(host);
+    free(host);
+    free(buf);
+    return true;
+}
+
+
+// --- Pool di Thread sui Chunk ---
+
+typedef struct {
+    const AudioFile* in;
+    AudioFile* out;
+    const RenderOptions* opts;
+    uint32_t latency;
+    uint64_t num_chunks;
+    uint64_t next_chunk;    // Prossimo chunk da assegnare (incremento atomico)
+    int failures;
+} RenderJob;
+
+static void render_sink_write(void* ctx, uint64_t frame, uint32_t n, const float* l, const float* r) {
+    audio_write((AudioFile*)ctx, frame, n, l, r);
+}
+
+static uint64_t render_chunk_length(const RenderOptions* opts, uint64_t frames) {
+    return (opts->chunk_frames && opts->chunk_frames < frames) ? opts->chunk_frames : frames;
+}
+
+static void* render_worker(void* arg) {
+    RenderJob* job = (RenderJob*)arg;
+    const uint64_t length = render_chunk_length(job->opts, job->in->frames);
+    for (;;) {
+        const uint64_t c = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (c >= job->num_chunks) break;
+        const uint64_t start = c * length;
+        const uint64_t end = (start + length < job->in->frames) ? start + length : job->in->frames;
+        if (!render_range(job->in, job->opts, job->latency, start, end, render_sink_write, job->out)) {
+            __atomic_fetch_add(&job->failures, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+// Render completo di 'in' in 'out' (creato con audio_create_output()); false se un chunk fallisce
+static bool render_file(const AudioFile* in, AudioFile* out, const RenderOptions* opts) {
+    if (in->frames == 0) return true;
+    RenderJob job;
+    memset(&job, 0, sizeof(job));
+    job.in = in;
+    job.out = out;
+    job.opts = opts;
+    job.latency = render_latency(opts, in->samplerate);
+    const uint64_t length = render_chunk_length(opts, in->frames);
+    job.num_chunks = (in->frames + length - 1) / length;
+
+    int threads = opts->threads < 1 ? 1 : (opts->threads > RENDER_MAX_THREADS ? RENDER_MAX_THREADS : opts->threads);
+    if ((uint64_t)threads > job.num_chunks) threads = (int)job.num_chunks;
+    pthread_t workers[RENDER_MAX_THREADS];
+    int started = 0;
+    for (; started < threads - 1; ++started) {
+        if (pthread_create(&workers[started], NULL, render_worker, &job) != 0) break;
+    }
+    render_worker(&job); // Il thread principale lavora anche lui
+    for (int i = 0; i < started; ++i) pthread_join(workers[i], NULL);
+    return job.failures == 0;
+}
+
+
+// --- Verifica delle Giunzioni ---
+
+typedef struct {
+    const AudioFile* out;
+    uint64_t chunk_length;      // Le giunzioni sono ai multipli di chunk_length
+    double max_error;           // Scarto massimo (valore assoluto) su tutto il file...
+    uint64_t max_error_frame;   // ...e dove
+    double max_seam_error;      // Scarto massimo nel primo blocco dopo una giunzione
+} RenderVerify;
+
+static void render_sink_compare(void* ctx, uint64_t frame, uint32_t n, const float* l, const float* r) {
+    RenderVerify* v = (RenderVerify*)ctx;
+    float got_l[RENDER_DEFAULT_BLOCK], got_r[RENDER_DEFAULT_BLOCK];
+    for (uint32_t done = 0; done < n; ) {
+        const uint32_t m = (n - done < RENDER_DEFAULT_BLOCK) ? n - done : RENDER_DEFAULT_BLOCK;
+        audio_read(v->out, frame + done, m, got_l, got_r);
+        for (uint32_t i = 0; i < m; ++i) {
+            const uint64_t f = frame + done + i;
+            const double err_l = fabs((double)got_l[i] - l[done + i]);
+            const double err_r = (v->out->channels == 2) ? fabs((double)got_r[i] - r[done + i]) : 0.0;
+            const double err = (err_l > err_r) ? err_l : err_r;
+            if (err > v->max_error) {
+                v->max_error = err;
+                v->max_error_frame = f;
+            }
+            if (f >= v->chunk_length && f % v->chunk_length < RENDER_DEFAULT_BLOCK && err > v->max_seam_error) {
+                v->max_seam_error = err;
+            }
+        }
+        done += m;
+    }
+}
+
+// Rifà il render in un solo passo e lo confronta con l'uscita a chunk già scritta
+static bool render_verify(const AudioFile* in, const AudioFile* out, const RenderOptions* opts, RenderVerify* result) {
+    memset(result, 0, sizeof(RenderVerify));
+    result->out = out;
+    result->chunk_length = render_chunk_length(opts, in->frames);
+    if (in->frames == 0) return true;
+    const uint32_t latency = render_latency(opts, in->samplerate);
+    return render_range(in, opts, latency, 0, in->frames, render_sink_compare, result);
+}
+
+#endif // GLA3A_RENDER_H
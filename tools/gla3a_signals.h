@@ -0,0 +1,94 @@
+#ifndef GLA3A_SIGNALS_H
+#define GLA3A_SIGNALS_H
+
+// --- Segnali Sintetici di Prova ---
+// Segnali stereo deterministici (stesso seed a ogni chiamata), condivisi dal benchmark
+// (tools/gla3a_bench.cpp) e dai test di regressione (tests/golden_regression.cpp).
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef enum {
+    SIGNAL_SINE = 0,
+    SIGNAL_PINK,
+    SIGNAL_DRUMS,
+    SIGNAL_SILENCE,
+    SIGNAL_DECAY,
+    NUM_SIGNALS
+} SignalType;
+
+static inline const char* signal_name(SignalType signal) {
+    static const char* const names[NUM_SIGNALS] = { "sine", "pink", "drums", "silence", "decay" };
+    return names[signal];
+}
+
+#define SIGNALS_NOISE_SEED 22222u
+#define SIGNALS_DECAY_BURST_SECONDS 0.1 // SIGNAL_DECAY: rumore rosa, poi silenzio digitale
+
+static uint32_t signals_noise_state = SIGNALS_NOISE_SEED;
+
+static float white_noise() {
+    signals_noise_state = signals_noise_state * 1664525u + 1013904223u;
+    return (float)(int32_t)signals_noise_state * (1.0f / 2147483648.0f);
+}
+
+// Riempie 'frames' campioni stereo con il segnale richiesto
+static void generate_signal(SignalType signal, double samplerate, float* left, float* right, uint32_t frames) {
+    signals_noise_state = SIGNALS_NOISE_SEED;
+    switch (signal) {
+        case SIGNAL_SINE:
+            for (uint32_t i = 0; i < frames; ++i) {
+                left[i] = 0.5f * (float)sin(2.0 * M_PI * 440.0 * i / samplerate);
+                right[i] = 0.4f * (float)sin(2.0 * M_PI * 554.37 * i / samplerate);
+            }
+            break;
+
+        case SIGNAL_PINK:
+        case SIGNAL_DECAY: {
+            // Filtro di Paul Kellet (versione economica) sul rumore bianco.
+            // In SIGNAL_DECAY il rumore dura SIGNALS_DECAY_BURST_SECONDS, poi gli stati ricorsivi
+            // del plugin decadono su un ingresso nullo (il caso dei denormali).
+            const uint32_t burst = (signal == SIGNAL_DECAY) ? (uint32_t)(samplerate * SIGNALS_DECAY_BURST_SECONDS) : frames;
+            float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+            for (uint32_t i = 0; i < frames; ++i) {
+                if (i >= burst) {
+                    left[i] = right[i] = 0.0f;
+                    continue;
+                }
+                float w = white_noise();
+                b0 = 0.99765f * b0 + w * 0.0990460f;
+                b1 = 0.96300f * b1 + w * 0.2965164f;
+                b2 = 0.57000f * b2 + w * 1.0526913f;
+                float pink = (b0 + b1 + b2 + w * 0.1848f) * 0.15f;
+                left[i] = pink;
+                right[i] = 0.8f * pink + 0.2f * white_noise() * 0.15f;
+            }
+            break;
+        }
+
+        case SIGNAL_DRUMS: {
+            // Cassa (sinusoide a 55 Hz con decadimento) su ogni beat a 120 BPM,
+            // rullante (burst di rumore) in levare: transienti ripidi e lunghe code.
+            const uint32_t beat = (uint32_t)(samplerate * 0.5);
+            for (uint32_t i = 0; i < frames; ++i) {
+                uint32_t t = i % beat;
+                bool snare = (i / beat) % 2 == 1;
+                double secs = t / samplerate;
+                float kick = 0.9f * (float)(sin(2.0 * M_PI * 55.0 * secs) * exp(-secs * 18.0));
+                float hit = snare ? 0.6f * white_noise() * (float)exp(-secs * 30.0) : 0.0f;
+                left[i] = kick + hit;
+                right[i] = kick + 0.8f * hit;
+            }
+            break;
+        }
+
+        case SIGNAL_SILENCE:
+        default:
+            memset(left, 0, sizeof(float) * frames);
+            memset(right, 0, sizeof(float) * frames);
+            break;
+    }
+}
+
+#endif // GLA3A_SIGNALS_H